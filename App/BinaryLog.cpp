@@ -0,0 +1,182 @@
+#include "BinaryLog.hpp"
+
+namespace
+{
+	constexpr char		MAGIC[4]		= { 'F', 'L', 'O', 'G' };
+	constexpr size_t	HEADER_SIZE		= 16u;
+	constexpr size_t	ENTRY_HEAD		= sizeof(uint16) + 1u;
+	constexpr size_t	MESSAGE_HEAD	= 1u + sizeof(uint16) + sizeof(uint32) + sizeof(int32);
+	constexpr size_t	MAX_PAYLOAD		= 0xFFFFu;
+	constexpr uint16	NO_TAG			= 0xFFFFu;	// a tag past the logger's table, its name goes before every message
+
+	template<typename T>
+	T Read(byte const * data)
+	{
+		T value;
+		std::memcpy(&value, data, sizeof(T));
+		return value;
+	}
+}
+
+bool Log::BinaryLogFile::Open(std::string const & path)
+{
+	m_tagsWritten.clear();
+	m_formatsWritten.clear();
+
+	if (!m_file.Create(path, INITIAL_SIZE))
+		return false;
+
+	byte header[HEADER_SIZE] = {};
+	m_created = int64(std::time(nullptr));
+
+	std::memcpy(header, MAGIC, sizeof(MAGIC));
+	std::memcpy(header + 4u, &BINARY_LOG_VERSION, sizeof(uint32));
+	std::memcpy(header + 8u, &m_created, sizeof(int64));
+
+	return m_file.Append(header, HEADER_SIZE);
+}
+
+void Log::BinaryLogFile::Close()
+{
+	m_file.Close();
+}
+
+bool Log::BinaryLogFile::WriteEntry(BinaryEntry kind, void const * head, size_t headSize, void const * body, size_t bodySize)
+{
+	bodySize = std::min(bodySize, MAX_PAYLOAD - headSize);
+
+	uint16 const payload = uint16(headSize + bodySize);
+
+	// assembled first, a failed append never leaves half an entry behind
+	m_entry.resize(ENTRY_HEAD + payload);
+
+	std::memcpy(m_entry.data(), &payload, sizeof(uint16));
+	m_entry[sizeof(uint16)] = byte(kind);
+	std::memcpy(m_entry.data() + ENTRY_HEAD, head, headSize);
+
+	if (bodySize)
+		std::memcpy(m_entry.data() + ENTRY_HEAD + headSize, body, bodySize);
+
+	return m_file.Append(m_entry.data(), m_entry.size());
+}
+
+bool Log::BinaryLogFile::Write(BinaryMessage const & msg, cstring tag, cstring format)
+{
+	if (!IsOpen())
+		return false;
+
+	auto const firstUse = [](std::vector<bool> & written, size_t id)
+	{
+		if (id >= written.size())
+			written.resize(id + 1u, false);
+
+		bool const first = !written[id];
+		written[id] = true;
+
+		return first;
+	};
+
+	if (msg.tagId == NO_TAG || firstUse(m_tagsWritten, msg.tagId))
+	{
+		if (!WriteEntry(BinaryEntry::TAG, &msg.tagId, sizeof(uint16), tag, std::strlen(tag)))
+			return false;
+	}
+
+	if (firstUse(m_formatsWritten, msg.formatId))
+	{
+		if (!WriteEntry(BinaryEntry::FORMAT, &msg.formatId, sizeof(uint32), format, std::strlen(format)))
+			return false;
+	}
+
+	byte			head[MESSAGE_HEAD];
+	int32 const		time = int32(msg.time - m_created);
+
+	head[0] = msg.level;
+	std::memcpy(head + 1u,									&msg.tagId,		sizeof(uint16));
+	std::memcpy(head + 1u + sizeof(uint16),					&msg.formatId,	sizeof(uint32));
+	std::memcpy(head + 1u + sizeof(uint16) + sizeof(uint32),	&time,			sizeof(int32));
+
+	return WriteEntry(BinaryEntry::MESSAGE, head, MESSAGE_HEAD, msg.args, msg.argBytes);
+}
+
+bool Log::BinaryLogReader::Open(std::string const & path)
+{
+	m_tags.clear();
+	m_formats.clear();
+
+	if (!m_file.Open(path) || m_file.GetSize() < HEADER_SIZE)
+		return false;
+
+	byte const * data = m_file.GetData();
+
+	if (std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0 || Read<uint32>(data + 4u) != BINARY_LOG_VERSION)
+	{
+		m_file.Close();
+		return false;
+	}
+
+	m_created	= Read<int64>(data + 8u);
+	m_offset	= HEADER_SIZE;
+
+	return true;
+}
+
+bool Log::BinaryLogReader::Next(DecodedMessage & msg)
+{
+	byte const * const	data = m_file.GetData();
+	size_t const		size = m_file.GetSize();
+
+	while (m_offset + ENTRY_HEAD <= size)
+	{
+		uint16 const		payload	= Read<uint16>(data + m_offset);
+		BinaryEntry const	kind	= BinaryEntry(data[m_offset + sizeof(uint16)]);
+		byte const *		entry	= data + m_offset + ENTRY_HEAD;
+
+		if (kind == BinaryEntry::END || m_offset + ENTRY_HEAD + payload > size)
+			return false;
+
+		m_offset += ENTRY_HEAD + payload;
+
+		switch (kind)
+		{
+			case BinaryEntry::TAG :
+				if (payload >= sizeof(uint16))
+					m_tags[Read<uint16>(entry)].assign(reinterpret_cast<cstring>(entry + sizeof(uint16)), payload - sizeof(uint16));
+				break;
+
+			case BinaryEntry::FORMAT :
+				if (payload >= sizeof(uint32))
+					m_formats[Read<uint32>(entry)].assign(reinterpret_cast<cstring>(entry + sizeof(uint32)), payload - sizeof(uint32));
+				break;
+
+			case BinaryEntry::MESSAGE :
+			{
+				if (payload < MESSAGE_HEAD)
+					return false;
+
+				BinaryMessage & message = msg.message;
+
+				message.level		= entry[0];
+				message.tagId		= Read<uint16>(entry + 1u);
+				message.formatId	= Read<uint32>(entry + 1u + sizeof(uint16));
+				message.time		= m_created + Read<int32>(entry + 1u + sizeof(uint16) + sizeof(uint32));
+				message.args		= entry + MESSAGE_HEAD;
+				message.argBytes	= payload - MESSAGE_HEAD;
+
+				auto const tag		= m_tags.find(message.tagId);
+				auto const format	= m_formats.find(message.formatId);
+
+				msg.tag		= tag	 != m_tags.end()	? tag->second.c_str()	 : "?";
+				msg.format	= format != m_formats.end()	? format->second.c_str() : "";
+
+				return true;
+			}
+
+			// a kind from a later version is skipped
+			default :
+				break;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <Util.h>
+#include <Utils\MappedFile.h>
+
+	namespace Log
+	{
+		// A binary log is a 16 byte header, "FLOG", the version and the time it was made
+		// at, followed by entries: a 16 bit payload size, the entry kind and the payload.
+		// Tags and format strings are written once, the first time a message uses them,
+		// and messages refer to them by id:
+		//
+		//	TAG		uint16 id, the name
+		//	FORMAT	uint32 id, the format string
+		//	MESSAGE	byte level, uint16 tag id, uint32 format id, int32 seconds since the log was made, the LogArgs encoded arguments
+		//
+		// An entry of kind END, zeros past what was written included, ends the log.
+		constexpr uint32 BINARY_LOG_VERSION = 1u;
+
+		enum class BinaryEntry :
+			byte
+		{
+			END,
+			TAG,
+			FORMAT,
+			MESSAGE
+		};
+
+		struct BinaryMessage
+		{
+			byte			level;		// a LogLevel flag
+			uint16			tagId;
+			uint32			formatId;
+			int64			time;		// std::time_t
+			byte const *	args;
+			size_t			argBytes;
+		};
+
+		class BinaryLogFile :
+			public Misc::Noncopyable
+		{
+			Misc::WritableMappedFile	m_file;
+			std::vector<bool>			m_tagsWritten;
+			std::vector<bool>			m_formatsWritten;
+			std::vector<byte>			m_entry;
+			int64						m_created	{0};
+
+			bool WriteEntry(BinaryEntry kind, void const * head, size_t headSize, void const * body, size_t bodySize);
+
+			public:
+
+				static constexpr size_t INITIAL_SIZE = 1u << 20u;
+
+				bool Open(std::string const & path);
+				void Close();
+
+				bool IsOpen() const {
+					return m_file.IsOpen();
+				}
+
+				// tag and format are only read the first time their id is seen
+				bool Write(BinaryMessage const & msg, cstring tag, cstring format);
+		};
+
+		// a message of a binary log with its tag and format looked up
+		struct DecodedMessage
+		{
+			BinaryMessage	message;
+			cstring			tag;
+			cstring			format;
+		};
+
+		class BinaryLogReader :
+			public Misc::Noncopyable
+		{
+			Misc::MappedFile							m_file;
+			size_t										m_offset	{0u};
+			int64										m_created	{0};
+			std::unordered_map<uint16, std::string>		m_tags;
+			std::unordered_map<uint32, std::string>		m_formats;
+
+			public:
+
+				// false when it is not a binary log this version reads
+				bool Open(std::string const & path);
+
+				int64 GetCreationTime() const {
+					return m_created;
+				}
+
+				// false at the end of the log, or at an entry cut short
+				bool Next(DecodedMessage & msg);
+		};
+	}
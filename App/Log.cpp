@@ -1,4 +1,7 @@
 #include "Log.hpp"
+#include "LogQueue.hpp"
+
+constexpr uint32 Log::Logger::TEXT_FORMAT_ID;
 
 Log::LogBuffer::LogBuffer():
 	std::basic_streambuf<char, std::char_traits<char>>()
@@ -8,43 +11,67 @@ Log::LogBuffer::LogBuffer():
 Log::LogBuffer::LogBuffer(OutputBuffer buff):
 	std::basic_streambuf<char, std::char_traits<char>>()
 {
-	if (buff.IsAlive()) {
-		m_outputBuffers.insert({buff.record.name, buff});
-	}
+	AddBuffer(buff);
 }
 
 Log::LogBuffer::LogBuffer(std::initializer_list<OutputBuffer> buffers):
 	std::basic_streambuf<char, std::char_traits<char>>()
 {
-	for (auto buff : buffers)
+	for (auto const & buff : buffers)
+		AddBuffer(buff);
+}
+
+Log::LogBuffer::OutputBuffer * Log::LogBuffer::FindBuffer(std::string const & name)
+{
+	for (auto & buffer : m_outputBuffers)
 	{
-		if (buff.IsAlive()) 
-		{
-			m_outputBuffers.insert({ buff.record.name, buff });
-		}
+		if (buffer.record.name == name)
+			return &buffer;
 	}
+
+	return nullptr;
 }
 
-Log::LogBuffer::int_type Log::LogBuffer::overflow(int_type type)
+bool Log::LogBuffer::HasBuffer(std::string const & name) const
 {
-	int_type const eof = traits::eof();
-	bool streamReachedEOF = false;
+	for (auto const & buffer : m_outputBuffers)
+	{
+		if (buffer.record.name == name)
+			return true;
+	}
 
-	if (traits::eq_int_type(type, eof))
-		return traits::not_eof(type);
+	return false;
+}
 
-	for (auto buffer : m_outputBuffers)
+void Log::LogBuffer::AddBuffer(OutputBuffer const & buff)
+{
+	if (buff.IsAlive() && !HasBuffer(buff.record.name))
+		m_outputBuffers.push_back(buff);
+}
+
+std::streamsize Log::LogBuffer::xsputn(const char * text, std::streamsize count)
+{
+	std::streamsize written = count;
+
+	for (auto & buffer : m_outputBuffers)
 	{
-		if (!buffer.second.isActive) 
+		if (!buffer.isActive)
 			continue;
 
-		int_type result = buffer.second.streamPtr->sputc(type);
-
-		if (result == eof)
-			streamReachedEOF = true;
+		written = std::min(written, buffer.streamPtr->sputn(text, count));
 	}
 
-	return streamReachedEOF ? eof : type;
+	return written;
+}
+
+Log::LogBuffer::int_type Log::LogBuffer::overflow(int_type type)
+{
+	if (traits::eq_int_type(type, traits::eof()))
+		return traits::not_eof(type);
+
+	char const character = traits::to_char_type(type);
+
+	return xsputn(&character, 1) == 1 ? type : traits::eof();
 }
 
 Log::LogBuffer::int_type Log::LogBuffer::sync()
@@ -54,71 +81,83 @@ Log::LogBuffer::int_type Log::LogBuffer::sync()
 
 	int_type syncStatus = SYNC_OK;
 
-	for (auto buffer : m_outputBuffers)
+	for (auto & buffer : m_outputBuffers)
 	{
-		if (!buffer.second.isActive)
+		if (!buffer.isActive)
 			continue;
 
-		int_type res = buffer.second.streamPtr->pubsync();
+		int_type res = buffer.streamPtr->pubsync();
 		
-		if (!res) 
+		if (res == -1) 
 			syncStatus = SYNC_ERR;
 	}
 
 	return syncStatus;
 }
 
-void Log::Logger::FilterBuffers(Message msg)
+bool Log::Logger::Passes(LogFilter const & filter, Message const & msg) const
 {
 	switch (m_filterUsage)
 	{
-		case FilterState::LOCAL	:
-		{
-			for (auto & subBuffer : m_buffer.m_outputBuffers)
-			{
-				subBuffer.second.isActive = 
-					subBuffer.second.record.filter.MatchesMessage(msg);
-			}
-			return;
-		}
+		case FilterState::LOCAL :
+			return filter.MatchesMessage(msg);
 
 		case FilterState::ATTACH :
-		{
-			for (auto & subBuffer : m_buffer.m_outputBuffers)
-			{
-				subBuffer.second.isActive =
-					subBuffer.second.record.filter.MatchesMessage(msg) &&
-					m_globalFilter.MatchesMessage(msg);
-			}
-			return;
-		}
+			return filter.MatchesMessage(msg) && m_globalFilter.MatchesMessage(msg);
 
 		case FilterState::OVERWRITE :
-		{
-			for (auto & subBuffer : m_buffer.m_outputBuffers)
-			{
-				subBuffer.second.isActive = m_globalFilter.MatchesMessage(msg);
-			}
-			return;
-		}
+			return m_globalFilter.MatchesMessage(msg);
 
 		case FilterState::NONE :
 		default :
-		{
-			for (auto & subBuffer : m_buffer.m_outputBuffers)
-			{
-				subBuffer.second.isActive = true;
-			}
-			return;
-		}
+			return true;
+	}
+}
+
+Log::LogLevel Log::Logger::AcceptedLevels(LogFilter const & filter, uint16 tagId) const
+{
+	switch (m_filterUsage)
+	{
+		case FilterState::LOCAL :
+			return filter.AcceptedLevels(tagId);
+
+		case FilterState::ATTACH :
+			return filter.AcceptedLevels(tagId) & m_globalFilter.AcceptedLevels(tagId);
+
+		case FilterState::OVERWRITE :
+			return m_globalFilter.AcceptedLevels(tagId);
+
+		case FilterState::NONE :
+		default :
+			return LogLevel::ALL;
+	}
+}
+
+Log::LogRecord * Log::Logger::FindRecord(std::string const & name)
+{
+	if (LogBuffer::OutputBuffer * buffer = m_buffer.FindBuffer(name))
+		return &buffer->record;
+
+	for (auto & binaryLog : m_binaryLogs)
+	{
+		if (binaryLog.record.name == name)
+			return &binaryLog.record;
 	}
+
+	return nullptr;
+}
+
+void Log::Logger::FilterBuffers(Message const & msg)
+{
+	for (auto & subBuffer : m_buffer.m_outputBuffers)
+		subBuffer.isActive = Passes(subBuffer.record.filter, msg);
 }
 
 void Log::Logger::FlushAll()
 {
-	for (auto buff : m_buffer.m_outputBuffers)
-		if(buff.second.isActive)
-			buff.second.streamPtr->pubsync();
+	// all of them, a batch of messages may have gone to sinks the last one did not
+	for (auto & buff : m_buffer.m_outputBuffers)
+		buff.streamPtr->pubsync();
 }
 
 Log::Logger::Logger():
@@ -128,6 +167,8 @@ Log::Logger::Logger():
 
 	if(!filesystem::exists(m_logFolder))
 		filesystem::create_directory(m_logFolder);
+
+	RefreshFilters();
 }
 
 Log::Logger::Logger(std::initializer_list<stream*> streams, std::string const & logFilePath):
@@ -156,8 +197,10 @@ Log::Logger::Logger(std::initializer_list<stream*> streams, std::string const &
 		currentBuffer.streamPtr = outStream->rdbuf();
 		currentBuffer.record	= buffRecord;
 
-		m_buffer.m_outputBuffers.insert({buffRecord.name, currentBuffer});
+		m_buffer.AddBuffer(currentBuffer);
 	}
+
+	RefreshFilters();
 }
 
 Log::Logger::Logger(std::initializer_list<LogStream> streams, std::string const & logFilePath) :
@@ -169,8 +212,6 @@ Log::Logger::Logger(std::initializer_list<LogStream> streams, std::string const
 	if (!filesystem::exists(m_logFolder))
 		filesystem::create_directory(m_logFolder);
 
-	auto & buffers = m_buffer.m_outputBuffers;
-
 	for (auto & outStream : streams)
 	{
 		LogBuffer::OutputBuffer currentBuffer{ 0 };
@@ -180,11 +221,13 @@ Log::Logger::Logger(std::initializer_list<LogStream> streams, std::string const
 		if (!currentBuffer.IsAlive())
 			continue;
 
-		if (buffers.find(outStream.second.name) != buffers.end())
+		if (m_buffer.HasBuffer(outStream.second.name))
 			currentBuffer.record.name = m_sDefaultBufferName + std::to_string(m_buffer.m_bufferCounter++);
 
-		m_buffer.m_outputBuffers.insert({ currentBuffer.record.name, currentBuffer });
+		m_buffer.AddBuffer(currentBuffer);
 	}
+
+	RefreshFilters();
 }
 
 void Log::Logger::AddStream(stream * strm, std::string const & name, bool isFile, bool isTemp)
@@ -199,14 +242,16 @@ void Log::Logger::AddStream(stream * strm, std::string const & name, bool isFile
 	record.isTemp	= isTemp;
 	record.filter	= filter;
 
-	record.name		= m_buffer.m_outputBuffers.find(name) == m_buffer.m_outputBuffers.end() ?
+	record.name		= !m_buffer.HasBuffer(name) ?
 					  name : m_sDefaultBufferName + std::to_string(m_buffer.m_bufferCounter++);
 
 	LogBuffer::OutputBuffer outBuff;
 	outBuff.streamPtr	= strm->rdbuf();
 	outBuff.record		= record;
 
-	m_buffer.m_outputBuffers.insert({ record.name, outBuff });
+	m_buffer.AddBuffer(outBuff);
+
+	RefreshFilters();
 }
 
 void Log::Logger::AddStream(stream * strm, std::string const & name, LogFilter filter, bool isFile, bool isTemp)
@@ -216,7 +261,7 @@ void Log::Logger::AddStream(stream * strm, std::string const & name, LogFilter f
 	record.isFile = isFile;
 	record.isTemp = isTemp;
 	record.filter = filter;
-	record.name = m_buffer.m_outputBuffers.find(name) == m_buffer.m_outputBuffers.end() ?
+	record.name = !m_buffer.HasBuffer(name) ?
 					name : m_sDefaultBufferName + std::to_string(m_buffer.m_bufferCounter++);
 
 	LogBuffer::OutputBuffer outBuff;
@@ -224,26 +269,52 @@ void Log::Logger::AddStream(stream * strm, std::string const & name, LogFilter f
 	outBuff.streamPtr = strm->rdbuf();
 	outBuff.record = record;
 
-	m_buffer.m_outputBuffers.insert({ record.name, outBuff });
+	m_buffer.AddBuffer(outBuff);
+
+	RefreshFilters();
 }
 
 void Log::Logger::AddStream(stream * strm, LogRecord record)
 {
 	LogBuffer::OutputBuffer outBuff;
 
-	if (m_buffer.m_outputBuffers.find(record.name) != m_buffer.m_outputBuffers.end())
+	if (m_buffer.HasBuffer(record.name))
 		record.name = m_sDefaultBufferName + std::to_string(m_buffer.m_bufferCounter++);
 
 	outBuff.streamPtr	= strm->rdbuf();
 	outBuff.record		= record;
 
-	m_buffer.m_outputBuffers.insert({ record.name, outBuff });
+	m_buffer.AddBuffer(outBuff);
+
+	RefreshFilters();
 }
 
-bool Log::Logger::CreateLogFile(std::string name, LogFilter filter, bool isPathAbsolute)
+bool Log::Logger::CreateLogFile(std::string name, LogFilter filter, bool isPathAbsolute, LogFormat format)
 {
 	std::string filename = isPathAbsolute ? name : m_logFolder + '/' + name;
 
+	if (format == LogFormat::BINARY)
+	{
+		if (FindRecord(filename))
+			return false;
+
+		BinarySink binaryLog{ std::unique_ptr<BinaryLogFile>(new BinaryLogFile()), LogRecord{0} };
+
+		if (!binaryLog.file->Open(filename))
+			return false;
+
+		binaryLog.record.isFile	= true;
+		binaryLog.record.isTemp	= false;
+		binaryLog.record.name	= filename;
+		binaryLog.record.filter	= filter;
+
+		m_binaryLogs.push_back(std::move(binaryLog));
+
+		RefreshFilters();
+
+		return true;
+	}
+
 	if (m_logFiles.find(name) == m_logFiles.end()) 
 	{
 		try
@@ -307,7 +378,9 @@ void Log::Logger::AddStream(stream * strm, bool isFile)
 	outBuff.streamPtr	= strm->rdbuf();
 	outBuff.record		= record;
 	
-	m_buffer.m_outputBuffers.insert({record.name, outBuff});
+	m_buffer.AddBuffer(outBuff);
+
+	RefreshFilters();
 }
 
 void Log::Logger::AddStream(stream * strm, LogFilter filter, bool isFile)
@@ -323,24 +396,28 @@ void Log::Logger::AddStream(stream * strm, LogFilter filter, bool isFile)
 	outBuff.streamPtr = strm->rdbuf();
 	outBuff.record = record;
 
-	m_buffer.m_outputBuffers.insert({ record.name, outBuff });
+	m_buffer.AddBuffer(outBuff);
+
+	RefreshFilters();
 }
 
-bool Log::LogFilter::MatchesMessage(Message msg)
+bool Log::LogFilter::MatchesMessage(Message const & msg) const
 {
 	bool checkTag	{false};
 	bool checkLevel {false};
 
-	if (filterTags)
+	if (!filterTags)
+		checkTag = true;
+	else if (msg.tagId != NO_TAG_ID)
+		checkTag = std::find(tagIds.begin(), tagIds.end(), msg.tagId) != tagIds.end();
+	else
 	{
-		for (auto tag : tags)
+		for (auto const & tag : tags)
 		{
 			if (tag == msg.tag)
 				checkTag = true;
 		}
 	}
-	else
-		checkTag = true;
 
 	checkLevel = 
 		filterLevel ? 
@@ -350,102 +427,133 @@ bool Log::LogFilter::MatchesMessage(Message msg)
 	return checkTag && checkLevel;
 }
 
+Log::LogLevel Log::LogFilter::AcceptedLevels(uint16 tagId) const
+{
+	if (filterTags && std::find(tagIds.begin(), tagIds.end(), tagId) == tagIds.end())
+		return LogLevel(0);
+
+	return filterLevel ? level : LogLevel::ALL;
+}
+
 void Log::Logger::ClearAllManaged()
 {
-	for (auto buff = m_buffer.m_outputBuffers.begin();
-		buff != m_buffer.m_outputBuffers.end();
-		++buff) 
-	{
-		if (buff->second.isManaged)
-		{
-			m_buffer.m_outputBuffers.erase(buff);
-		}
-	}
+	m_buffer.RemoveBuffers([](LogBuffer::OutputBuffer const & buff) { return buff.isManaged; });
+
+	RefreshFilters();
 }
 
 void Log::Logger::DeleteLogFiles(bool removeFileHandles)
 {
 	if (removeFileHandles)
 	{
-		for (auto buff = m_buffer.m_outputBuffers.begin();
-			buff != m_buffer.m_outputBuffers.end(); ++buff)
-		{
-			if(buff->second.record.isFile)
-				m_buffer.m_outputBuffers.erase(buff);
-		}
+		m_buffer.RemoveBuffers([](LogBuffer::OutputBuffer const & buff) { return buff.record.isFile; });
+		m_binaryLogs.clear();
 	}
 
 	std::remove(m_logFolder.c_str());
+
+	RefreshFilters();
 }
 
 void Log::Logger::RemoveAllDead()
 {
-	for (auto buff = m_buffer.m_outputBuffers.begin();
-			buff != m_buffer.m_outputBuffers.end();
-			++ buff)
-	{
-		if(!buff->second.IsAlive())
-			m_buffer.m_outputBuffers.erase(buff);
-	}
+	m_buffer.RemoveBuffers([](LogBuffer::OutputBuffer const & buff) { return !buff.IsAlive(); });
+
+	RefreshFilters();
 }
 
 void Log::Logger::RemoveTemp()
 {
-	for (auto buff = m_buffer.m_outputBuffers.begin();
-		buff != m_buffer.m_outputBuffers.end();
-		++buff)
-	{
-		if (buff->second.record.isTemp)
-			m_buffer.m_outputBuffers.erase(buff);
-	}
+	m_buffer.RemoveBuffers([](LogBuffer::OutputBuffer const & buff) { return buff.record.isTemp; });
+
+	RefreshFilters();
 }
 
 void Log::Logger::RemoveStream(const char * streamName)
 {
-	std::map<std::string, LogBuffer::OutputBuffer>::iterator toRemove;
+	std::string const name = streamName;
+
+	m_binaryLogs.erase(std::remove_if(m_binaryLogs.begin(), m_binaryLogs.end(),
+									  [&](BinarySink const & binaryLog) { return binaryLog.record.name == name; }), m_binaryLogs.end());
+
+	LogBuffer::OutputBuffer * toRemove = m_buffer.FindBuffer(streamName);
+
+	if (!toRemove)
+	{
+		RefreshFilters();
+		return;
+	}
 
-	if ((toRemove = m_buffer.m_outputBuffers.find(streamName))
-		!= m_buffer.m_outputBuffers.end())
+	if (toRemove->record.isFile)
 	{
-		if (toRemove->second.record.isFile)
+		std::map<std::string, std::ofstream>::iterator logFile;
+		if ((logFile = m_logFiles.find(streamName)) != m_logFiles.end())
 		{
-			std::map<std::string, std::ofstream>::iterator logFile;
-			if ((logFile = m_logFiles.find(streamName)) != m_logFiles.end())
-			{
-				m_logFiles.erase(logFile);
-			}
+			m_logFiles.erase(logFile);
 		}
-
-		m_buffer.m_outputBuffers.erase(streamName);
 	}
+
+	m_buffer.RemoveBuffers([&](LogBuffer::OutputBuffer const & buff) { return buff.record.name == name; });
+
+	RefreshFilters();
 }
 
 void Log::Logger::RemoveAllStreams()
 {
 	m_buffer.m_outputBuffers.clear();
+	m_binaryLogs.clear();
+
+	RefreshFilters();
 }
 
-void Log::Logger::PrintMessage(Message msg)
+void Log::Logger::PrintMessage(Message const & msg, bool flush)
 {
 	FilterBuffers(msg);
+	WriteText(msg);
 
-	std::string log = "";
-	
-	if (bool(m_printFlags & PrintFlags::USE_TIMESTAMP))
+	if (!m_binaryLogs.empty())
 	{
-		std::stringstream formatter;
+		std::tm timestamp = msg.timestamp;
+
+		// already text, it goes in as the one argument of "%s"
+		BinaryMessage binary;
+		binary.level	= byte(msg.level);
+		binary.tagId	= msg.tagId;
+		binary.formatId	= TEXT_FORMAT_ID;
+		binary.time		= int64(std::mktime(&timestamp));
+		binary.args		= m_args;
+		binary.argBytes	= EncodeArgs(m_args, LOG_SIZE, msg.text.c_str());
+
+		WriteBinary(msg, binary, "%s");
+	}
 
-		std::time_t	currentTime = std::time(nullptr);
-		std::tm timestamp;
-		localtime_s(&timestamp, &currentTime);
+	if (flush)
+		FlushAll();
+}
 
-		formatter << std::put_time(&timestamp, "%c") << char(0x20);
+void Log::Logger::WriteText(Message const & msg)
+{
+	// reused, so a message costs no allocation once the longest one has been seen
+	std::string & log = m_line;
+	log.clear();
+	
+	if (bool(m_printFlags & PrintFlags::USE_TIMESTAMP))
+	{
+		// the time it was logged at, the queue may write it a little later
+		char timestamp[64];
+		size_t const length = std::strftime(timestamp, sizeof(timestamp), "%c", &msg.timestamp);
 
-		log += formatter.str();
+		log.append(timestamp, length);
+		log += char(0x20);
 	}
 
 	if (bool(m_printFlags & PrintFlags::USE_TAG))
-		log += "[" + msg.tag + "]" + char(0x20);
+	{
+		log += '[';
+		log += msg.tag;
+		log += ']';
+		log += char(0x20);
+	}
 
 	if (bool(m_printFlags & PrintFlags::USE_LEVEL))
 	{
@@ -486,24 +594,74 @@ void Log::Logger::PrintMessage(Message msg)
 			break;
 		}
 
-		log += std::string(SPACING, char(0x20));
+		log.append(SPACING, char(0x20));
 	}
 
 	log += msg.text;
 	log += '\n';
 
+	// one sputn per sink for the whole line
 	write(log.c_str(), log.size());
-	FlushAll();
+}
+
+void Log::Logger::WriteBinary(Message const & msg, BinaryMessage const & binary, cstring format)
+{
+	for (auto & binaryLog : m_binaryLogs)
+	{
+		if (Passes(binaryLog.record.filter, msg))
+			binaryLog.file->Write(binary, msg.tag.c_str(), format);
+	}
+}
+
+void Log::Logger::WriteRecord(QueuedRecord const & record, Message & message)
+{
+	message.level	= record.level;
+	message.tagId	= record.tagId;
+	message.tag		= record.tag;
+
+	cstring const format = GetFormat(record.formatId).c_str();
+
+	FilterBuffers(message);
+
+	bool const printed = std::any_of(m_buffer.m_outputBuffers.begin(), m_buffer.m_outputBuffers.end(),
+									 [](LogBuffer::OutputBuffer const & buff) { return buff.isActive; });
+
+	// nothing is formatted for a message only binary logs take
+	if (printed)
+	{
+		message.text.clear();
+		FormatArgs(message.text, format, record.arguments, record.argBytes);
+		localtime_s(&message.timestamp, &record.time);
+
+		WriteText(message);
+	}
+
+	if (!m_binaryLogs.empty())
+	{
+		BinaryMessage binary;
+		binary.level	= byte(record.level);
+		binary.tagId	= record.tagId;
+		binary.formatId	= record.formatId;
+		binary.time		= int64(record.time);
+		binary.args		= record.arguments;
+		binary.argBytes	= record.argBytes;
+
+		WriteBinary(message, binary, format);
+	}
 }
 
 void Log::Logger::SetFilterState(FilterState state)
 {
 	m_filterUsage = state;
+
+	RefreshFilters();
 }
 
 void Log::Logger::ConfigureFilter(LogFilter filter)
 {
 	m_globalFilter = filter;
+
+	RefreshFilters();
 }
 
 void Log::Logger::SetLogFilePath(std::string newPath, bool removeOld)
@@ -531,70 +689,70 @@ void Log::Logger::AddFilterTag(const char * tag)
 
 	if(!exists)
 		m_globalFilter.tags.push_back(tag);
+
+	RefreshFilters();
 }
 
 void Log::Logger::AddFilterLevel(LogLevel level)
 {
 	m_globalFilter.level |= level;
+
+	RefreshFilters();
 }
 
 void Log::Logger::RemoveFilter(const char * tag)
 {
-	std::remove_if(m_globalFilter.tags.begin(), m_globalFilter.tags.end(), 
-		[=](std::string tg) -> bool
-		{
-			return tg == tag;
-		});
+	auto & tags = m_globalFilter.tags;
+	tags.erase(std::remove(tags.begin(), tags.end(), std::string(tag)), tags.end());
+
+	RefreshFilters();
 }
 
 void Log::Logger::RemoveFilter(LogLevel level)
 {
 	m_globalFilter.level &= ~level;
+
+	RefreshFilters();
 }
 
 void Log::Logger::ModifyStreamFilter(const char * streamName, LogFilter filter)
 {
-	std::map<std::string, LogBuffer::OutputBuffer>::iterator buffToModify;
+	if (LogRecord * toModify = FindRecord(streamName))
+		toModify->filter = filter;
 
-	if ((buffToModify = m_buffer.m_outputBuffers.find(streamName)) 
-			!= m_buffer.m_outputBuffers.end())
-	{
-		buffToModify->second.record.filter = filter;
-	}
-	
+	RefreshFilters();
 }
 
 void Log::Logger::ModifyStreamFilter(const char * streamName, const char * tag, bool remove)
 {
-	std::map<std::string, LogBuffer::OutputBuffer>::iterator buffToModify;
+	LogRecord * toModify = FindRecord(streamName);
 
-	if ((buffToModify = m_buffer.m_outputBuffers.find(streamName))
-		!= m_buffer.m_outputBuffers.end())
-	{
-		if (remove)
-			std::remove_if(buffToModify->second.record.filter.tags.begin(),
-						   buffToModify->second.record.filter.tags.end(),
-							[=](std::string tg) -> bool
-							{
-								return tg == tag;
-							});
-		else
-			buffToModify->second.record.filter.tags.push_back(tag);
-	}
+	if (!toModify)
+		return;
+
+	std::vector<std::string> & tags = toModify->filter.tags;
+
+	if (remove)
+		tags.erase(std::remove(tags.begin(), tags.end(), std::string(tag)), tags.end());
+	else
+		tags.push_back(tag);
+
+	RefreshFilters();
 }
 
 void Log::Logger::ModifyStreamFilter(const char * streamName, LogLevel level, bool remove)
 {
-	std::map<std::string, LogBuffer::OutputBuffer>::iterator buffToModify;
+	LogRecord * toModify = FindRecord(streamName);
 
-	if ((buffToModify = m_buffer.m_outputBuffers.find(streamName))
-		!= m_buffer.m_outputBuffers.end())
-	{
-		if (remove)
-			buffToModify->second.record.filter.level &= ~level;
-		else
-			buffToModify->second.record.filter.level |= level;
-	}
+	if (!toModify)
+		return;
+
+	if (remove)
+		toModify->filter.level &= ~level;
+	else
+		toModify->filter.level |= level;
+
+	RefreshFilters();
 }
 
 Log::LogFilter Log::Logger::GetFilter() const
@@ -606,3 +764,90 @@ std::string Log::Logger::GetLogFilePath() const
 {
 	return m_logFolder;
 }
+
+uint16 Log::Logger::InternTag(const char * tag)
+{
+	std::lock_guard<std::mutex> guard{ m_tagLock };
+
+	return InternTagLocked(tag);
+}
+
+uint16 Log::Logger::InternTagLocked(std::string const & tag)
+{
+	auto const found = m_tagIds.find(tag);
+
+	if (found != m_tagIds.end())
+		return found->second;
+
+	if (m_tagIds.size() >= MAX_TAGS)
+		return NO_TAG_ID;
+
+	uint16 const tagId = uint16(m_tagIds.size());
+
+	m_tagIds.insert({ tag, tagId });
+	m_tagLevels[tagId].store(byte(ComputeTagLevels(tagId)), std::memory_order_relaxed);
+
+	return tagId;
+}
+
+Log::LogLevel Log::Logger::ComputeTagLevels(uint16 tagId) const
+{
+	LogLevel levels = LogLevel(0);
+
+	for (auto const & buff : m_buffer.m_outputBuffers)
+		levels |= AcceptedLevels(buff.record.filter, tagId);
+
+	for (auto const & binaryLog : m_binaryLogs)
+		levels |= AcceptedLevels(binaryLog.record.filter, tagId);
+
+	return levels;
+}
+
+void Log::Logger::RefreshFilters()
+{
+	std::lock_guard<std::mutex> guard{ m_tagLock };
+
+	auto const resolve = [this](LogFilter & filter)
+	{
+		filter.tagIds.clear();
+
+		for (auto const & tag : filter.tags)
+			filter.tagIds.push_back(InternTagLocked(tag));
+	};
+
+	resolve(m_globalFilter);
+
+	for (auto & buff : m_buffer.m_outputBuffers)
+		resolve(buff.record.filter);
+
+	for (auto & binaryLog : m_binaryLogs)
+		resolve(binaryLog.record.filter);
+
+	for (auto const & tag : m_tagIds)
+		m_tagLevels[tag.second].store(byte(ComputeTagLevels(tag.second)), std::memory_order_relaxed);
+}
+
+uint32 Log::Logger::InternFormat(const char * fmt)
+{
+	std::lock_guard<std::mutex> guard{ m_formatLock };
+
+	auto const found = m_formatIds.find(fmt);
+
+	if (found != m_formatIds.end())
+		return found->second;
+
+	uint32 const formatId = uint32(m_formats.size());
+
+	// the deque never moves what it holds, GetFormat's references stay valid
+	m_formats.emplace_back(fmt);
+	m_formatIds.insert({ m_formats.back(), formatId });
+
+	return formatId;
+}
+
+std::string const & Log::Logger::GetFormat(uint32 formatId)
+{
+	std::lock_guard<std::mutex> guard{ m_formatLock };
+
+	return formatId < m_formats.size() ? m_formats[formatId] : m_formats[TEXT_FORMAT_ID];
+}
@@ -2,15 +2,22 @@
 
 #include <type_traits>
 #include <map>
+#include <deque>
 #include <filesystem>
 
 #include <Util.h>
 #include "Console.hpp"
+#include "LogArgs.hpp"
+#include "BinaryLog.hpp"
 
 	namespace Log
 	{
 		constexpr auto LOG_SIZE = 1024u;
 
+		// tags are interned by the logger they go through, past MAX_TAGS they are only matched by name
+		constexpr uint32 MAX_TAGS	= 256u;
+		constexpr uint16 NO_TAG_ID	= 0xFFFFu;
+
 		enum class LogLevel : 
 			byte
 		{
@@ -23,6 +30,13 @@
 			ALL			= LDEBUG | LINFO | LWARNING | LERROR | LFATAL | LVERBOSE
 		};
 
+		enum class LogFormat :
+			byte
+		{
+			TEXT,	// the lines as they are printed
+			BINARY	// format ids and encoded arguments, read back with the LogDecoder tool
+		};
+
 		enum class FilterState : 
 			byte
 		{
@@ -35,6 +49,7 @@
 		struct LogFilter;
 		struct LogRecord;
 		struct Message;
+		struct QueuedRecord;
 
 		struct LogFilter
 		{
@@ -42,8 +57,12 @@
 			bool filterLevel;
 			LogLevel					level;
 			std::vector<std::string>	tags;
+			std::vector<uint16>			tagIds;		// of tags, filled in by the logger the filter is set on
 
-			bool MatchesMessage(Message msg);
+			bool MatchesMessage(Message const & msg) const;
+
+			// the levels the filter lets through for a tag
+			LogLevel AcceptedLevels(uint16 tagId) const;
 		};
 
 		enum class PrintFlags :
@@ -71,6 +90,7 @@
 			std::tm			timestamp;
 			std::string		tag;
 			std::string		text;
+			uint16			tagId		{NO_TAG_ID};	// NO_TAG_ID when the tag is only known by name
 		};
 
 		class Logger;
@@ -113,30 +133,32 @@
 				
 				struct OutputBuffer
 				{
-					inline void SetBuffer() {
-
-						if (IsAlive()) {
-							streamPtr->pubsetbuf(charBuffer, LOG_SIZE);
-						}
-					}
-					
-					char charBuffer[LOG_SIZE];
-
 					BaseBuff*  streamPtr; 
 					LogRecord  record;
 
 					bool isActive	{true};
 					bool isManaged	{false};
 
-					bool inline IsAlive() {
+					bool inline IsAlive() const {
 						return streamPtr != nullptr;
 					}
 				};
 
 				typedef typename std::char_traits<char>::int_type int_type;
 			
-				std::map<std::string, OutputBuffer> m_outputBuffers;
-				uint16							    m_bufferCounter	{0u};
+				// in the order they were added, names are only looked up when the configuration changes
+				std::vector<OutputBuffer>	m_outputBuffers;
+				uint16						m_bufferCounter	{0u};
+
+				OutputBuffer *	FindBuffer(std::string const & name);
+				bool			HasBuffer(std::string const & name) const;
+
+				// dead buffers are left out
+				void			AddBuffer(OutputBuffer const & buff);
+
+				// removes the buffers the predicate is true for
+				template<typename Predicate>
+				void			RemoveBuffers(Predicate predicate);
 
 			public:
 
@@ -144,16 +166,36 @@
 				explicit LogBuffer(OutputBuffer buff);
 				LogBuffer(std::initializer_list<OutputBuffer> buffers);
 
+				// a whole message goes to every active sink with one sputn
+				std::streamsize xsputn(const char * text, std::streamsize count) override;
+
 				int_type overflow(int_type type) override;
 				int_type sync()					 override;
 
 		};
 
+		template<typename Predicate>
+		inline void LogBuffer::RemoveBuffers(Predicate predicate)
+		{
+			m_outputBuffers.erase(std::remove_if(m_outputBuffers.begin(), m_outputBuffers.end(), predicate), m_outputBuffers.end());
+		}
+
+		class LogQueue;
+
 		class Logger :
 			public std::basic_ostream<char, std::char_traits<char>>
 		{
 			protected:
 
+				// writes a batch of messages before flushing the sinks once
+				friend class LogQueue;
+
+				struct BinarySink
+				{
+					std::unique_ptr<BinaryLogFile>	file;
+					LogRecord						record;
+				};
+
 				constexpr static const char* STR_DBG = "<DEBUG>:";
 				constexpr static const char* STR_WRN = "<WARNING>:";
 				constexpr static const char* STR_ERR = "<ERROR>:";
@@ -182,10 +224,43 @@
 				LogBuffer								m_buffer;
 				std::string								m_logFolder{ "./logs" };
 				std::map<std::string, std::ofstream>	m_logFiles;
+				std::string								m_line;			// the message being written, kept for its capacity
+				std::vector<BinarySink>					m_binaryLogs;
+				byte									m_args[LOG_SIZE];	// a printed message encoded for the binary sinks
+
+				std::mutex								m_tagLock;
+				hash_map<uint16>						m_tagIds;
+				std::array<std::atomic<byte>, MAX_TAGS>	m_tagLevels;	// what some sink would take of every interned tag
+
+				// the first one prints text that is already formatted
+				std::mutex								m_formatLock;
+				hash_map<uint32>						m_formatIds	{ { "%s", TEXT_FORMAT_ID } };
+				std::deque<std::string>					m_formats	{ "%s" };
 
-				void FilterBuffers(Message msg);
+				static constexpr uint32 TEXT_FORMAT_ID = 0u;
+
+				bool		Passes(LogFilter const & filter, Message const & msg) const;
+				LogLevel	AcceptedLevels(LogFilter const & filter, uint16 tagId) const;
+
+				// of a stream or a binary log file
+				LogRecord *	FindRecord(std::string const & name);
+
+				void FilterBuffers(Message const & msg);
 				void FlushAll();
 
+				// to the text sinks FilterBuffers left active
+				void WriteText(Message const & msg);
+				void WriteBinary(Message const & msg, BinaryMessage const & binary, cstring format);
+
+				// formatted only when a text sink takes it, binary sinks store it as it was queued
+				void WriteRecord(QueuedRecord const & record, Message & message);
+
+				uint16		InternTagLocked(std::string const & tag);
+				LogLevel	ComputeTagLevels(uint16 tagId) const;
+
+				// interns the tags of every filter and recomputes m_tagLevels, after any change to the sinks or filters
+				void RefreshFilters();
+
 			public:
 
 				Logger();
@@ -198,7 +273,7 @@
 				void AddStream(stream* strm, std::string const & name, LogFilter filter, bool isFile = false, bool isTemp = false);
 				void AddStream(stream* strm, LogRecord record);
 
-				bool CreateLogFile(std::string name, LogFilter filter, bool isPathAbsolute = false);
+				bool CreateLogFile(std::string name, LogFilter filter, bool isPathAbsolute = false, LogFormat format = LogFormat::TEXT);
 				
 				void ClearAllManaged();
 				void DeleteLogFiles(bool removeFileHandles = true);
@@ -211,7 +286,8 @@
 				template<typename ...args>
 				static Message CreateMessage(LogLevel level, const char* tag, const char* fmt, args... vargs);
 
-				void PrintMessage(Message msg);
+				// flush false leaves the text in the sinks' own buffers
+				void PrintMessage(Message const & msg, bool flush = true);
 
 				template<typename ...args>
 				void PrintM(LogLevel level, const char* tag, const char* fmt, args... vargs);
@@ -241,6 +317,19 @@
 
 				LogFilter	GetFilter()			const;
 				std::string GetLogFilePath()	const;
+
+				// the same id for the same name for the lifetime of the logger, NO_TAG_ID once MAX_TAGS are taken
+				uint16		InternTag(const char * tag);
+
+				// the same id for the same format string, for as long as the logger lives
+				uint32				InternFormat(const char * fmt);
+				std::string const &	GetFormat(uint32 formatId);
+
+				// false when no sink would take the message, it need not even be formatted
+				bool inline Accepts(uint16 tagId, LogLevel level) const
+				{
+					return tagId >= MAX_TAGS || bool(static_cast<LogLevel>(m_tagLevels[tagId].load(std::memory_order_relaxed)) & level);
+				}
 		};
 
 		template<typename ...args>
@@ -250,6 +339,9 @@
 			msg.level	= level;
 			msg.tag		= tag;
 
+			std::time_t const currentTime = std::time(nullptr);
+			localtime_s(&msg.timestamp, &currentTime);
+
 			char buffer[LOG_SIZE] = "";
 			sprintf_s(buffer, LOG_SIZE, fmt, vargs...);
 
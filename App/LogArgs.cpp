@@ -0,0 +1,320 @@
+#include "LogArgs.hpp"
+
+namespace
+{
+	constexpr size_t HEADER_SIZE	= 1u + sizeof(uint16);	// a string's kind and length
+
+	// one printf conversion, rebuilt for the kind of argument it is given
+	struct Conversion
+	{
+		std::string	flags;
+		std::string	width;
+		std::string	precision;		// with its dot
+		char		specifier	{'\0'};
+	};
+
+	template<typename T>
+	void AppendFormatted(std::string & out, std::string const & spec, T value)
+	{
+		char buffer[256];
+		int const length = std::snprintf(buffer, sizeof(buffer), spec.c_str(), value);
+
+		if (length < 0)
+			return;
+
+		if (size_t(length) < sizeof(buffer))
+		{
+			out.append(buffer, size_t(length));
+			return;
+		}
+
+		// a wide field or a long string
+		size_t const offset = out.size();
+
+		out.resize(offset + size_t(length) + 1u);
+		std::snprintf(&out[offset], size_t(length) + 1u, spec.c_str(), value);
+		out.resize(offset + size_t(length));
+	}
+
+	int64 AsSigned(Log::Arg const & arg)
+	{
+		switch (arg.type)
+		{
+			case Log::ArgType::SIGNED	: return arg.signedValue;
+			case Log::ArgType::FLOAT	: return int64(arg.floatValue);
+			case Log::ArgType::STRING	: return 0;
+			default						: return int64(arg.unsignedValue);
+		}
+	}
+
+	uint64 AsUnsigned(Log::Arg const & arg)
+	{
+		switch (arg.type)
+		{
+			case Log::ArgType::SIGNED	: return uint64(arg.signedValue);
+			case Log::ArgType::FLOAT	: return uint64(arg.floatValue);
+			case Log::ArgType::STRING	: return 0u;
+			default						: return arg.unsignedValue;
+		}
+	}
+
+	double AsFloat(Log::Arg const & arg)
+	{
+		switch (arg.type)
+		{
+			case Log::ArgType::SIGNED	: return double(arg.signedValue);
+			case Log::ArgType::FLOAT	: return arg.floatValue;
+			case Log::ArgType::STRING	: return 0.;
+			default						: return double(arg.unsignedValue);
+		}
+	}
+
+	void AppendConversion(std::string & out, Conversion const & conversion, Log::Arg const & arg, std::string & spec)
+	{
+		spec.assign(1u, '%');
+		spec += conversion.flags;
+		spec += conversion.width;
+
+		// a string is written as one whatever it was logged for
+		if (arg.type == Log::ArgType::STRING)
+		{
+			std::string const text(arg.text, arg.length);
+
+			spec += conversion.precision;
+			spec += 's';
+
+			AppendFormatted(out, spec, text.c_str());
+			return;
+		}
+
+		switch (conversion.specifier)
+		{
+			case 'd': case 'i':
+				spec += conversion.precision;
+				spec += "lld";
+				AppendFormatted(out, spec, static_cast<long long>(AsSigned(arg)));
+				return;
+
+			case 'u': case 'o': case 'x': case 'X':
+				spec += conversion.precision;
+				spec += "ll";
+				spec += conversion.specifier;
+				AppendFormatted(out, spec, static_cast<unsigned long long>(AsUnsigned(arg)));
+				return;
+
+			case 'c':
+				spec += 'c';
+				AppendFormatted(out, spec, int(AsSigned(arg)));
+				return;
+
+			case 'p':
+				spec += 'p';
+				AppendFormatted(out, spec, reinterpret_cast<void *>(uintptr_t(AsUnsigned(arg))));
+				return;
+
+			case 's':
+				// a number logged for a string
+				spec += arg.type == Log::ArgType::FLOAT ? "g" : arg.type == Log::ArgType::SIGNED ? "lld" : "llu";
+
+				if (arg.type == Log::ArgType::FLOAT)
+					AppendFormatted(out, spec, arg.floatValue);
+				else
+					AppendFormatted(out, spec, arg.unsignedValue);
+				return;
+
+			default:
+				spec += conversion.precision;
+				spec += conversion.specifier;
+				AppendFormatted(out, spec, AsFloat(arg));
+				return;
+		}
+	}
+}
+
+void Log::ArgWriter::Put(cstring text)
+{
+	if (!text)
+		text = "(null)";
+
+	if (m_size + HEADER_SIZE > m_capacity)
+	{
+		m_capacity = m_size;
+		return;
+	}
+
+	uint16 const length = uint16(std::min({ std::strlen(text), m_capacity - m_size - HEADER_SIZE, size_t(0xFFFFu) }));
+
+	m_data[m_size] = byte(ArgType::STRING);
+	std::memcpy(m_data + m_size + 1u, &length, sizeof(uint16));
+	std::memcpy(m_data + m_size + HEADER_SIZE, text, length);
+
+	m_size += HEADER_SIZE + length;
+}
+
+bool Log::ArgReader::Next(Arg & arg)
+{
+	if (m_offset >= m_size)
+		return false;
+
+	arg.type = ArgType(m_data[m_offset] & 0x0Fu);
+
+	if (arg.type == ArgType::STRING)
+	{
+		if (m_offset + HEADER_SIZE > m_size)
+			return false;
+
+		std::memcpy(&arg.length, m_data + m_offset + 1u, sizeof(uint16));
+
+		if (m_offset + HEADER_SIZE + arg.length > m_size)
+			return false;
+
+		arg.text = reinterpret_cast<cstring>(m_data + m_offset + HEADER_SIZE);
+		m_offset += HEADER_SIZE + arg.length;
+
+		return true;
+	}
+
+	size_t const size = m_data[m_offset] >> 4u;
+
+	if (arg.type > ArgType::POINTER || (size != 1u && size != 2u && size != 4u && size != 8u) || m_offset + 1u + size > m_size)
+		return false;
+
+	uint64 bits = 0u;
+	std::memcpy(&bits, m_data + m_offset + 1u, size);
+	m_offset += 1u + size;
+
+	if (arg.type == ArgType::SIGNED && size < sizeof(uint64))
+	{
+		uint32 const unused = uint32(64u - 8u * size);
+		arg.signedValue = int64(bits << unused) >> unused;
+	}
+	else if (arg.type == ArgType::FLOAT && size == sizeof(float))
+	{
+		float narrowed;
+		std::memcpy(&narrowed, &bits, sizeof(float));
+		arg.floatValue = double(narrowed);
+	}
+	else if (arg.type == ArgType::FLOAT)
+		std::memcpy(&arg.floatValue, &bits, sizeof(double));
+	else
+		arg.unsignedValue = bits;
+
+	return true;
+}
+
+void Log::FormatArgs(std::string & out, cstring fmt, byte const * data, size_t size)
+{
+	ArgReader	reader(data, size);
+	Arg			arg;
+	Conversion	conversion;
+	std::string	spec;
+
+	cstring current = fmt;
+
+	while (*current)
+	{
+		cstring const literal = current;
+
+		while (*current && *current != '%')
+			++current;
+
+		out.append(literal, size_t(current - literal));
+
+		if (!*current)
+			break;
+
+		cstring const start = current++;
+
+		if (*current == '%')
+		{
+			out += '%';
+			++current;
+			continue;
+		}
+
+		conversion.flags.clear();
+		conversion.width.clear();
+		conversion.precision.clear();
+
+		bool missing = false;
+
+		while (*current && std::strchr("-+ #0", *current))
+			conversion.flags += *current++;
+
+		// a * takes its value from the arguments, it is written into the rebuilt conversion
+		if (*current == '*')
+		{
+			++current;
+
+			if (reader.Next(arg))
+				conversion.width = std::to_string(AsSigned(arg));
+			else
+				missing = true;
+		}
+		else
+		{
+			while (*current >= '0' && *current <= '9')
+				conversion.width += *current++;
+		}
+
+		if (*current == '.')
+		{
+			conversion.precision += *current++;
+
+			if (*current == '*')
+			{
+				++current;
+
+				if (reader.Next(arg))
+					conversion.precision += std::to_string(std::max(AsSigned(arg), int64(0)));
+				else
+					missing = true;
+			}
+			else
+			{
+				while (*current >= '0' && *current <= '9')
+					conversion.precision += *current++;
+			}
+		}
+
+		// the length modifiers mean nothing once every number is 8 bytes
+		while (*current && std::strchr("hljztLqI", *current))
+		{
+			if (current[0] == 'I' && ((current[1] == '6' && current[2] == '4') || (current[1] == '3' && current[2] == '2')))
+				current += 2;
+
+			++current;
+		}
+
+		conversion.specifier = *current;
+
+		if (!conversion.specifier)
+		{
+			out.append(start, size_t(current - start));
+			break;
+		}
+
+		++current;
+
+		// nothing is written through a %n, its argument is only skipped
+		if (conversion.specifier == 'n')
+		{
+			reader.Next(arg);
+			continue;
+		}
+
+		if (!std::strchr("diuoxXcpseEfFgGaA", conversion.specifier))
+		{
+			out.append(start, size_t(current - start));
+			continue;
+		}
+
+		if (missing || !reader.Next(arg))
+		{
+			out.append(start, size_t(current - start));
+			continue;
+		}
+
+		AppendConversion(out, conversion, arg, spec);
+	}
+}
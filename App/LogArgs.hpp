@@ -0,0 +1,191 @@
+#pragma once
+
+#include <Util.h>
+
+	namespace Log
+	{
+		// What a logging call hands over instead of its text: every argument behind a byte
+		// with its kind, in the low nibble, and its size. Numbers take the fewest of 1, 2, 4
+		// or 8 little endian bytes that hold them exactly, a double that is exactly a float
+		// takes 4; strings are copied after a 16 bit length. The format string is not in
+		// it, it is only needed once the text is wanted.
+		enum class ArgType :
+			byte
+		{
+			SIGNED,
+			UNSIGNED,
+			FLOAT,
+			STRING,
+			POINTER
+		};
+
+		struct Arg
+		{
+			ArgType		type;
+
+			union
+			{
+				int64	signedValue;
+				uint64	unsignedValue;
+				double	floatValue;
+			};
+
+			cstring		text	{nullptr};	// not terminated
+			uint16		length	{0u};
+		};
+
+		// Encodes into a fixed buffer, what does not fit is left out: a string is cut to
+		// the space left, a number that no longer fits is dropped with everything after it.
+		class ArgWriter
+		{
+			byte *	m_data;
+			size_t	m_capacity;
+			size_t	m_size		{0u};
+
+			// bits holds the value sign or zero extended, size is the bytes kept of it
+			void PutNumber(ArgType type, uint64 bits, uint32 size);
+
+			static uint32 SignedSize(int64 value);
+			static uint32 UnsignedSize(uint64 value);
+
+			public:
+
+				ArgWriter(byte * data, size_t capacity) :
+					m_data(data), m_capacity(capacity)
+				{
+				}
+
+				void Put(cstring text);
+
+				void Put(char * text) {
+					Put(static_cast<cstring>(text));
+				}
+
+				template<typename T>
+				void Put(T * pointer);
+
+				template<typename T>
+				typename std::enable_if<std::is_floating_point<T>::value>::type Put(T value);
+
+				template<typename T>
+				typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type Put(T value);
+
+				template<typename T>
+				typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value>::type Put(T value);
+
+				template<typename T>
+				typename std::enable_if<std::is_enum<T>::value>::type Put(T value);
+
+				size_t GetSize() const {
+					return m_size;
+				}
+		};
+
+		class ArgReader
+		{
+			byte const *	m_data;
+			size_t			m_size;
+			size_t			m_offset	{0u};
+
+			public:
+
+				ArgReader(byte const * data, size_t size) :
+					m_data(data), m_size(size)
+				{
+				}
+
+				// false once every argument is read, or on a truncated one
+				bool Next(Arg & arg);
+		};
+
+		// the arguments' bytes, at most capacity of them
+		template<typename ...args>
+		size_t EncodeArgs(byte * data, size_t capacity, args ...vargs);
+
+		// Appends the text printf would make of fmt with the encoded arguments. Every
+		// conversion is done with the encoded kind, an argument of another kind than its
+		// conversion asks for is converted, never reinterpreted; a conversion left without
+		// an argument is copied as it is.
+		void FormatArgs(std::string & out, cstring fmt, byte const * data, size_t size);
+
+		template<typename T>
+		inline void ArgWriter::Put(T * pointer)
+		{
+			PutNumber(ArgType::POINTER, uint64(reinterpret_cast<uintptr_t>(pointer)), sizeof(uint64));
+		}
+
+		template<typename T>
+		inline typename std::enable_if<std::is_floating_point<T>::value>::type ArgWriter::Put(T value)
+		{
+			double const	widened = double(value);
+			float const		narrowed = float(widened);
+
+			if (double(narrowed) == widened)
+			{
+				uint32 narrowBits;
+				std::memcpy(&narrowBits, &narrowed, sizeof(float));
+
+				PutNumber(ArgType::FLOAT, narrowBits, sizeof(float));
+				return;
+			}
+
+			uint64 bits;
+			std::memcpy(&bits, &widened, sizeof(double));
+
+			PutNumber(ArgType::FLOAT, bits, sizeof(double));
+		}
+
+		template<typename T>
+		inline typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type ArgWriter::Put(T value)
+		{
+			PutNumber(ArgType::SIGNED, uint64(int64(value)), SignedSize(int64(value)));
+		}
+
+		template<typename T>
+		inline typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value>::type ArgWriter::Put(T value)
+		{
+			PutNumber(ArgType::UNSIGNED, uint64(value), UnsignedSize(uint64(value)));
+		}
+
+		template<typename T>
+		inline typename std::enable_if<std::is_enum<T>::value>::type ArgWriter::Put(T value)
+		{
+			Put(static_cast<typename std::underlying_type<T>::type>(value));
+		}
+
+		inline uint32 ArgWriter::SignedSize(int64 value)
+		{
+			return value == int8(value) ? 1u : value == int16(value) ? 2u : value == int32(value) ? 4u : 8u;
+		}
+
+		inline uint32 ArgWriter::UnsignedSize(uint64 value)
+		{
+			return value <= 0xFFu ? 1u : value <= 0xFFFFu ? 2u : value <= 0xFFFFFFFFu ? 4u : 8u;
+		}
+
+		inline void ArgWriter::PutNumber(ArgType type, uint64 bits, uint32 size)
+		{
+			if (m_size + 1u + size > m_capacity)
+			{
+				m_capacity = m_size;
+				return;
+			}
+
+			// the low bytes come first on the little endian targets this builds for
+			m_data[m_size] = byte(type) | byte(size << 4u);
+			std::memcpy(m_data + m_size + 1u, &bits, size);
+
+			m_size += 1u + size;
+		}
+
+		template<typename ...args>
+		inline size_t EncodeArgs(byte * data, size_t capacity, args ...vargs)
+		{
+			ArgWriter writer(data, capacity);
+
+			int const expand[] = { 0, (writer.Put(vargs), 0)... };
+			(void)expand;
+
+			return writer.GetSize();
+		}
+	}
@@ -0,0 +1,84 @@
+#include "LogBenchmark.hpp"
+
+namespace
+{
+	// counts what it is given and drops it
+	class DiscardBuffer :
+		public std::basic_streambuf<char>
+	{
+		public:
+
+			uint64 characters {0u};
+
+		protected:
+
+			std::streamsize xsputn(const char *, std::streamsize count) override
+			{
+				characters += uint64(count);
+				return count;
+			}
+
+			int_type overflow(int_type type) override
+			{
+				characters++;
+				return traits_type::not_eof(type);
+			}
+	};
+}
+
+std::vector<Log::LogBenchmarkResult> Log::BenchmarkLogBuffer(uint32 repetitions)
+{
+	constexpr uint32 MESSAGES		= 20000u;
+	constexpr uint32 SINKS[]		= { 1u, 2u, 4u, 8u };
+	constexpr uint32 LENGTHS[]		= { 16u, 128u, 1024u };
+
+	std::vector<LogBenchmarkResult> results;
+
+	for (uint32 sinks : SINKS)
+	{
+		std::vector<std::unique_ptr<DiscardBuffer>>	buffers;
+		std::vector<std::unique_ptr<std::ostream>>	streams;
+
+		Logger logger;
+		logger.RemoveAllStreams();
+
+		for (uint32 i = 0u; i < sinks; ++i)
+		{
+			buffers.emplace_back(new DiscardBuffer());
+			streams.emplace_back(new std::ostream(buffers.back().get()));
+
+			logger.AddStream(streams.back().get(), "benchmark" + std::to_string(i));
+		}
+
+		for (uint32 length : LENGTHS)
+		{
+			std::string const message = std::string(length - 1u, 'x') + '\n';
+
+			LogBenchmarkResult result;
+			result.sinks	= sinks;
+			result.length	= length;
+			result.messages	= MESSAGES;
+
+			for (uint32 run = 0u; run < std::max(1u, repetitions); ++run)
+			{
+				Misc::Stopwatch stopwatch;
+				stopwatch.Start();
+
+				for (uint32 i = 0u; i < MESSAGES; ++i)
+				{
+					logger.write(message.data(), std::streamsize(message.size()));
+					logger.flush();
+				}
+
+				stopwatch.Stop();
+
+				if (run == 0u || stopwatch.GetTime() < result.elapsed)
+					result.elapsed = stopwatch.GetTime();
+			}
+
+			results.push_back(result);
+		}
+	}
+
+	return results;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Log.hpp"
+
+#include <Utils\Stopwatch.h>
+
+	namespace Log
+	{
+		struct LogBenchmarkResult
+		{
+			uint32					sinks		{0u};
+			uint32					length		{0u};	// characters per message, the newline included
+			uint32					messages	{0u};
+			Misc::clock::duration	elapsed		{0};
+
+			double inline NanosecondsPerMessage() const {
+				return std::chrono::duration<double, std::nano>(elapsed).count() / double(std::max(1u, messages));
+			}
+
+			// what every character costs on every sink, the part that grows with both
+			double inline NanosecondsPerCharacter() const {
+				return NanosecondsPerMessage() / double(std::max(1u, sinks * length));
+			}
+		};
+
+		// Writes and flushes whole messages of 16 to 1024 characters through a Logger with 1 to
+		// 8 sinks that throw away what they get, on the calling thread; only the LogBuffer
+		// fan-out is measured, not formatting or the sinks themselves.
+		std::vector<LogBenchmarkResult> BenchmarkLogBuffer(uint32 repetitions = 3u);
+	}
@@ -0,0 +1,171 @@
+#include "LogQueue.hpp"
+
+namespace
+{
+	// how long the writer sleeps when the queue is empty, producers never wake it
+	constexpr auto WRITER_IDLE = std::chrono::milliseconds(2);
+}
+
+Log::LogQueue::LogQueue(Logger & logger, uint32 capacity):
+	m_logger(logger)
+{
+	uint64 size = 1u;
+
+	while (size < std::max(capacity, 2u))
+		size <<= 1u;
+
+	m_slots.reset(new Slot[size]);
+	m_mask = size - 1u;
+
+	for (uint64 i = 0u; i < size; ++i)
+		m_slots[i].sequence.store(i, std::memory_order_relaxed);
+
+	m_writer = std::thread(&LogQueue::WriterLoop, this);
+}
+
+Log::LogQueue::~LogQueue()
+{
+	m_stop.store(true, std::memory_order_release);
+	m_wake.notify_one();
+
+	if (m_writer.joinable())
+		m_writer.join();
+}
+
+Log::LogQueue::Slot * Log::LogQueue::Claim(uint64 & position, bool wait)
+{
+	position = m_head.load(std::memory_order_relaxed);
+
+	for (;;)
+	{
+		Slot &		 slot		= m_slots[position & m_mask];
+		int64 const	 distance	= int64(slot.sequence.load(std::memory_order_acquire) - position);
+
+		if (distance == 0)
+		{
+			if (m_head.compare_exchange_weak(position, position + 1u, std::memory_order_relaxed))
+				return &slot;
+		}
+		else if (distance < 0)
+		{
+			// the slot still holds the record from one lap earlier, the queue is full
+			if (!wait)
+			{
+				m_dropped.fetch_add(1u, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			std::this_thread::yield();
+			position = m_head.load(std::memory_order_relaxed);
+		}
+		else
+			position = m_head.load(std::memory_order_relaxed);
+	}
+}
+
+void Log::LogQueue::Publish(Slot & slot, uint64 position, LogLevel level, uint16 tagId, uint32 formatId, cstring tag, size_t argBytes)
+{
+	QueuedRecord & record = slot.record;
+
+	record.level	= level;
+	record.tagId	= tagId;
+	record.formatId	= formatId;
+	record.time		= std::time(nullptr);
+	record.argBytes	= uint32(argBytes);
+
+	size_t const tagLength = tag ? std::min(std::strlen(tag), size_t(QueuedRecord::TAG_SIZE - 1u)) : 0u;
+
+	std::memcpy(record.tag, tag, tagLength);
+	record.tag[tagLength] = '\0';
+
+	slot.sequence.store(position + 1u, std::memory_order_release);
+}
+
+bool Log::LogQueue::Drain(uint64 & tail, uint64 & reportedDrops)
+{
+	bool	wrote	= false;
+	Message	message;
+
+	// at most one lap, the sinks are flushed even while producers keep the queue busy
+	for (uint64 const end = tail + m_mask + 1u; tail != end;)
+	{
+		Slot & slot = m_slots[tail & m_mask];
+
+		if (slot.sequence.load(std::memory_order_acquire) != tail + 1u)
+			break;
+
+		// the sinks are flushed once for everything drained
+		m_logger.WriteRecord(slot.record, message);
+
+		slot.sequence.store(tail + m_mask + 1u, std::memory_order_release);
+		++tail;
+
+		wrote = true;
+	}
+
+	// Flush returns once the records are in the sinks, not only taken off the queue
+	if (wrote)
+	{
+		m_logger.FlushAll();
+		m_written.store(tail, std::memory_order_release);
+	}
+
+	uint64 const dropped = m_dropped.load(std::memory_order_relaxed);
+
+	if (dropped != reportedDrops)
+	{
+		m_logger.PrintM(LogLevel::LWARNING, "LOG", "%llu records dropped, the log queue was full", dropped - reportedDrops);
+		reportedDrops = dropped;
+	}
+
+	return wrote;
+}
+
+void Log::LogQueue::WriterLoop()
+{
+	uint64 tail				= 0u;
+	uint64 reportedDrops	= 0u;
+
+	for (;;)
+	{
+		if (Drain(tail, reportedDrops))
+			continue;
+
+		// claimed slots are always published, so nothing is left behind once the head is reached
+		if (m_stop.load(std::memory_order_acquire) && tail == m_head.load(std::memory_order_acquire))
+			return;
+
+		std::unique_lock<std::mutex> lock(m_lock);
+		m_wake.wait_for(lock, WRITER_IDLE);
+	}
+}
+
+void Log::LogQueue::Flush()
+{
+	// the writer logging through the queue would wait on itself
+	if (std::this_thread::get_id() == m_writer.get_id())
+		return;
+
+	uint64 const target = m_head.load(std::memory_order_acquire);
+
+	while (m_written.load(std::memory_order_acquire) < target)
+	{
+		m_wake.notify_one();
+		std::this_thread::yield();
+	}
+}
+
+void Log::LogQueue::SetOverflowPolicy(OverflowPolicy policy)
+{
+	m_policy.store(policy, std::memory_order_relaxed);
+}
+
+Log::OverflowPolicy Log::LogQueue::GetOverflowPolicy() const
+{
+	return m_policy.load(std::memory_order_relaxed);
+}
+
+uint64 Log::LogQueue::GetDroppedCount() const
+{
+	return m_dropped.load(std::memory_order_relaxed);
+}
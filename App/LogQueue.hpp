@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Log.hpp"
+
+#include <condition_variable>
+
+	namespace Log
+	{
+		enum class OverflowPolicy :
+			byte
+		{
+			DROP,	// a record that finds the queue full is counted and lost
+			BLOCK	// the caller waits for the writer to free a slot
+		};
+
+		// one message as the thread that logged it left it, its arguments encoded, not formatted
+		struct QueuedRecord
+		{
+			static constexpr uint32 TAG_SIZE = 32u;
+
+			LogLevel	level;
+			uint16		tagId;
+			uint32		formatId;
+			std::time_t	time;
+			uint32		argBytes;
+			char		tag[TAG_SIZE];
+			byte		arguments[LOG_SIZE];	// LogArgs encoded
+		};
+
+		// Bounded multi-producer single-consumer ring between the threads that log and the
+		// sinks. A producer claims a slot with one compare-exchange on the head, copies its
+		// arguments into it and publishes it through the slot's sequence number, it never
+		// takes a lock, formats or waits on a sink. A background thread writes the published
+		// slots to the Logger in the order they were claimed.
+		class LogQueue :
+			public Misc::Noncopyable
+		{
+			public:
+
+				static constexpr uint32 CAPACITY = 1024u;
+
+			private:
+
+				struct Slot
+				{
+					std::atomic<uint64>	sequence;	// position + 1 once published, position + capacity once free again
+					QueuedRecord		record;
+				};
+
+				Logger &							m_logger;
+				std::unique_ptr<Slot[]>				m_slots;
+				uint64								m_mask;
+
+				alignas(64) std::atomic<uint64>		m_head		{0u};	// next position to claim
+				alignas(64) std::atomic<uint64>		m_written	{0u};	// positions the writer is done with
+				std::atomic<uint64>					m_dropped	{0u};
+				std::atomic<OverflowPolicy>			m_policy	{OverflowPolicy::DROP};
+
+				std::thread							m_writer;
+				std::mutex							m_lock;			// only for the writer's idle wait
+				std::condition_variable				m_wake;
+				std::atomic<bool>					m_stop		{false};
+
+				// nullptr when the queue is full and the record is dropped
+				Slot * Claim(uint64 & position, bool wait);
+				void   Publish(Slot & slot, uint64 position, LogLevel level, uint16 tagId, uint32 formatId, cstring tag, size_t argBytes);
+
+				void WriterLoop();
+
+				// writes what is published, false if nothing was
+				bool Drain(uint64 & tail, uint64 & reportedDrops);
+
+			public:
+
+				// capacity is rounded up to a power of two
+				explicit LogQueue(Logger & logger, uint32 capacity = CAPACITY);
+
+				// writes every record still queued
+				~LogQueue();
+
+				// encodes into a free slot, false if no sink takes the record or it was dropped;
+				// a fatal record always waits for a slot and returns once it is written
+				template<typename ...args>
+				bool Push(LogLevel level, uint16 tagId, uint32 formatId, cstring tag, args ...vargs);
+
+				// returns once every record pushed before it is written
+				void Flush();
+
+				void			SetOverflowPolicy(OverflowPolicy policy);
+				OverflowPolicy	GetOverflowPolicy() const;
+
+				// records lost to a full queue since it was made
+				uint64			GetDroppedCount()	const;
+		};
+
+		template<typename ...args>
+		inline bool LogQueue::Push(LogLevel level, uint16 tagId, uint32 formatId, cstring tag, args ...vargs)
+		{
+			// filtered out before anything is encoded or claimed
+			if (!m_logger.Accepts(tagId, level))
+				return false;
+
+			bool const fatal = level == LogLevel::LFATAL;
+
+			uint64 position;
+			Slot * slot = Claim(position, fatal || GetOverflowPolicy() == OverflowPolicy::BLOCK);
+
+			if (!slot)
+				return false;
+
+			Publish(*slot, position, level, tagId, formatId, tag, EncodeArgs(slot->record.arguments, LOG_SIZE, vargs...));
+
+			if (fatal)
+				Flush();
+
+			return true;
+		}
+	}
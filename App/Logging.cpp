@@ -17,6 +17,12 @@ namespace Log
 			return m_logger;
 		}
 
+		LogQueue& Queue()
+		{
+			(*this)();
+			return *m_queue;
+		}
+
 	private:
 
 		std::string GetTimeStamp()
@@ -32,7 +38,7 @@ namespace Log
 			formatter << "_";
 			formatter << now.tm_hour << ';' << now.tm_min << ';' << now.tm_sec;
 
-			return formatter.str() + ".log";
+			return formatter.str();
 		}
 
 		void Init()
@@ -62,11 +68,21 @@ namespace Log
 			fileFilter.filterLevel = false;
 			fileFilter.filterTags  = false;
 
-			m_logger.CreateLogFile("logFile_" + GetTimeStamp(), fileFilter);
+		#ifdef LOG_BINARY_FILE
+			// read with LogDecoder
+			m_logger.CreateLogFile("logFile_" + GetTimeStamp() + ".blog", fileFilter, false, LogFormat::BINARY);
+		#else
+			m_logger.CreateLogFile("logFile_" + GetTimeStamp() + ".log", fileFilter);
+		#endif
+
+			m_queue.reset(new LogQueue(m_logger));
 		}
 
 		Logger m_logger;
 
+		// declared after the logger, so it is destroyed first and writes what is left into it
+		std::unique_ptr<LogQueue> m_queue;
+
 		char m_stdoutBuffer[Log::LOG_SIZE];
 		char m_stderrBuffer[Log::LOG_SIZE];
 		char m_stdlogBuffer[Log::LOG_SIZE];
@@ -77,4 +93,19 @@ namespace Log
 	{
 		return __globalLog();
 	}
+
+	LogQueue& GetLogQueue()
+	{
+		return __globalLog.Queue();
+	}
+
+	uint16 InternTag(const char * tag)
+	{
+		return GetEngineLogger().InternTag(tag);
+	}
+
+	uint32 InternFormat(const char * fmt)
+	{
+		return GetEngineLogger().InternFormat(fmt);
+	}
 }
\ No newline at end of file
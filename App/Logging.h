@@ -1,13 +1,72 @@
 #pragma once
 
 #include <App\Log.hpp>
+#include <App\LogQueue.hpp>
 
-#define LOG_DBG(tag, fmt, ...)	Log::Print(LogLevel::LDEBUG,	  tag, fmt, __VA_ARGS__)
-#define LOG_INFO(tag, fmt, ...)	Log::Print(LogLevel::LINFO,	  tag, fmt, __VA_ARGS__)
-#define LOG_WARN(tag, fmt, ...)	Log::Print(LogLevel::LWARNING,  tag, fmt, __VA_ARGS__)
-#define LOG_ERR(tag, fmt, ...)	Log::Print(LogLevel::LERROR,	  tag, fmt, __VA_ARGS__)
-#define LOG_FTL(tag, fmt, ...)	Log::Print(LogLevel::LFATAL,	  tag, fmt, __VA_ARGS__)
-#define LOG_VRB(tag, fmt, ...)	Log::Print(LogLevel::LVERBOSE,  tag, fmt, __VA_ARGS__)
+// Build time filtering. Calls below LOG_MIN_LEVEL compile to nothing, their arguments are
+// never evaluated; so do calls whose tag is missing from LOG_TAG_ALLOWLIST when it is
+// defined, a list of string literals such as /D LOG_TAG_ALLOWLIST="\"Fractal\",\"OpenGL\"".
+// The levels are ranked by severity here, unlike the LogLevel flags.
+#define LOG_LEVEL_VERBOSE	0
+#define LOG_LEVEL_DEBUG		1
+#define LOG_LEVEL_INFO		2
+#define LOG_LEVEL_WARNING	3
+#define LOG_LEVEL_ERROR		4
+#define LOG_LEVEL_FATAL		5
+
+#ifndef LOG_MIN_LEVEL
+	#define LOG_MIN_LEVEL LOG_LEVEL_VERBOSE
+#endif
+
+// A call site interns its tag and its format once, the runtime filter is then a lookup
+// by tag id and the call only copies its arguments. The format has to be a literal.
+#define LOG_AT(level, tag, fmt, ...)																\
+	do																								\
+	{																								\
+		if (std::integral_constant<bool, Log::IsTagCompiledIn(tag)>::value)							\
+		{																							\
+			static uint16 const logTagId	= Log::InternTag(tag);									\
+			static uint32 const logFormatId	= Log::InternFormat("" fmt);							\
+			Log::Print(level, logTagId, logFormatId, tag, __VA_ARGS__);								\
+		}																							\
+	}																								\
+	while (false)
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_DEBUG
+	#define LOG_DBG(tag, fmt, ...)	LOG_AT(LogLevel::LDEBUG,	  tag, fmt, __VA_ARGS__)
+#else
+	#define LOG_DBG(tag, fmt, ...)	((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_INFO
+	#define LOG_INFO(tag, fmt, ...)	LOG_AT(LogLevel::LINFO,	  tag, fmt, __VA_ARGS__)
+#else
+	#define LOG_INFO(tag, fmt, ...)	((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_WARNING
+	#define LOG_WARN(tag, fmt, ...)	LOG_AT(LogLevel::LWARNING,  tag, fmt, __VA_ARGS__)
+#else
+	#define LOG_WARN(tag, fmt, ...)	((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_ERROR
+	#define LOG_ERR(tag, fmt, ...)	LOG_AT(LogLevel::LERROR,	  tag, fmt, __VA_ARGS__)
+#else
+	#define LOG_ERR(tag, fmt, ...)	((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_FATAL
+	#define LOG_FTL(tag, fmt, ...)	LOG_AT(LogLevel::LFATAL,	  tag, fmt, __VA_ARGS__)
+#else
+	#define LOG_FTL(tag, fmt, ...)	((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_VERBOSE
+	#define LOG_VRB(tag, fmt, ...)	LOG_AT(LogLevel::LVERBOSE,  tag, fmt, __VA_ARGS__)
+#else
+	#define LOG_VRB(tag, fmt, ...)	((void)0)
+#endif
 
 //for convenience
 typedef Log::LogLevel LogLevel;
@@ -19,32 +78,78 @@ typedef Log::LogLevel LogLevel;
 									__LINE__, __FUNCTION__, Misc::ExtractFilename(__FILE__).c_str());	\
 		Log::Print(LogLevel::LFATAL, "ASSERT", fmt, __VA_ARGS__);										\
 		std::abort();																					\
-	}	
+	}
 
 	namespace Log
 	{
 		Logger& GetEngineLogger();
 
-		static std::mutex g_print_mutex;
+		// every Print goes through it, the engine logger is only written from its thread
+		LogQueue& GetLogQueue();
+
+		// the engine logger's id for the tag
+		uint16 InternTag(const char * tag);
+
+		// the engine logger's id for the format string
+		uint32 InternFormat(const char * fmt);
+
+#ifdef LOG_TAG_ALLOWLIST
+		constexpr const char * TAG_ALLOWLIST[] = { LOG_TAG_ALLOWLIST };
+
+		constexpr bool SameTag(const char * first, const char * second)
+		{
+			while (*first && *first == *second)
+			{
+				++first;
+				++second;
+			}
+
+			return *first == *second;
+		}
+
+		constexpr bool IsTagCompiledIn(const char * tag)
+		{
+			for (size_t i = 0u; i < sizeof(TAG_ALLOWLIST) / sizeof(TAG_ALLOWLIST[0]); ++i)
+			{
+				if (SameTag(TAG_ALLOWLIST[i], tag))
+					return true;
+			}
+
+			return false;
+		}
+#else
+		constexpr bool IsTagCompiledIn(const char *)
+		{
+			return true;
+		}
+#endif
+
+		template<typename...args>
+		void Print(LogLevel level, uint16 tagId, uint32 formatId, const char* tag, args... vargs);
 
 		template<typename...args>
 		void Print(LogLevel level, const char* tag, const char* fmt, args... vargs);
 
 		template<typename...args>
 		void Print(LogLevel level, const char* tag, std::string fmt, args... vargs);
-		
+
+		template<typename ...args>
+		void Print(LogLevel level, uint16 tagId, uint32 formatId, const char * tag, args ...vargs)
+		{
+			GetLogQueue().Push(level, tagId, formatId, tag, vargs...);
+		}
+
+		// without a call site to keep the ids, the tag and the format are looked up every time;
+		// every distinct format stays in the logger, they are not meant to be built at runtime
 		template<typename ...args>
 		void Print(LogLevel level, const char * tag, const char * fmt, args ...vargs)
 		{
-			std::lock_guard<std::mutex> guard{ g_print_mutex };
-			GetEngineLogger().PrintM(level, tag, fmt, vargs...);
+			GetLogQueue().Push(level, InternTag(tag), InternFormat(fmt), tag, vargs...);
 		}
 
 		template<typename ...args>
 		void Print(LogLevel level, const char * tag, std::string fmt, args ...vargs)
 		{
-			std::lock_guard<std::mutex> guard{ g_print_mutex };
-			GetEngineLogger().PrintM(level, tag, fmt.c_str(), vargs...);
+			GetLogQueue().Push(level, InternTag(tag), InternFormat(fmt.c_str()), tag, vargs...);
 		}
 	}
-
@@ -217,8 +217,28 @@ void WinapiApp::DestroyAppWindow()
 
 void WinapiApp::MainLoop()
 {
-	while (GetMessage(&m_currentMessage, m_windowHandle, 0, 0) > 0)
+	for (;;)
 	{
+		// drain the whole queue before drawing, a burst of input ends up as a single frame
+		while (PeekMessage(&m_currentMessage, NULL, 0, 0, PM_REMOVE))
+		{
+			if (m_currentMessage.message == WM_QUIT)
+				return;
+
+			++m_messageCount;
+
+			TranslateMessage(&m_currentMessage);
+			DispatchMessage(&m_currentMessage);
+		}
+
+		if (!m_frameRequested)
+		{
+			WaitMessage();
+			continue;
+		}
+
+		m_frameRequested = false;
+
 		if (m_limitFPS)
 			m_limiter.OnStartFrame();
 
@@ -231,8 +251,7 @@ void WinapiApp::MainLoop()
 		if (m_limitFPS)
 			m_limiter.OnEndFrame();
 
-		TranslateMessage(&m_currentMessage);
-		DispatchMessage(&m_currentMessage);
+		++m_renderedFrames;
 	}
 }
 
@@ -241,6 +260,21 @@ void WinapiApp::SetFrameTick(std::function<void()> tick)
 	m_frameTick = tick;
 }
 
+void WinapiApp::RequestFrame()
+{
+	m_frameRequested = true;
+}
+
+uint64 WinapiApp::GetRenderedFrames() const
+{
+	return m_renderedFrames;
+}
+
+uint64 WinapiApp::GetSkippedFrames() const
+{
+	return m_messageCount > m_renderedFrames ? m_messageCount - m_renderedFrames : 0u;
+}
+
 void WinapiApp::SetWindowPosition(uint32 const anchor_x, uint32 const anchor_y)
 {
 	if (m_windowHandle)
@@ -143,6 +143,10 @@ class WinapiApp
 	FramerateLimiter m_limiter;
 	bool			 m_limitFPS{true};
 
+	bool	m_frameRequested	{true};	// something changed since the last frame was drawn
+	uint64	m_messageCount		{0u};
+	uint64	m_renderedFrames	{0u};
+
 	HGLRC					CreateFakeContext();
 	std::vector<int>		GetWGLAttributes(bool contextAtrbs = false);
 
@@ -163,6 +167,13 @@ class WinapiApp
 	bool HasContext();
 
 	void SetFrameTick(std::function<void()> tick);
+
+	// the frame tick only runs once this has been called, however many times before the next frame
+	void RequestFrame();
+
+	uint64 GetRenderedFrames() const;
+	// messages which did not end in a frame of their own, either idle or coalesced into a later one
+	uint64 GetSkippedFrames() const;
 	void SetWindowPosition(uint32 const anchor_x, uint32 const anchor_y);
 
 	math::vec2u GetWindowSize();
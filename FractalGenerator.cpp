@@ -17,6 +17,11 @@ FractalGenerator::FractalGenerator(HINSTANCE instance, WNDPROC proc)//:
 	LOG_DBG(TAG, "FractalGenerator has been initialized");
 }
 
+FractalGenerator::~FractalGenerator()
+{
+	CancelCpuFrame();
+}
+
 bool FractalGenerator::CreateApplication(HINSTANCE instance, WNDPROC proc)
 {
 	ContextArgs contextAtrb		{ 0 };
@@ -50,36 +55,47 @@ bool FractalGenerator::CreateApplication(HINSTANCE instance, WNDPROC proc)
 	return true;
 }
 
-bool FractalGenerator::InitializeGraphics()
+Graphics::ShaderProgramPtr FractalGenerator::LoadProgram(cstring vertexFile, cstring fragmentFile)
 {
 	Graphics::ShaderCode vertexCode;
 	Graphics::ShaderCode fragmentCode;
 
-	vertexCode.LoadFromFile("../Resources/QuadVertex.glsl");
-	fragmentCode.LoadFromFile("../Resources/MandelbrotFragment.glsl");
+	vertexCode.LoadFromFile(vertexFile);
+	fragmentCode.LoadFromFile(fragmentFile);
 
 	Graphics::ShaderStagePtr vertex		= std::make_shared<Graphics::ShaderStage>(Graphics::ShaderType::VERTEX, vertexCode);
 	Graphics::ShaderStagePtr fragment	= std::make_shared<Graphics::ShaderStage>(Graphics::ShaderType::FRAGMENT, fragmentCode);
 
-	m_fractalShader = std::make_shared<Graphics::ShaderProgram>();
+	Graphics::ShaderProgramPtr program = std::make_shared<Graphics::ShaderProgram>();
 
-	if (!m_fractalShader || !vertex || !fragment)
-		return false;
+	if (!program || !vertex || !fragment)
+		return nullptr;
+
+	program->AddStage(vertex,	Graphics::ShaderType::VERTEX);
+	program->AddStage(fragment, Graphics::ShaderType::FRAGMENT);
+
+	program->LinkProgram();
 
-	m_fractalShader->AddStage(vertex,	Graphics::ShaderType::VERTEX);
-	m_fractalShader->AddStage(fragment, Graphics::ShaderType::FRAGMENT);
+	return program;
+}
+
+bool FractalGenerator::InitializeGraphics()
+{
+	m_fractalShader		= LoadProgram("../Resources/QuadVertex.glsl", "../Resources/MandelbrotFragment.glsl");
+	m_coloringShader	= LoadProgram("../Resources/QuadVertex.glsl", "../Resources/ColoringFragment.glsl");
 
-	m_fractalShader->LinkProgram();
+	if (!m_fractalShader || !m_coloringShader)
+		return false;
+
+	if (!m_fractalShader->RegisterUniformBlock	("ViewBlock", VIEW_BLOCK_BINDING, sizeof(Render::ViewUniforms)) ||
+		!m_coloringShader->RegisterUniformBlock	("ViewBlock", VIEW_BLOCK_BINDING, sizeof(Render::ViewUniforms)))
+		return false;
 
-	m_fractalShader->RegisterUniform("u_maxIter",			Graphics::ValueType::UINT);
-	m_fractalShader->RegisterUniform("u_zoom",				Graphics::ValueType::FLOAT);
-	m_fractalShader->RegisterUniform("u_offset",			Graphics::ValueType::VEC2F);
-	m_fractalShader->RegisterUniform("u_canvas",			Graphics::ValueType::VEC2U);
-	m_fractalShader->RegisterUniform("u_fractalType",		Graphics::ValueType::BOOL);
-	m_fractalShader->RegisterUniform("u_colorModifier",		Graphics::ValueType::VEC3F);
-	m_fractalShader->RegisterUniform("u_juliaConstant",		Graphics::ValueType::VEC2F);
+	m_viewBuffer	= std::make_shared<Graphics::UniformBuffer>(VIEW_BLOCK_BINDING, sizeof(Render::ViewUniforms));
+	m_escapeUniform	= m_coloringShader->RegisterUniform<int32>("u_escape");
 
 	m_screenCanvas	= std::make_shared<Graphics::Quad>();
+	m_escapeTarget	= std::make_shared<Graphics::FrameBuffer>(GL_RG32F, GL_RG, GL_FLOAT);
 
 	UpdateViewport();
 
@@ -92,23 +108,73 @@ void FractalGenerator::SetLoop()
 	(
 		[this]()
 		{
-			m_fractalShader->SetUniformUint	("u_maxIter",		m_maxIterations);
-			m_fractalShader->SetUniformBool	("u_fractalType",	(bool)m_fractal);
-			m_fractalShader->SetUniformFloat("u_zoom",			m_zoom);
-			m_fractalShader->SetUniform2f	("u_offset",		m_offset);
-			m_fractalShader->SetUniform2u	("u_canvas",		m_viewport);
-			m_fractalShader->SetUniform3f	("u_colorModifier",	m_colorModifier);
-			m_fractalShader->SetUniform2f	("u_juliaConstant",	m_juliaConstant);
-			
 			this->Draw();
 		}
 	);
 }
 
+void FractalGenerator::MarkDirty()
+{
+	m_application->RequestFrame();
+}
+
+void FractalGenerator::LogFrameCounters() const
+{
+	uint64 const rendered	= m_application->GetRenderedFrames();
+	uint64 const skipped	= m_application->GetSkippedFrames();
+
+	LOG_INFO(TAG, "Frames: %llu rendered, %llu skipped (%.1f%% of messages drew nothing)",
+			 rendered, skipped, rendered + skipped ? 100. * double(skipped) / double(rendered + skipped) : 0.);
+
+	LOG_INFO(TAG, "Uniforms: %u uploaded, %u unchanged and skipped last frame, %llu skipped in all",
+			 m_frameUploads.issued, m_frameUploads.skipped, m_skippedUploads);
+}
+
 void FractalGenerator::Draw()
 {
+	Render::FractalView const	view		= GetView();
+	Render::ViewUniforms const	uniforms	= view.GetUniforms();
+
+	// one write for the whole view, shared by both passes
+	if (!m_hasViewUniforms || std::memcmp(&uniforms, &m_viewUniforms, sizeof(Render::ViewUniforms)) != 0)
+	{
+		m_viewBuffer->Write(uniforms);
+
+		m_viewUniforms		= uniforms;
+		m_hasViewUniforms	= true;
+	}
+
+	bool const resized = m_escapeTarget->GetSize().x != m_viewport.x || m_escapeTarget->GetSize().y != m_viewport.y;
+
+	// the escape samples only change with the view, the colour modifier is left to the colouring pass
+	if (resized || !m_hasEscape || !view.SharesEscape(m_escapeView))
+	{
+		m_escapeTarget->Resize(m_viewport);
+		m_escapeTarget->Bind();
+
+		m_fractalShader->Use();
+		m_screenCanvas->Draw(m_fractalShader);
+
+		m_escapeTarget->Unbind();
+
+		m_escapeView	= view;
+		m_hasEscape		= true;
+	}
+
+	glViewport(0, 0, m_viewport.x, m_viewport.y);
 	Flush();
-	m_screenCanvas->Draw(m_fractalShader);
+
+	m_escapeTarget->BindTexture(0u);
+
+	m_coloringShader->Use();
+	m_escapeUniform.Set(0);
+
+	m_screenCanvas->Draw(m_coloringShader);
+
+	m_frameUploads	= m_fractalShader->TakeUniformUploads();
+	m_frameUploads	+= m_coloringShader->TakeUniformUploads();
+
+	m_skippedUploads += m_frameUploads.skipped;
 }
 
 void FractalGenerator::Flush()
@@ -148,12 +214,382 @@ void FractalGenerator::Run()
 	m_application->MainLoop();
 }
 
+void FractalGenerator::RunBenchmark()
+{
+	LOG_INFO(TAG, "Benchmarking escape-time kernels, detected instruction set: %s",
+			 Render::ToString(Render::DetectInstructionSet()));
+
+	auto const results = Render::BenchmarkKernels(GetView());
+
+	for (auto const & result : results)
+	{
+		LOG_INFO(TAG, "%-20s %2u lanes %10.1f Mlanes/s  x%.2f",
+				 result.kernel.name, result.kernel.lanes, result.LanesPerSecond() / 1e6, result.speedup);
+	}
+
+	// what every step of the precision ladder costs with the best kernel it has
+	Render::Precision const ladder[] =
+	{
+		Render::Precision::FLOAT, Render::Precision::DOUBLE, Render::Precision::DOUBLE_DOUBLE, Render::Precision::QUAD_DOUBLE
+	};
+
+	double fastest = 0.;
+
+	for (auto precision : ladder)
+	{
+		double best = 0.;
+
+		for (auto const & result : results)
+		{
+			if (result.kernel.precision == precision)
+				best = std::max(best, result.LanesPerSecond());
+		}
+
+		fastest = std::max(fastest, best);
+
+		LOG_INFO(TAG, "%-14s %10.1f Miterations/s, %6.1fx slower than float",
+				 Render::ToString(precision), best / 1e6, best > 0. ? fastest / best : 0.);
+	}
+
+	LOG_INFO(TAG, "The current view needs %s", Render::ToString(Render::FitPrecision(GetView())));
+
+	LOG_INFO(TAG, "Benchmarking fixed point squaring for deep-zoom reference orbits");
+
+	for (auto const & result : Render::BenchmarkSquarings())
+	{
+		LOG_INFO(TAG, "%4u bits %10.0f ns per squaring, x%.2f over the schoolbook product",
+				 result.bits, result.NanosecondsPerSquaring(), result.Speedup());
+	}
+
+	LOG_INFO(TAG, "Benchmarking the log buffer fan-out to discarding sinks");
+
+	for (auto const & result : Log::BenchmarkLogBuffer())
+	{
+		LOG_INFO(TAG, "%u sinks %4u chars %8.1f ns per message, %6.3f ns per char and sink",
+				 result.sinks, result.length, result.NanosecondsPerMessage(), result.NanosecondsPerCharacter());
+	}
+}
+
+void FractalGenerator::RunSubdivisionCheck()
+{
+	LOG_INFO(TAG, "Comparing Mariani-Silver subdivision against brute force");
+
+	for (auto const & result : Render::CheckSubdivision(m_viewport, m_renderOptions))
+	{
+		LOG_INFO(TAG, "%-22s %6llu mismatching pixels, %5.1f%% filled, x%.2f",
+				 result.name, result.mismatches, 100. * double(result.filled) / double(result.pixels), result.Speedup());
+	}
+}
+
+void FractalGenerator::RunPanCheck()
+{
+	LOG_INFO(TAG, "Comparing panned frames against full frames");
+
+	for (auto const & result : Render::CheckPanning(m_renderOptions))
+	{
+		LOG_INFO(TAG, "%-18s %6llu mismatching pixels, %5.1f%% reused",
+				 result.name, result.mismatches, 100. * double(result.reused) / double(result.pixels));
+	}
+}
+
+void FractalGenerator::RunDeepCheck()
+{
+	LOG_INFO(TAG, "Comparing deep zoom perturbation against direct fixed point iteration");
+
+	for (auto const & result : Render::CheckDeepZoom(m_renderOptions))
+	{
+		LOG_INFO(TAG, "%-22s %6llu mismatching pixels, %2u references, %5llu pixels iterated alone, x%.2f",
+				 result.name, result.mismatches, result.references, result.ownOrbits, result.Speedup());
+	}
+}
+
+void FractalGenerator::RenderCpuFrame()
+{
+	CancelCpuFrame();
+
+	// the offset is a double, past what doubles resolve only perturbation can place the pixels
+	if (Render::FitPrecision(GetView()) > Render::Precision::DOUBLE)
+	{
+		RenderDeepFrame(Render::DeepView::FromView(GetView()));
+		return;
+	}
+
+	if (!m_cpuEngine)
+		m_cpuEngine.reset(new Render::FractalEngine(0u, m_renderOptions));
+
+	if (m_tileCache)
+	{
+		Render::IterationBuffer	iterations;
+		Render::ColorBuffer		colors;
+
+		Render::FractalView const view = GetView();
+
+		LogCpuFrame(view.canvas, m_cpuEngine->RenderCachedFrame(view, *m_tileCache, iterations, colors));
+		m_tileCache->SaveIndex();
+
+		return;
+	}
+
+	Render::FractalView const view = GetView();
+
+	m_cpuCancel = Render::CancellationToken();
+	m_cpuWorker = std::thread(
+		[this, view, token = m_cpuCancel]()
+		{
+			Render::RenderStats const stats = m_cpuEngine->RenderProgressiveFrame(view, m_cpuIterations, m_cpuColors, token,
+				[](Render::RenderStats const & progress)
+				{
+					LOG_DBG(TAG, "CPU frame pass %u done after %.2f ms", progress.passes, progress.Seconds() * 1e3);
+				});
+
+			if (stats.cancelled)
+			{
+				LOG_INFO(TAG, "CPU frame cancelled after %u passes, %.2f ms", stats.passes, stats.Seconds() * 1e3);
+				return;
+			}
+
+			m_firstImageTotal += stats.firstImage;
+			++m_progressiveFrames;
+
+			LOG_INFO(TAG, "Time to first image %.2f ms, %.2f ms on average over %u frames",
+					 std::chrono::duration<double, std::milli>(stats.firstImage).count(),
+					 std::chrono::duration<double, std::milli>(m_firstImageTotal).count() / m_progressiveFrames, m_progressiveFrames);
+
+			LogCpuFrame(view.canvas, stats);
+		});
+}
+
+void FractalGenerator::RenderDeepFrame(Render::DeepView const & view)
+{
+	CancelCpuFrame();
+
+	if (!m_cpuEngine)
+		m_cpuEngine.reset(new Render::FractalEngine(0u, m_renderOptions));
+
+	Render::IterationBuffer	iterations;
+	Render::ColorBuffer		colors;
+
+	Render::RenderStats const stats = m_cpuEngine->RenderDeepFrame(view, iterations, colors);
+
+	LOG_INFO(TAG, "Deep zoom 2^%.1f: %u references of %u bits in %.2f ms, %llu glitched pixels, %llu iterated alone",
+			 view.zoom.Log2(), stats.references, stats.referenceLimbs * 32u,
+			 std::chrono::duration<double, std::milli>(stats.referenceTime).count(), stats.glitchedPixels, stats.ownOrbits);
+
+	LOG_INFO(TAG, "Series approximation skipped %u iterations, %.1f%% of the total",
+			 stats.seriesSkip, 100. * double(stats.skippedIterations) / double(std::max<uint64>(1u, stats.iterations)));
+
+	LogCpuFrame(view.canvas, stats);
+}
+
+void FractalGenerator::ExportImage(math::vec2u size, std::string const & path)
+{
+	CancelCpuFrame();
+
+	if (!m_cpuEngine)
+		m_cpuEngine.reset(new Render::FractalEngine(0u, m_renderOptions));
+
+	Render::FractalView view = GetView();
+	view.canvas = size;
+
+	LOG_INFO(TAG, "Exporting %ux%u to \"%s\", %u rows per band", size.x, size.y, path.c_str(), Render::ExportBandHeight(size));
+
+	Render::ExportStats const stats = Render::ExportImage(*m_cpuEngine, view, path, Render::CancellationToken(),
+		[](Render::ExportStats const & progress)
+		{
+			LOG_INFO(TAG, "Band %u / %u written, %.1f Mpx/s, render %.1f MB/s, encode %.1f MB/s", progress.finished, progress.bands,
+					 progress.PixelsPerSecond() / 1e6, progress.RenderMegabytesPerSecond(), progress.encode.MegabytesPerSecond());
+		});
+
+	if (stats.failed)
+	{
+		LOG_ERR(TAG, "Export to \"%s\" failed after %u of %u bands", path.c_str(), stats.finished, stats.bands);
+		return;
+	}
+
+	LOG_INFO(TAG, "Exported %ux%u in %.1f s, %u bands resumed from an earlier run, %llu MB per band in memory",
+			 size.x, size.y, stats.Seconds(), stats.resumed, stats.bandBytes >> 20u);
+
+	LOG_INFO(TAG, "Render %.1f MB/s over %.1f s", stats.RenderMegabytesPerSecond(), std::chrono::duration<double>(stats.render).count());
+
+	if (stats.encode.threads)
+		LOG_INFO(TAG, "Encode %.1f MB/s per thread on %u threads, %.1f s waiting on the encoder, %llu MB of %llu MB after compression",
+				 stats.encode.MegabytesPerSecond(), stats.encode.threads, std::chrono::duration<double>(stats.encode.stalled).count(),
+				 stats.encode.fileBytes >> 20u, stats.imageBytes >> 20u);
+}
+
+void FractalGenerator::ExportIterations(math::vec2u size, std::string const & path)
+{
+	CancelCpuFrame();
+
+	if (!m_cpuEngine)
+		m_cpuEngine.reset(new Render::FractalEngine(0u, m_renderOptions));
+
+	Render::FractalView view = GetView();
+	view.canvas = size;
+
+	LOG_INFO(TAG, "Exporting the iterations of %ux%u to \"%s\", %u px tiles", size.x, size.y, path.c_str(), Render::ITERATION_TILE_SIZE);
+
+	Render::ExportStats const stats = Render::ExportIterations(*m_cpuEngine, view, path, true, Render::CancellationToken(),
+		[](Render::ExportStats const & progress)
+		{
+			LOG_INFO(TAG, "Band %u / %u written, %.1f Mpx/s", progress.finished, progress.bands, progress.PixelsPerSecond() / 1e6);
+		});
+
+	if (stats.failed)
+	{
+		LOG_ERR(TAG, "Iteration export to \"%s\" failed after %u of %u bands", path.c_str(), stats.finished, stats.bands);
+		return;
+	}
+
+	LOG_INFO(TAG, "Exported the iterations of %ux%u in %.1f s, render %.1f MB/s", size.x, size.y, stats.Seconds(), stats.RenderMegabytesPerSecond());
+}
+
+void FractalGenerator::RenderDeepFrame(math::vec2<Render::DeepReal> center, Render::DeepZoom zoom)
+{
+	Render::FractalView const	view	= GetView();
+	Render::DeepZoom const		deepest	= Render::DeepZoom::Deepest(view.canvas.y);
+
+	if (zoom.Log2() < deepest.Log2())
+	{
+		LOG_WARN(TAG, "Zoom 2^%.1f is past the 2^%.1f deep zoom resolves at %u rows, rendering that instead",
+				 zoom.Log2(), deepest.Log2(), view.canvas.y);
+		zoom = deepest;
+	}
+
+	RenderDeepFrame(Render::DeepView::FromCenter(view, center, zoom));
+}
+
+void FractalGenerator::RenderAnimation(math::vec2<Render::DeepReal> center, Render::DeepZoom endZoom, math::vec2u size,
+									   uint32 frames, std::string const & output)
+{
+	CancelCpuFrame();
+
+	if (!m_cpuEngine)
+		m_cpuEngine.reset(new Render::FractalEngine(0u, m_renderOptions));
+
+	Render::AnimationSettings settings;
+	settings.view		= GetView();
+	settings.center		= center;
+	settings.startZoom	= Render::DeepZoom::FromDouble(settings.view.zoom);
+	settings.endZoom	= endZoom;
+	settings.frameSize	= size;
+	settings.frames		= frames;
+	settings.output		= output;
+
+	// keyframes are rendered larger than the frames, their rows set how deep it can go
+	Render::DeepZoom const deepest = Render::DeepZoom::Deepest(uint32(std::ceil(double(size.y) * settings.keyframeScale)));
+
+	if (endZoom.Log2() < deepest.Log2())
+	{
+		LOG_WARN(TAG, "Animation end zoom 2^%.1f is past the 2^%.1f deep zoom resolves for %u rows, stopping there",
+				 endZoom.Log2(), deepest.Log2(), size.y);
+		settings.endZoom = deepest;
+	}
+
+	LOG_INFO(TAG, "Animating %u frames of %ux%u from zoom 2^%.1f to 2^%.1f into \"%s\"", frames, size.x, size.y,
+			 settings.startZoom.Log2(), settings.endZoom.Log2(), output.c_str());
+
+	Render::AnimationStats const stats = Render::RenderZoomAnimation(*m_cpuEngine, settings, Render::CancellationToken(),
+		[](Render::AnimationStats const & progress)
+		{
+			LOG_DBG(TAG, "Frame %u written, %u keyframes so far", progress.frames, progress.keyframes);
+		});
+
+	if (stats.failed)
+	{
+		LOG_ERR(TAG, "Animation to \"%s\" failed after %u of %u frames", output.c_str(), stats.frames, frames);
+		return;
+	}
+
+	LOG_INFO(TAG, "Animated %u frames in %.1f s, %.1f fps, from %u keyframes (%.1fx fewer full renders, %.1fx the pixels)",
+			 stats.frames, stats.Seconds(), stats.FramesPerSecond(), stats.keyframes, stats.RenderReduction(),
+			 double(stats.keyframePixels) / double(std::max<uint64>(1u, stats.framePixels)));
+
+	LOG_INFO(TAG, "Keyframes %.1f s, resampling %.1f s, writing %.1f s", std::chrono::duration<double>(stats.render).count(),
+			 std::chrono::duration<double>(stats.resample).count(), std::chrono::duration<double>(stats.write).count());
+}
+
+void FractalGenerator::RenderJuliaAtlas(math::vec2u grid, uint32 size, std::string const & path)
+{
+	CancelCpuFrame();
+
+	if (!m_cpuEngine)
+		m_cpuEngine.reset(new Render::FractalEngine(0u, m_renderOptions));
+
+	// every thumbnail frames the whole set, the iterations and colours are the current ones
+	Render::FractalView view = GetView();
+	view.canvas	= { size, size };
+	view.zoom	= 3.2;
+	view.offset	= { -1.6, -1.6 };
+
+	std::vector<math::vec2f> const constants = Render::JuliaGrid({ -1.6f, -1.1f }, { .5f, 1.1f }, grid);
+
+	LOG_INFO(TAG, "Rendering a %ux%u atlas of %u px Julia sets into \"%s\"", grid.x, grid.y, size, path.c_str());
+
+	Render::RenderStats stats;
+
+	if (!Render::RenderJuliaAtlas(*m_cpuEngine, view, constants, grid.x, path, stats))
+	{
+		LOG_ERR(TAG, "Could not write the Julia atlas to \"%s\"", path.c_str());
+		return;
+	}
+
+	LOG_INFO(TAG, "%u Julia sets in %.2f s, %.1f Mpx/s, %s, load balance %.2f", uint32(constants.size()),
+			 stats.Seconds(), stats.PixelsPerSecond() / 1e6, stats.kernel, stats.LoadBalance());
+}
+
+void FractalGenerator::CancelCpuFrame()
+{
+	m_cpuCancel.Cancel();
+
+	if (m_cpuWorker.joinable())
+		m_cpuWorker.join();
+}
+
+void FractalGenerator::LogCpuFrame(math::vec2u size, Render::RenderStats const & stats) const
+{
+	LOG_INFO(TAG, "CPU frame %ux%u: %.2f ms, %.1f Mpx/s, %s, %u threads, load balance %.2f, %llu pixels filled",
+			 size.x, size.y, stats.Seconds() * 1e3, stats.PixelsPerSecond() / 1e6,
+			 stats.kernel, stats.threads, stats.LoadBalance(), stats.filled);
+
+	if (stats.iterationsSaved)
+	{
+		LOG_INFO(TAG, "%llu iterations run, %llu iterations saved by the interior checks (%.1f%%)",
+				 stats.iterations, stats.iterationsSaved,
+				 100. * double(stats.iterationsSaved) / double(stats.iterations + stats.iterationsSaved));
+	}
+
+	if (stats.reused)
+		LOG_INFO(TAG, "Panned, %.1f%% of the pixels reused", 100. * double(stats.reused) / double(stats.pixels));
+
+	if (stats.cacheHits || stats.cacheMisses)
+	{
+		LOG_INFO(TAG, "Tile cache: %llu hits, %llu misses this frame, %llu / %llu MB used, %llu evictions so far",
+				 stats.cacheHits, stats.cacheMisses, m_tileCache->GetSize() >> 20u, m_tileCache->GetCapacity() >> 20u,
+				 m_tileCache->GetEvictions());
+	}
+
+	if (stats.tiles.empty())
+		return;
+
+	auto const slowest = std::max_element(stats.tiles.begin(), stats.tiles.end(),
+		[](Render::TileTiming const & a, Render::TileTiming const & b) { return a.elapsed < b.elapsed; });
+
+	LOG_INFO(TAG, "%u tiles, %llu steals, slowest tile (%u, %u) on worker %u: %.3f ms, %llu iterations",
+			 uint32(stats.tiles.size()), stats.steals, slowest->tile.x, slowest->tile.y, slowest->worker,
+			 std::chrono::duration<double, std::milli>(slowest->elapsed).count(), slowest->iterations);
+}
+
 void FractalGenerator::UpdateViewport()
 {
+	CancelCpuFrame();
+
 	m_viewport = m_application->GetWindowSize();
 	glViewport(0, 0, m_viewport.x, m_viewport.y);
 
 	//LOG_DBG(TAG, "Viewport has changed %u : %u", m_viewport.x, m_viewport.y);
+
+	MarkDirty();
 }
 
 void FractalGenerator::ResetView()
@@ -164,11 +600,36 @@ void FractalGenerator::ResetView()
 	m_offset		= { DEF_OFF_X, DEF_OFF_Y };
 	m_colorModifier	= { 1.f, 1.f, 1.f };
 	m_maxIterations	= { DEF_ITER };
+
+	CancelCpuFrame();
+	MarkDirty();
 }
 
 void FractalGenerator::SetMaxIterations(uint32 maxIter)
 {
 	m_maxIterations = maxIter;
+
+	CancelCpuFrame();
+	MarkDirty();
+}
+
+void FractalGenerator::SetRenderOptions(Render::RenderOptions const & options)
+{
+	CancelCpuFrame();
+
+	m_renderOptions = options;
+
+	if (m_cpuEngine)
+		m_cpuEngine->SetOptions(options);
+}
+
+void FractalGenerator::SetTileCache(std::string const & directory)
+{
+	CancelCpuFrame();
+
+	m_tileCache.reset(new Render::TileCache(directory));
+
+	LOG_INFO(TAG, "Tile cache in \"%s\", %llu MB", directory.c_str(), m_tileCache->GetSize() >> 20u);
 }
 
 void FractalGenerator::SetFractalType(FractalType fractal)
@@ -181,6 +642,9 @@ void FractalGenerator::SetFractalType(FractalType fractal)
 	}
 
 	m_fractal = fractal;
+
+	CancelCpuFrame();
+	MarkDirty();
 }
 
 void FractalGenerator::SetOffsetX(float value, bool isOffset)
@@ -190,6 +654,9 @@ void FractalGenerator::SetOffsetX(float value, bool isOffset)
 	isOffset ?
 		m_offset.x += value :
 		m_offset.x  = value;
+
+	CancelCpuFrame();
+	MarkDirty();
 }
 
 void FractalGenerator::SetOffsetY(float value, bool isOffset)
@@ -199,8 +666,29 @@ void FractalGenerator::SetOffsetY(float value, bool isOffset)
 	isOffset ?
 		m_offset.y += value :
 		m_offset.y  = value;
+
+	CancelCpuFrame();
+	MarkDirty();
 }
 
+void FractalGenerator::Pan(math::vec2f delta)
+{
+	double const pixelSpan = m_zoom / double(std::max(1u, m_viewport.y));
+
+	auto WholePixels = [pixelSpan](double value)
+	{
+		double const pixels = std::round(value / pixelSpan);
+		return value != 0. && pixels == 0. ? std::copysign(1., value) : pixels;
+	};
+
+	m_offset.x += WholePixels(delta.x) * pixelSpan;
+	m_offset.y += WholePixels(delta.y) * pixelSpan;
+
+	LOG_INFO(TAG, "Offset changed: %f : %f", m_offset.x, m_offset.y);
+
+	CancelCpuFrame();
+	MarkDirty();
+}
 
 void FractalGenerator::SetZoom(float value, bool isOffset)
 {
@@ -212,6 +700,9 @@ void FractalGenerator::SetZoom(float value, bool isOffset)
 	isOffset ?
 		m_zoom += value :
 		m_zoom  = value ;
+
+	CancelCpuFrame();
+	MarkDirty();
 }
 
 void FractalGenerator::SetRedModifier(float value, bool isOffset)
@@ -219,6 +710,8 @@ void FractalGenerator::SetRedModifier(float value, bool isOffset)
 	isOffset ?
 		m_colorModifier.r += value :
 		m_colorModifier.r  = value ;
+
+	MarkDirty();
 }
 
 void FractalGenerator::SetGreenModifier(float value, bool isOffset)
@@ -226,6 +719,8 @@ void FractalGenerator::SetGreenModifier(float value, bool isOffset)
 	isOffset ?
 		m_colorModifier.g += value :
 		m_colorModifier.g  = value ;
+
+	MarkDirty();
 }
 
 void FractalGenerator::SetBlueModifier(float value, bool isOffset)
@@ -233,6 +728,22 @@ void FractalGenerator::SetBlueModifier(float value, bool isOffset)
 	isOffset ?
 		m_colorModifier.b += value :
 		m_colorModifier.b  = value ;
+
+	MarkDirty();
+}
+
+Render::FractalView FractalGenerator::GetView() const
+{
+	Render::FractalView view;
+	view.zoom			= m_zoom;
+	view.offset			= m_offset;
+	view.canvas			= m_viewport;
+	view.maxIterations	= m_maxIterations;
+	view.fractal		= m_fractal;
+	view.juliaConstant	= m_juliaConstant;
+	view.colorModifier	= m_colorModifier;
+
+	return view;
 }
 
 LRESULT FractalControls::ControlProc(HWND handle, UINT msg, WPARAM wparam, LPARAM lparam)
@@ -314,7 +825,7 @@ bool FractalControls::CreateControlWindow()
 	
 	if (!registrationSucceded)
 	{
-		LOG_ERR("Failed to register window class: %s", m_className.c_str());
+		LOG_ERR(TAG, "Failed to register window class: %s", m_className.c_str());
 		return false;
 	}
 
@@ -337,7 +848,7 @@ bool FractalControls::CreateControlWindow()
 
 	if (!m_windowHandle)
 	{
-		LOG_ERR("Failed to create window: %s, of type %s", WIN_TITLE, m_className.c_str());
+		LOG_ERR(TAG, "Failed to create window: %s, of type %s", WIN_TITLE, m_className.c_str());
 		return false;
 	}
 	
@@ -1,15 +1,20 @@
 #include <App\WinapiApp.h>
+#include <App\LogBenchmark.hpp>
 #include <Graphics\Quad.hpp>
+#include <Graphics\FrameBuffer.hpp>
+#include <Graphics\UniformBuffer.hpp>
+#include <Render\FractalEngine.hpp>
+#include <Render\KernelBenchmark.hpp>
+#include <Render\SubdivisionCheck.hpp>
+#include <Render\PanCheck.hpp>
+#include <Render\DeepCheck.hpp>
+#include <Render\ImageExport.hpp>
+#include <Render\IterationFile.hpp>
+#include <Render\ZoomAnimation.hpp>
+#include <Render\JuliaSweep.hpp>
 
 #define CLASS_CSTEXPR static constexpr auto
 
-enum class FractalType:
-	byte
-{
-	MANDELBROT = 0,
-	JULIA
-};
-
 class FractalGenerator;
 class FractalControls;
 
@@ -36,6 +41,8 @@ class FractalGenerator:
 
 	static constexpr math::vec2f DEF_JULIA = { 0.285f, 0.01f };
 
+	static constexpr uint32 VIEW_BLOCK_BINDING = 0u;
+
 	FractalCtrlPtr m_controlWindow;
 
 	FractalGenerator(HINSTANCE instance, WNDPROC proc);
@@ -43,50 +50,112 @@ class FractalGenerator:
 	std::unique_ptr<WinapiApp> m_application;
 
 	cstring			m_name				{ "Fractal Generator" };
-	float			m_zoom				{ DEF_ZOOM };
-	math::vec2f		m_offset			{ DEF_OFF_X, DEF_OFF_Y };
+	double			m_zoom				{ DEF_ZOOM };
+	math::vec2d		m_offset			{ DEF_OFF_X, DEF_OFF_Y };
 	math::vec3f		m_colorModifier		{1.f};
 	uint32			m_maxIterations		{ DEF_ITER };
 	FractalType		m_fractal			{FractalType::MANDELBROT};
 	math::vec2f		m_juliaConstant		{DEF_JULIA};
 
+	Render::RenderOptions					m_renderOptions;
+	std::unique_ptr<Render::FractalEngine>	m_cpuEngine;
+	std::unique_ptr<Render::TileCache>		m_tileCache;	// F2 frames go through it once enabled
+
+	// last F2 frame, panning by whole pixels only renders what gets exposed
+	Render::IterationBuffer	m_cpuIterations;
+	Render::ColorBuffer		m_cpuColors;
+
+	// F2 frames refine progressively off the UI thread, changing the view cancels them
+	std::thread					m_cpuWorker;
+	Render::CancellationToken	m_cpuCancel;
+	Misc::clock::duration		m_firstImageTotal	{0};
+	uint32						m_progressiveFrames	{0u};
+
 	math::vec2u		m_viewport;
 	math::vec4f		m_clearColor{1.f, 0.f, 0.f, 1.f};
 
 
 	Graphics::QuadPtr			m_screenCanvas;
-	Graphics::ShaderProgramPtr	m_fractalShader;
+	Graphics::ShaderProgramPtr	m_fractalShader;	// iteration pass into m_escapeTarget
+	Graphics::ShaderProgramPtr	m_coloringShader;	// colouring pass from m_escapeTarget to the screen
+	Graphics::FrameBufferPtr	m_escapeTarget;		// iteration count and smooth iteration per pixel
+
+	Render::FractalView			m_escapeView;		// view m_escapeTarget was last rendered with
+	bool						m_hasEscape			{false};
+
+	// the ViewBlock of both passes, written whenever the view changed
+	Graphics::UniformBufferPtr	m_viewBuffer;
+	Render::ViewUniforms		m_viewUniforms;			// as last written
+	bool						m_hasViewUniforms	{false};
+
+	Graphics::UniformHandle<int32>	m_escapeUniform;
+
+	Graphics::UniformUploads	m_frameUploads;			// of the last frame drawn
+	uint64						m_skippedUploads	{0u};	// since the start
 
 	bool CreateApplication(HINSTANCE instance, WNDPROC proc);
 	bool InitializeGraphics();
 
+	static Graphics::ShaderProgramPtr LoadProgram(cstring vertexFile, cstring fragmentFile);
+
 	void SetLoop();
+	void CancelCpuFrame();
+	// size is the frame's own, the progressive frame logs from its worker thread
+	void LogCpuFrame(math::vec2u size, Render::RenderStats const & stats) const;
 
 	void Draw();
 	void Flush();
 
 	public:
 
+		~FractalGenerator();
+
 		static bool				IsInitialized();
 
 		static bool				Init(HINSTANCE instance, WNDPROC proc);
 		static FractalGenPtr&	GetInstance();
 
 		void Run();
+		void RunBenchmark();
+		void RunSubdivisionCheck();
+		void RunPanCheck();
+		void RunDeepCheck();
+		void RenderCpuFrame();
+		void RenderDeepFrame(Render::DeepView const & view);
+		// centred on center, zooms past what DeepReal resolves are clamped with a warning
+		void RenderDeepFrame(math::vec2<Render::DeepReal> center, Render::DeepZoom zoom);
+		// renders the current view at any size into a PPM, resuming an interrupted export of the same view
+		void ExportImage(math::vec2u size, std::string const & path);
+		// the raw iterations of the current view at any size, for tools reading them with IterationFileReader
+		void ExportIterations(math::vec2u size, std::string const & path);
+		// zooms from the current view down to endZoom around center, see Render::RenderZoomAnimation
+		void RenderAnimation(math::vec2<Render::DeepReal> center, Render::DeepZoom endZoom, math::vec2u size, uint32 frames, std::string const & output);
+		// grid.x * grid.y Julia sets of size x size for constants across the Mandelbrot set, in one sweep
+		void RenderJuliaAtlas(math::vec2u grid, uint32 size, std::string const & path);
 		void UpdateViewport();
+		// asks the main loop for a frame, every setter below calls it
+		void MarkDirty();
+		void LogFrameCounters() const;
 
 		void ResetView();
 
 		void SetMaxIterations	(uint32 maxIter);
+		void SetRenderOptions	(Render::RenderOptions const & options);
+		void SetTileCache		(std::string const & directory);
 		void SetFractalType		(FractalType fractal);
 
 		void SetOffsetX(float value, bool isOffset = false);
 		void SetOffsetY(float value, bool isOffset = false);
 
+		// moves the offset by delta rounded to whole pixels, at least one along a non zero axis
+		void Pan(math::vec2f delta);
+
 		void SetZoom			(float value,	bool isOffset = false);
 		void SetRedModifier		(float value,	bool isOffset = false);
 		void SetGreenModifier	(float value,	bool isOffset = false);
 		void SetBlueModifier	(float value,	bool isOffset = false);
+
+		Render::FractalView GetView() const;
 };
 
 class FractalControls:
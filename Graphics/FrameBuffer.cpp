@@ -0,0 +1,78 @@
+#include "FrameBuffer.hpp"
+
+Graphics::FrameBuffer::FrameBuffer(GLenum internalFormat, GLenum format, GLenum type):
+	m_internalFormat(internalFormat),
+	m_format(format),
+	m_type(type)
+{
+	glGenFramebuffers(1, &m_frameBuffer);
+	glGenTextures(1, &m_texture);
+
+	glBindTexture(GL_TEXTURE_2D, m_texture);
+
+	// texels are fetched one to one, never filtered
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	PrintOpenGLErrors();
+}
+
+Graphics::FrameBuffer::~FrameBuffer()
+{
+	glDeleteFramebuffers(1, &m_frameBuffer);
+	glDeleteTextures(1, &m_texture);
+}
+
+bool Graphics::FrameBuffer::Resize(math::vec2u size)
+{
+	if (size.x == m_size.x && size.y == m_size.y)
+		return true;
+
+	m_size = size;
+
+	glBindTexture(GL_TEXTURE_2D, m_texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, m_internalFormat, size.x, size.y, 0, m_format, m_type, nullptr);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_frameBuffer);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_texture, 0);
+
+	GLenum const status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	PrintOpenGLErrors();
+
+	if (status != GL_FRAMEBUFFER_COMPLETE)
+	{
+		LOG_ERR(TAG, "Incomplete framebuffer %u x %u, status 0x%X", size.x, size.y, status);
+		return false;
+	}
+
+	return true;
+}
+
+void Graphics::FrameBuffer::Bind()
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, m_frameBuffer);
+	glViewport(0, 0, m_size.x, m_size.y);
+}
+
+void Graphics::FrameBuffer::Unbind()
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void Graphics::FrameBuffer::BindTexture(uint32 unit)
+{
+	glActiveTexture(GL_TEXTURE0 + unit);
+	glBindTexture(GL_TEXTURE_2D, m_texture);
+}
+
+math::vec2u Graphics::FrameBuffer::GetSize() const
+{
+	return m_size;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "OpenGL_Util.hpp"
+
+namespace Graphics
+{
+	class FrameBuffer;
+	typedef std::shared_ptr<FrameBuffer> FrameBufferPtr;
+
+	// Off-screen target with a single colour texture, sampled back by a later pass
+	class FrameBuffer:
+		public Misc::Noncopyable
+	{
+		static constexpr auto TAG = "OpenGL";
+
+		GpuHandleID	m_frameBuffer	{INVALID_HANDLE};
+		GpuHandleID	m_texture		{INVALID_HANDLE};
+
+		GLenum		m_internalFormat;
+		GLenum		m_format;
+		GLenum		m_type;
+
+		math::vec2u	m_size			{0u, 0u};
+
+		public:
+
+			static constexpr GpuHandleID INVALID_HANDLE = 0u;
+
+			FrameBuffer(GLenum internalFormat, GLenum format, GLenum type);
+			~FrameBuffer();
+
+			// reallocates the texture when the size changed, its content is undefined then
+			bool Resize(math::vec2u size);
+
+			// renders into the texture, the viewport covers all of it
+			void Bind();
+			void Unbind();
+
+			void BindTexture(uint32 unit);
+
+			math::vec2u GetSize() const;
+	};
+}
@@ -1,21 +1,23 @@
 #include "Shader.hpp"
 
-bool Graphics::ShaderProgram::HasUniform(cstring name, ValueType type)
+bool Graphics::ShaderProgram::FindUniform(cstring name, ValueType type, uint32 & slot)
 {
-	hash_map<Uniform>::iterator uniform = m_uniforms.find(name);
+	hash_map<uint32>::iterator uniform = m_uniformSlots.find(name);
 
-	if (uniform == m_uniforms.end())
+	if (uniform == m_uniformSlots.end())
 	{
 		LOG_WARN(TAG, "Unknown uniform!");
 		return false;
 	}
 
-	if (uniform->second.type != type)
+	if (m_uniforms[uniform->second].type != type)
 	{
 		LOG_WARN(TAG, "Invalid uniform type");
 		return false;
 	}
 
+	slot = uniform->second;
+
 	return true;
 }
 
@@ -31,7 +33,7 @@ Graphics::ShaderProgram::~ShaderProgram()
 
 bool Graphics::ShaderProgram::RegisterUniform(cstring name, ValueType type, uint32_t lenght)
 {
-	if (m_uniforms.find(name) != m_uniforms.end())
+	if (m_uniformSlots.find(name) != m_uniformSlots.end())
 	{
 		LOG_WARN(TAG, "An uniform with the name \"%s\" already exists!", name);
 		return false;
@@ -42,7 +44,46 @@ bool Graphics::ShaderProgram::RegisterUniform(cstring name, ValueType type, uint
 	newUniform.type = type;
 	newUniform.lenght = lenght;
 	newUniform.handle = glGetUniformLocation(m_program, name);
-	m_uniforms[name] = newUniform;
+
+	m_uniformSlots[name] = uint32(m_uniforms.size());
+	m_uniforms.push_back(newUniform);
+
+	PrintOpenGLErrors();
+	return true;
+}
+
+bool Graphics::ShaderProgram::RegisterUniformBlock(cstring name, uint32 binding, size_t size)
+{
+	if (m_uniformBlocks.find(name) != m_uniformBlocks.end())
+	{
+		LOG_WARN(TAG, "An uniform block with the name \"%s\" already exists!", name);
+		return false;
+	}
+
+	UniformBlock newBlock;
+	newBlock.name		= name;
+	newBlock.binding	= binding;
+	newBlock.index		= glGetUniformBlockIndex(m_program, name);
+
+	if (newBlock.index == GL_INVALID_INDEX)
+	{
+		LOG_WARN(TAG, "Unknown uniform block \"%s\"", name);
+		return false;
+	}
+
+	GLint blockSize = 0;
+	glGetActiveUniformBlockiv(m_program, newBlock.index, GL_UNIFORM_BLOCK_DATA_SIZE, &blockSize);
+
+	newBlock.size = uint32(blockSize);
+
+	if (newBlock.size != size)
+	{
+		LOG_ERR(TAG, "Uniform block \"%s\" is %u bytes, its CPU side layout %u", name, newBlock.size, uint32(size));
+		return false;
+	}
+
+	glUniformBlockBinding(m_program, newBlock.index, binding);
+	m_uniformBlocks[name] = newBlock;
 
 	PrintOpenGLErrors();
 	return true;
@@ -149,86 +190,192 @@ void Graphics::ShaderProgram::operator()()
 
 void Graphics::ShaderProgram::SetUniformBool(cstring name, bool value)
 {
-	if (HasUniform(name, ValueType::BOOL))
-	 glUniform1i(m_uniforms[name].handle, value);
+	uint32 slot;
+
+	if (FindUniform(name, ValueType::BOOL, slot))
+		Upload(slot, value);
 }
 
 void Graphics::ShaderProgram::SetUniformInt(cstring name, int32 value)
 {
-	if (HasUniform(name, ValueType::INT))
-	 glUniform1i(m_uniforms[name].handle, value);
+	uint32 slot;
+
+	if (FindUniform(name, ValueType::INT, slot))
+		Upload(slot, value);
 }
 
 void Graphics::ShaderProgram::SetUniformUint(cstring name, uint32 value)
 {
-	if (HasUniform(name, ValueType::UINT))
-	 glUniform1ui(m_uniforms[name].handle, value);
+	uint32 slot;
+
+	if (FindUniform(name, ValueType::UINT, slot))
+		Upload(slot, value);
 }
 
 void Graphics::ShaderProgram::SetUniformFloat(cstring name, float value)
 {
-	if (HasUniform(name, ValueType::FLOAT))
-	 glUniform1f(m_uniforms[name].handle, value);
+	uint32 slot;
+
+	if (FindUniform(name, ValueType::FLOAT, slot))
+		Upload(slot, value);
 }
 
 void Graphics::ShaderProgram::SetUniformDouble(cstring name, double value)
 {
-	if (HasUniform(name, ValueType::DOUBLE)) return;
-	else glUniform1d(m_uniforms[name].handle, value);
+	uint32 slot;
+
+	if (FindUniform(name, ValueType::DOUBLE, slot))
+		Upload(slot, value);
 }
 
 void Graphics::ShaderProgram::SetUniform2i(cstring name, math::vec2i value)
 {
-	if (HasUniform(name, ValueType::VEC2I))
-	glUniform2i(m_uniforms[name].handle, value.x, value.y);
+	uint32 slot;
+
+	if (FindUniform(name, ValueType::VEC2I, slot))
+		Upload(slot, value);
 }
 
 void Graphics::ShaderProgram::SetUniform3i(cstring name, math::vec3i value)
 {
-	if (HasUniform(name, ValueType::VEC3I))
-	glUniform3i(m_uniforms[name].handle, value.x, value.y, value.z);
+	uint32 slot;
+
+	if (FindUniform(name, ValueType::VEC3I, slot))
+		Upload(slot, value);
 }
 
 void Graphics::ShaderProgram::SetUniform4i(cstring name, math::vec4i value)
 {
-	if (HasUniform(name, ValueType::VEC4I))
-	 glUniform4i(m_uniforms[name].handle, value.x, value.y, value.z, value.w);
+	uint32 slot;
+
+	if (FindUniform(name, ValueType::VEC4I, slot))
+		Upload(slot, value);
 }
 
 void Graphics::ShaderProgram::SetUniform2u(cstring name, math::vec2u value)
 {
-	if (HasUniform(name, ValueType::VEC2U))
-	 glUniform2ui(m_uniforms[name].handle, value.x, value.y);
+	uint32 slot;
+
+	if (FindUniform(name, ValueType::VEC2U, slot))
+		Upload(slot, value);
 }
 
 void Graphics::ShaderProgram::SetUniform3u(cstring name, math::vec3u value)
 {
-	if (HasUniform(name, ValueType::VEC3U))
-	 glUniform3ui(m_uniforms[name].handle, value.x, value.y, value.z);
+	uint32 slot;
+
+	if (FindUniform(name, ValueType::VEC3U, slot))
+		Upload(slot, value);
 }
 
 void Graphics::ShaderProgram::SetUniform4u(cstring name, math::vec4u value)
 {
-	if (HasUniform(name, ValueType::VEC4U))
-	 glUniform4ui(m_uniforms[name].handle, value.x, value.y, value.z, value.w);
+	uint32 slot;
+
+	if (FindUniform(name, ValueType::VEC4U, slot))
+		Upload(slot, value);
 }
 
 void Graphics::ShaderProgram::SetUniform2f(cstring name, math::vec2f value)
 {
-	if (HasUniform(name, ValueType::VEC2F))
-		glUniform2f(m_uniforms[name].handle, value.x, value.y);
+	uint32 slot;
+
+	if (FindUniform(name, ValueType::VEC2F, slot))
+		Upload(slot, value);
 }
 
 void Graphics::ShaderProgram::SetUniform3f(cstring name, math::vec3f value)
 {
-	if (HasUniform(name, ValueType::VEC3F))
-		glUniform3f(m_uniforms[name].handle, value.x, value.y, value.z);
+	uint32 slot;
+
+	if (FindUniform(name, ValueType::VEC3F, slot))
+		Upload(slot, value);
 }
 
 void Graphics::ShaderProgram::SetUniform4f(cstring name, math::vec4f value)
 {
-	if (HasUniform(name, ValueType::VEC4F))
-		glUniform4f(m_uniforms[name].handle, value.x, value.y, value.z, value.w);
+	uint32 slot;
+
+	if (FindUniform(name, ValueType::VEC4F, slot))
+		Upload(slot, value);
+}
+
+Graphics::UniformUploads Graphics::ShaderProgram::TakeUniformUploads()
+{
+	UniformUploads const uploads = m_uploads;
+	m_uploads = UniformUploads();
+
+	return uploads;
+}
+
+void Graphics::UploadUniform(GLint location, bool value)
+{
+	glUniform1i(location, value);
+}
+
+void Graphics::UploadUniform(GLint location, int32 value)
+{
+	glUniform1i(location, value);
+}
+
+void Graphics::UploadUniform(GLint location, uint32 value)
+{
+	glUniform1ui(location, value);
+}
+
+void Graphics::UploadUniform(GLint location, float value)
+{
+	glUniform1f(location, value);
+}
+
+void Graphics::UploadUniform(GLint location, double value)
+{
+	glUniform1d(location, value);
+}
+
+void Graphics::UploadUniform(GLint location, math::vec2i value)
+{
+	glUniform2i(location, value.x, value.y);
+}
+
+void Graphics::UploadUniform(GLint location, math::vec3i value)
+{
+	glUniform3i(location, value.x, value.y, value.z);
+}
+
+void Graphics::UploadUniform(GLint location, math::vec4i value)
+{
+	glUniform4i(location, value.x, value.y, value.z, value.w);
+}
+
+void Graphics::UploadUniform(GLint location, math::vec2u value)
+{
+	glUniform2ui(location, value.x, value.y);
+}
+
+void Graphics::UploadUniform(GLint location, math::vec3u value)
+{
+	glUniform3ui(location, value.x, value.y, value.z);
+}
+
+void Graphics::UploadUniform(GLint location, math::vec4u value)
+{
+	glUniform4ui(location, value.x, value.y, value.z, value.w);
+}
+
+void Graphics::UploadUniform(GLint location, math::vec2f value)
+{
+	glUniform2f(location, value.x, value.y);
+}
+
+void Graphics::UploadUniform(GLint location, math::vec3f value)
+{
+	glUniform3f(location, value.x, value.y, value.z);
+}
+
+void Graphics::UploadUniform(GLint location, math::vec4f value)
+{
+	glUniform4f(location, value.x, value.y, value.z, value.w);
 }
 
 
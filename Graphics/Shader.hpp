@@ -38,10 +38,64 @@ namespace Graphics
 
 	struct Uniform
 	{
+		static constexpr size_t MAX_VALUE_SIZE = sizeof(math::vec4<double>);
+
 		GpuHandleID		handle;
 		ValueType		type;
 		uint32			lenght;
 		cstring			name;
+
+		std::array<byte, MAX_VALUE_SIZE>	value;					// as last uploaded
+		bool								isUploaded	{false};
+	};
+
+	// the ValueType a uniform handle of T is registered with
+	template<typename T>
+	struct UniformValueType;
+
+	template<> struct UniformValueType<bool>		{ static constexpr ValueType type = ValueType::BOOL;	};
+	template<> struct UniformValueType<int32>		{ static constexpr ValueType type = ValueType::INT;		};
+	template<> struct UniformValueType<uint32>		{ static constexpr ValueType type = ValueType::UINT;	};
+	template<> struct UniformValueType<float>		{ static constexpr ValueType type = ValueType::FLOAT;	};
+	template<> struct UniformValueType<double>		{ static constexpr ValueType type = ValueType::DOUBLE;	};
+	template<> struct UniformValueType<math::vec2i>	{ static constexpr ValueType type = ValueType::VEC2I;	};
+	template<> struct UniformValueType<math::vec3i>	{ static constexpr ValueType type = ValueType::VEC3I;	};
+	template<> struct UniformValueType<math::vec4i>	{ static constexpr ValueType type = ValueType::VEC4I;	};
+	template<> struct UniformValueType<math::vec2u>	{ static constexpr ValueType type = ValueType::VEC2U;	};
+	template<> struct UniformValueType<math::vec3u>	{ static constexpr ValueType type = ValueType::VEC3U;	};
+	template<> struct UniformValueType<math::vec4u>	{ static constexpr ValueType type = ValueType::VEC4U;	};
+	template<> struct UniformValueType<math::vec2f>	{ static constexpr ValueType type = ValueType::VEC2F;	};
+	template<> struct UniformValueType<math::vec3f>	{ static constexpr ValueType type = ValueType::VEC3F;	};
+	template<> struct UniformValueType<math::vec4f>	{ static constexpr ValueType type = ValueType::VEC4F;	};
+
+	// the glUniform* call for the type, to the program in use
+	void UploadUniform(GLint location, bool			value);
+	void UploadUniform(GLint location, int32		value);
+	void UploadUniform(GLint location, uint32		value);
+	void UploadUniform(GLint location, float		value);
+	void UploadUniform(GLint location, double		value);
+	void UploadUniform(GLint location, math::vec2i	value);
+	void UploadUniform(GLint location, math::vec3i	value);
+	void UploadUniform(GLint location, math::vec4i	value);
+	void UploadUniform(GLint location, math::vec2u	value);
+	void UploadUniform(GLint location, math::vec3u	value);
+	void UploadUniform(GLint location, math::vec4u	value);
+	void UploadUniform(GLint location, math::vec2f	value);
+	void UploadUniform(GLint location, math::vec3f	value);
+	void UploadUniform(GLint location, math::vec4f	value);
+
+	// glUniform calls made, and skipped because the program already had the value
+	struct UniformUploads
+	{
+		uint32	issued	{0u};
+		uint32	skipped	{0u};
+
+		UniformUploads inline & operator += (UniformUploads const & other)
+		{
+			issued	+= other.issued;
+			skipped	+= other.skipped;
+			return *this;
+		}
 	};
 
 	enum class SamplerType
@@ -52,6 +106,15 @@ namespace Graphics
 		SAMPLER_CUBE
 	};
 
+	// a std140 uniform block, read from the buffer bound to its binding point
+	struct UniformBlock
+	{
+		GLuint		index;
+		uint32		binding;
+		uint32		size;
+		cstring		name;
+	};
+
 	struct Sampler
 	{
 		uint32		id;
@@ -63,6 +126,33 @@ namespace Graphics
 	class ShaderStage;
 	class ShaderCode;
 
+	// A uniform looked up once, when it is registered. Setting it compares the value with
+	// the one last uploaded to the program and skips the glUniform call when they match.
+	// The program has to be in use, as for any glUniform call, and outlive the handle.
+	template<typename T>
+	class UniformHandle
+	{
+		friend class ShaderProgram;
+
+		ShaderProgram *	m_program	{nullptr};
+		uint32			m_slot		{0u};
+
+		UniformHandle(ShaderProgram * program, uint32 slot) :
+			m_program(program), m_slot(slot)
+		{
+		}
+
+	public:
+
+		UniformHandle() = default;
+
+		bool IsValid() const {
+			return m_program != nullptr;
+		}
+
+		void Set(T const & value) const;
+	};
+
 	typedef std::shared_ptr<ShaderProgram>	ShaderProgramPtr;
 	typedef std::shared_ptr<ShaderStage>	ShaderStagePtr;
 
@@ -125,7 +215,10 @@ namespace Graphics
 		ShaderType m_contents;
 		GpuHandleID  m_program;
 
-		hash_map<Uniform>		m_uniforms;
+		std::vector<Uniform>	m_uniforms;		// in the order they were registered, handles keep the index
+		hash_map<uint32>		m_uniformSlots;
+		UniformUploads			m_uploads;
+		hash_map<UniformBlock>	m_uniformBlocks;
 		std::vector<Sampler>	m_samplers;
 
 		std::array<ShaderStagePtr, MAX_STAGES>	m_stages;
@@ -133,14 +226,27 @@ namespace Graphics
 		bool m_hasLinked{ false };
 		bool m_hasDetached{ false };
 
-		bool HasUniform(cstring name, ValueType type);
+		bool FindUniform(cstring name, ValueType type, uint32 & slot);
+
+		template<typename T>
+		void Upload(uint32 slot, T const & value);
 
 	public:
 
+		template<typename T>
+		friend class UniformHandle;
+
 		ShaderProgram();
 		~ShaderProgram();
 
 		bool RegisterUniform(cstring name, ValueType type, uint32_t lenght = 1u);
+
+		// registers the uniform if it is not yet, the handle is invalid if it was with another type
+		template<typename T>
+		UniformHandle<T> RegisterUniform(cstring name, uint32_t lenght = 1u);
+
+		// reads the block from binding, size is the std140 size of the CPU side struct
+		bool RegisterUniformBlock(cstring name, uint32 binding, size_t size);
 		bool AddStage(ShaderStagePtr stage, ShaderType type);
 
 		bool IsCurrent();
@@ -172,5 +278,57 @@ namespace Graphics
 		void SetUniform2f(cstring name, math::vec2f value);
 		void SetUniform3f(cstring name, math::vec3f value);
 		void SetUniform4f(cstring name, math::vec4f value);
+
+		// counted since the last call, once per frame gives the uploads of a frame
+		UniformUploads TakeUniformUploads();
 	};
+
+	template<typename T>
+	inline UniformHandle<T> ShaderProgram::RegisterUniform(cstring name, uint32_t lenght)
+	{
+		auto found = m_uniformSlots.find(name);
+
+		if (found == m_uniformSlots.end())
+		{
+			if (!RegisterUniform(name, UniformValueType<T>::type, lenght))
+				return UniformHandle<T>();
+
+			found = m_uniformSlots.find(name);
+		}
+
+		if (m_uniforms[found->second].type != UniformValueType<T>::type)
+		{
+			LOG_WARN(TAG, "The uniform \"%s\" is registered with another type", name);
+			return UniformHandle<T>();
+		}
+
+		return UniformHandle<T>(this, found->second);
+	}
+
+	template<typename T>
+	inline void ShaderProgram::Upload(uint32 slot, T const & value)
+	{
+		static_assert(sizeof(T) <= Uniform::MAX_VALUE_SIZE, "uniform value too large to cache");
+
+		Uniform & uniform = m_uniforms[slot];
+
+		if (uniform.isUploaded && std::memcmp(uniform.value.data(), &value, sizeof(T)) == 0)
+		{
+			m_uploads.skipped++;
+			return;
+		}
+
+		std::memcpy(uniform.value.data(), &value, sizeof(T));
+		uniform.isUploaded = true;
+
+		UploadUniform(GLint(uniform.handle), value);
+		m_uploads.issued++;
+	}
+
+	template<typename T>
+	inline void UniformHandle<T>::Set(T const & value) const
+	{
+		if (m_program)
+			m_program->Upload(m_slot, value);
+	}
 }
@@ -0,0 +1,141 @@
+#include "UniformBuffer.hpp"
+
+namespace
+{
+	constexpr GLbitfield	PERSISTENT_FLAGS	= GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	constexpr GLuint64		FENCE_TIMEOUT		= 1000000000u;	// ns, waited again while it expires
+}
+
+Graphics::UniformBuffer::UniformBuffer(uint32 binding, size_t size):
+	m_binding(binding),
+	m_size(size)
+{
+	glGenBuffers(1, &m_buffer);
+
+	if (!CreatePersistent())
+	{
+		glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+		glBufferData(GL_UNIFORM_BUFFER, m_size, nullptr, GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+		glBindBufferBase(GL_UNIFORM_BUFFER, m_binding, m_buffer);
+	}
+
+	PrintOpenGLErrors();
+
+	LOG_DBG(TAG, "Uniform buffer of %u bytes at binding %u, %s", uint32(m_size), m_binding,
+			IsPersistent() ? "persistently mapped" : "written with glBufferSubData");
+}
+
+Graphics::UniformBuffer::~UniformBuffer()
+{
+	for (GLsync & fence : m_fences)
+	{
+		if (fence)
+			glDeleteSync(fence);
+	}
+
+	if (m_mapped)
+	{
+		glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+		glUnmapBuffer(GL_UNIFORM_BUFFER);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	}
+
+	glDeleteBuffers(1, &m_buffer);
+}
+
+bool Graphics::UniformBuffer::CreatePersistent()
+{
+	if (!GLAD_GL_VERSION_4_4 && !GLAD_GL_ARB_buffer_storage)
+		return false;
+
+	GLint alignment = 0;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+
+	size_t const step = std::max<size_t>(size_t(alignment), 1u);
+	m_stride = (m_size + step - 1u) / step * step;
+
+	glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+	glBufferStorage(GL_UNIFORM_BUFFER, m_stride * REGIONS, nullptr, PERSISTENT_FLAGS);
+
+	m_mapped = static_cast<byte *>(glMapBufferRange(GL_UNIFORM_BUFFER, 0, m_stride * REGIONS, PERSISTENT_FLAGS));
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	if (!m_mapped)
+	{
+		// the storage is immutable now, a new buffer takes the glBufferSubData path
+		PrintOpenGLErrors();
+		LOG_WARN(TAG, "Persistent mapping of a uniform buffer failed, it is written with glBufferSubData");
+
+		glDeleteBuffers(1, &m_buffer);
+		glGenBuffers(1, &m_buffer);
+
+		return false;
+	}
+
+	return true;
+}
+
+void Graphics::UniformBuffer::WaitForRegion(uint32 region)
+{
+	GLsync & fence = m_fences[region];
+
+	if (!fence)
+		return;
+
+	GLenum result;
+
+	do
+	{
+		result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT);
+	}
+	while (result == GL_TIMEOUT_EXPIRED);
+
+	if (result == GL_WAIT_FAILED)
+		PrintOpenGLErrors();
+
+	glDeleteSync(fence);
+	fence = nullptr;
+}
+
+bool Graphics::UniformBuffer::Write(void const * data, size_t size)
+{
+	if (size != m_size)
+	{
+		LOG_ERR(TAG, "Uniform block of %u bytes written to a buffer of %u", uint32(size), uint32(m_size));
+		return false;
+	}
+
+	if (!m_mapped)
+	{
+		glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, m_size, data);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+		return true;
+	}
+
+	// every draw reading the current copy was issued before this write
+	m_fences[m_region]	= glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	m_region			= (m_region + 1u) % REGIONS;
+
+	WaitForRegion(m_region);
+
+	size_t const offset = m_region * m_stride;
+
+	std::memcpy(m_mapped + offset, data, m_size);
+	glBindBufferRange(GL_UNIFORM_BUFFER, m_binding, m_buffer, GLintptr(offset), GLsizeiptr(m_size));
+
+	return true;
+}
+
+bool Graphics::UniformBuffer::IsPersistent() const
+{
+	return m_mapped != nullptr;
+}
+
+uint32 Graphics::UniformBuffer::GetBinding() const
+{
+	return m_binding;
+}
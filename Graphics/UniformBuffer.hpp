@@ -0,0 +1,55 @@
+#pragma once
+
+#include "OpenGL_Util.hpp"
+
+namespace Graphics
+{
+	class UniformBuffer;
+	typedef std::shared_ptr<UniformBuffer> UniformBufferPtr;
+
+	// Backing store of a std140 uniform block, bound to one binding point. With GL 4.4
+	// or ARB_buffer_storage it stays mapped for its whole life and a write is a memcpy
+	// into the next of REGIONS copies, each fenced once written so a copy a frame still
+	// in flight reads is never overwritten. Without them a write is one glBufferSubData.
+	class UniformBuffer:
+		public Misc::Noncopyable
+	{
+		static constexpr auto	TAG		= "OpenGL";
+		static constexpr uint32	REGIONS	= 3u;
+
+		GpuHandleID					m_buffer	{INVALID_HANDLE};
+		uint32						m_binding;
+		size_t						m_size;
+		size_t						m_stride	{0u};		// a copy rounded up to the offset alignment
+		uint32						m_region	{0u};
+		byte *						m_mapped	{nullptr};
+		std::array<GLsync, REGIONS>	m_fences	{};
+
+		bool CreatePersistent();
+		void WaitForRegion(uint32 region);
+
+		public:
+
+			static constexpr GpuHandleID INVALID_HANDLE = 0u;
+
+			UniformBuffer(uint32 binding, size_t size);
+			~UniformBuffer();
+
+			// the whole block at once, the copy written is bound in place of the last one
+			bool Write(void const * data, size_t size);
+
+			template<typename T>
+			bool Write(T const & block);
+
+			bool IsPersistent() const;
+			uint32 GetBinding() const;
+	};
+
+	template<typename T>
+	inline bool UniformBuffer::Write(T const & block)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "a uniform block is written as its bytes");
+
+		return Write(&block, sizeof(T));
+	}
+}
@@ -0,0 +1,84 @@
+#include <App\Log.hpp>
+
+// Turns a binary log (LogFormat::BINARY) back into the lines the text logs hold:
+//
+//	LogDecoder logFile_<time>.blog [output.log]
+//
+// The lines go to the standard output without an output file.
+
+namespace
+{
+	cstring LevelName(byte level)
+	{
+		switch (Log::LogLevel(level))
+		{
+			case Log::LogLevel::LDEBUG		: return "<DEBUG>:";
+			case Log::LogLevel::LINFO		: return "<INFO>:";
+			case Log::LogLevel::LWARNING	: return "<WARNING>:";
+			case Log::LogLevel::LERROR		: return "<ERROR>:";
+			case Log::LogLevel::LFATAL		: return "<FATAL>:";
+			default							: return "<VERBOSE>:";
+		}
+	}
+}
+
+int main(int argc, char ** argv)
+{
+	if (argc < 2)
+	{
+		std::fprintf(stderr, "usage: %s <binary log> [output file]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	Log::BinaryLogReader reader;
+
+	if (!reader.Open(argv[1]))
+	{
+		std::fprintf(stderr, "%s is not a binary log\n", argv[1]);
+		return EXIT_FAILURE;
+	}
+
+	std::FILE * output = stdout;
+
+	if (argc > 2 && fopen_s(&output, argv[2], "w") != 0)
+	{
+		std::fprintf(stderr, "can not write %s\n", argv[2]);
+		return EXIT_FAILURE;
+	}
+
+	Log::DecodedMessage	decoded;
+	std::string			line;
+	uint64				messages = 0u;
+
+	while (reader.Next(decoded))
+	{
+		Log::BinaryMessage const & message = decoded.message;
+
+		std::time_t const	time = std::time_t(message.time);
+		std::tm				timestamp;
+		char				timeText[64];
+
+		localtime_s(&timestamp, &time);
+
+		line.assign(timeText, std::strftime(timeText, sizeof(timeText), "%c", &timestamp));
+		line += " [";
+		line += decoded.tag;
+		line += "] ";
+		line += LevelName(message.level);
+		line += ' ';
+
+		Log::FormatArgs(line, decoded.format, message.args, message.argBytes);
+		line += '\n';
+
+		std::fwrite(line.data(), 1u, line.size(), output);
+		++messages;
+	}
+
+	if (output != stdout)
+	{
+		std::fclose(output);
+		std::printf("%llu messages decoded\n", static_cast<unsigned long long>(messages));
+	}
+
+	return EXIT_SUCCESS;
+}
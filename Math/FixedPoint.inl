@@ -0,0 +1,604 @@
+#pragma once
+
+#include "../Util.h"
+
+namespace math
+{
+	// Unsigned arithmetic on little endian arrays of 32 bit limbs
+	namespace Limbs
+	{
+		// below these many limbs the quadratic products beat the recursion, the schoolbook
+		// square already skips half the products so it stays ahead for longer
+		constexpr uint32 KARATSUBA_THRESHOLD		= 32u;
+		constexpr uint32 KARATSUBA_SQUARE_THRESHOLD	= 48u;
+
+		// limbs of scratch Multiply and Square need for n limb operands
+		constexpr uint32 ScratchSize(uint32 n)
+		{
+			return n < KARATSUBA_THRESHOLD ? 0u : 4u * (n - n / 2u + 1u) + ScratchSize(n - n / 2u + 1u);
+		}
+
+		// a[0, n) += b[0, m), m <= n, returns the carry out of the top limb
+		uint32 inline Add(uint32 * a, uint32 n, uint32 const * b, uint32 m)
+		{
+			uint64 carry = 0u;
+
+			for (uint32 i = 0u; i < m; ++i)
+			{
+				carry	= uint64(a[i]) + b[i] + carry;
+				a[i]	= uint32(carry);
+				carry >>= 32u;
+			}
+
+			for (uint32 i = m; i < n && carry; ++i)
+				carry = ++a[i] == 0u;
+
+			return uint32(carry);
+		}
+
+		// a[0, n) -= b[0, m), m <= n, returns the borrow out of the top limb
+		uint32 inline Subtract(uint32 * a, uint32 n, uint32 const * b, uint32 m)
+		{
+			uint64 borrow = 0u;
+
+			for (uint32 i = 0u; i < m; ++i)
+			{
+				uint64 const difference = uint64(a[i]) - b[i] - borrow;
+
+				a[i]	= uint32(difference);
+				borrow	= (difference >> 32u) & 1u;
+			}
+
+			for (uint32 i = m; i < n && borrow; ++i)
+				borrow = a[i]-- == 0u;
+
+			return uint32(borrow);
+		}
+
+		// product[0, 2n) = a * b
+		void inline MultiplySchoolbook(uint32 const * a, uint32 const * b, uint32 n, uint32 * product)
+		{
+			std::fill(product, product + 2u * n, 0u);
+
+			for (uint32 i = 0u; i < n; ++i)
+			{
+				if (!a[i])
+					continue;
+
+				uint64 carry = 0u;
+
+				for (uint32 j = 0u; j < n; ++j)
+				{
+					carry			= uint64(a[i]) * b[j] + product[i + j] + carry;
+					product[i + j]	= uint32(carry);
+					carry		  >>= 32u;
+				}
+
+				product[i + n] = uint32(carry);
+			}
+		}
+
+		// product[0, 2n) = a * a, each cross product is computed once and doubled
+		void inline SquareSchoolbook(uint32 const * a, uint32 n, uint32 * product)
+		{
+			std::fill(product, product + 2u * n, 0u);
+
+			for (uint32 i = 0u; i + 1u < n; ++i)
+			{
+				if (!a[i])
+					continue;
+
+				uint64 carry = 0u;
+
+				for (uint32 j = i + 1u; j < n; ++j)
+				{
+					carry			= uint64(a[i]) * a[j] + product[i + j] + carry;
+					product[i + j]	= uint32(carry);
+					carry		  >>= 32u;
+				}
+
+				product[i + n] = uint32(carry);
+			}
+
+			uint32 shifted = 0u;
+
+			for (uint32 i = 0u; i < 2u * n; ++i)
+			{
+				uint32 const limb = product[i];
+
+				product[i]	= (limb << 1u) | shifted;
+				shifted		= limb >> 31u;
+			}
+
+			uint64 carry = 0u;
+
+			for (uint32 i = 0u; i < n; ++i)
+			{
+				uint64 const diagonal = uint64(a[i]) * a[i];
+
+				carry				= uint64(product[2u * i]) + uint32(diagonal) + carry;
+				product[2u * i]		= uint32(carry);
+				carry				= (carry >> 32u) + product[2u * i + 1u] + (diagonal >> 32u);
+				product[2u * i + 1u]= uint32(carry);
+				carry			  >>= 32u;
+			}
+		}
+
+		// product[0, 2n) = a * b, Karatsuba from KARATSUBA_THRESHOLD limbs on:
+		//		(a1 B + a0)(b1 B + b0) = a1 b1 B^2 + ((a0 + a1)(b0 + b1) - a0 b0 - a1 b1) B + a0 b0
+		// scratch holds ScratchSize(n) limbs
+		void inline Multiply(uint32 const * a, uint32 const * b, uint32 n, uint32 * product, uint32 * scratch)
+		{
+			if (n < KARATSUBA_THRESHOLD)
+			{
+				MultiplySchoolbook(a, b, n, product);
+				return;
+			}
+
+			uint32 const low	= n / 2u;
+			uint32 const high	= n - low;
+
+			uint32 * sumA	= scratch;
+			uint32 * sumB	= sumA + high + 1u;
+			uint32 * middle	= sumB + high + 1u;
+			uint32 * rest	= middle + 2u * (high + 1u);
+
+			Multiply(a, b, low, product, rest);
+			Multiply(a + low, b + low, high, product + 2u * low, rest);
+
+			std::copy(a + low, a + n, sumA);
+			std::copy(b + low, b + n, sumB);
+
+			sumA[high] = Add(sumA, high, a, low);
+			sumB[high] = Add(sumB, high, b, low);
+
+			Multiply(sumA, sumB, high + 1u, middle, rest);
+
+			Subtract(middle, 2u * (high + 1u), product, 2u * low);
+			Subtract(middle, 2u * (high + 1u), product + 2u * low, 2u * high);
+
+			// the middle term is below B^(2 high + 1), its top limb is always zero
+			Add(product + low, 2u * n - low, middle, 2u * high + 1u);
+		}
+
+		// product[0, 2n) = a * a, as Multiply with (a0 + a1)^2 - a0^2 - a1^2 for the middle term
+		void inline Square(uint32 const * a, uint32 n, uint32 * product, uint32 * scratch)
+		{
+			if (n < KARATSUBA_SQUARE_THRESHOLD)
+			{
+				SquareSchoolbook(a, n, product);
+				return;
+			}
+
+			uint32 const low	= n / 2u;
+			uint32 const high	= n - low;
+
+			uint32 * sum	= scratch;
+			uint32 * middle	= sum + high + 1u;
+			uint32 * rest	= middle + 2u * (high + 1u);
+
+			Square(a, low, product, rest);
+			Square(a + low, high, product + 2u * low, rest);
+
+			std::copy(a + low, a + n, sum);
+			sum[high] = Add(sum, high, a, low);
+
+			Square(sum, high + 1u, middle, rest);
+
+			Subtract(middle, 2u * (high + 1u), product, 2u * low);
+			Subtract(middle, 2u * (high + 1u), product + 2u * low, 2u * high);
+
+			Add(product + low, 2u * n - low, middle, 2u * high + 1u);
+		}
+	}
+
+	// Sign-magnitude fixed point number made of 32 bit limbs, the most significant
+	// limb holds the integer part and every other limb 32 fractional bits.
+	// It is trivially copyable so it can be stored in vec2<T>, and with the comparisons
+	// and the constructors from literals the complex helpers of Render work on it too.
+	template<uint32 LIMBS>
+	struct FixedPoint
+	{
+		static_assert(LIMBS >= 2u, "FixedPoint needs at least one fractional limb");
+
+		static constexpr uint32 FRACTION_LIMBS	= LIMBS - 1u;
+		static constexpr int32	FRACTION_BITS	= int32(32u * FRACTION_LIMBS);
+
+		uint32	limbs[LIMBS];	// least significant first
+		bool	negative;
+
+		FixedPoint() = default;
+		FixedPoint(int32 value);
+		FixedPoint(uint32 value);
+		FixedPoint(double value);
+
+		template<uint32 OTHER>
+		explicit FixedPoint(FixedPoint<OTHER> const & other);
+
+		// value * 2^exponent, bits below the last fractional limb are truncated
+		// and the integer part has to fit the top limb
+		static FixedPoint FromDouble(double value, int32 exponent = 0);
+
+		// plain decimal notation: [-]digits[.digits]
+		static FixedPoint FromString(cstring text);
+
+		double	ToDouble()	const;
+		bool	IsZero()	const;
+
+		FixedPoint operator-() const;
+
+		FixedPoint& operator+=(FixedPoint const & other);
+		FixedPoint& operator-=(FixedPoint const & other);
+		FixedPoint& operator*=(FixedPoint const & other);
+
+		FixedPoint operator+(FixedPoint const & other) const;
+		FixedPoint operator-(FixedPoint const & other) const;
+		FixedPoint operator*(FixedPoint const & other) const;
+
+		// about half the limb products of x * x below the Karatsuba threshold, a third less above
+		FixedPoint Squared() const;
+
+		bool operator==(FixedPoint const & other) const;
+		bool operator!=(FixedPoint const & other) const;
+		bool operator< (FixedPoint const & other) const;
+		bool operator> (FixedPoint const & other) const;
+		bool operator<=(FixedPoint const & other) const;
+		bool operator>=(FixedPoint const & other) const;
+
+		private:
+
+			static int32	CompareMagnitude	(FixedPoint const & a, FixedPoint const & b);
+			static void		AddMagnitude		(FixedPoint & a, FixedPoint const & b);
+			static void		SubtractMagnitude	(FixedPoint & a, FixedPoint const & b);	// |a| >= |b|
+
+			uint32 DivideMagnitude(uint32 divisor);
+
+			// keeps the limbs of a full product that line up with our own radix point
+			void TakeProduct(uint32 const * product);
+	};
+
+	template<uint32 LIMBS>
+	FixedPoint<LIMBS> inline sq(FixedPoint<LIMBS> x)
+	{
+		return x.Squared();
+	}
+
+	template<uint32 LIMBS>
+	inline FixedPoint<LIMBS>::FixedPoint(int32 value)
+	{
+		std::fill(limbs, limbs + LIMBS, 0u);
+
+		negative				= value < 0;
+		limbs[FRACTION_LIMBS]	= negative ? uint32(-int64(value)) : uint32(value);
+	}
+
+	template<uint32 LIMBS>
+	inline FixedPoint<LIMBS>::FixedPoint(uint32 value)
+	{
+		std::fill(limbs, limbs + LIMBS, 0u);
+
+		negative				= false;
+		limbs[FRACTION_LIMBS]	= value;
+	}
+
+	template<uint32 LIMBS>
+	inline FixedPoint<LIMBS>::FixedPoint(double value)
+	{
+		*this = FromDouble(value);
+	}
+
+	template<uint32 LIMBS>
+	template<uint32 OTHER>
+	inline FixedPoint<LIMBS>::FixedPoint(FixedPoint<OTHER> const & other)
+	{
+		std::fill(limbs, limbs + LIMBS, 0u);
+
+		// align both integer limbs, extra fractional limbs get truncated
+		for (uint32 i = 0u; i < std::min(LIMBS, OTHER); ++i)
+			limbs[LIMBS - 1u - i] = other.limbs[OTHER - 1u - i];
+
+		negative = other.negative && !IsZero();
+	}
+
+	template<uint32 LIMBS>
+	inline FixedPoint<LIMBS> FixedPoint<LIMBS>::FromDouble(double value, int32 exponent)
+	{
+		FixedPoint result{ 0 };
+
+		if (value == 0. || !std::isfinite(value))
+			return result;
+
+		int32	valueExponent;
+		double	mantissa = std::frexp(std::abs(value), &valueExponent);
+
+		// |value| = bits * 2^(shift - FRACTION_BITS)
+		uint64	bits	= uint64(std::ldexp(mantissa, 53));
+		int32	shift	= valueExponent - 53 + exponent + FRACTION_BITS;
+
+		if (shift < 0)
+		{
+			if (shift <= -64)
+				return result;
+
+			bits >>= -shift;
+			shift  = 0;
+		}
+
+		// the 53 bits straddle at most three limbs
+		uint32 const first	= uint32(shift) / 32u;
+		uint32 const offset	= uint32(shift) % 32u;
+
+		uint64 const low	= bits << offset;
+		uint64 const high	= offset ? bits >> (64u - offset) : 0u;
+
+		uint32 const parts[3] = { uint32(low), uint32(low >> 32u), uint32(high) };
+
+		for (uint32 i = 0u; i < 3u && first + i < LIMBS; ++i)
+			result.limbs[first + i] = parts[i];
+
+		result.negative = value < 0. && !result.IsZero();
+
+		return result;
+	}
+
+	template<uint32 LIMBS>
+	inline FixedPoint<LIMBS> FixedPoint<LIMBS>::FromString(cstring text)
+	{
+		FixedPoint result{ 0 };
+
+		bool const isNegative = *text == '-';
+
+		if (*text == '-' || *text == '+')
+			++text;
+
+		uint32 integer = 0u;
+
+		for (; *text >= '0' && *text <= '9'; ++text)
+			integer = integer * 10u + uint32(*text - '0');
+
+		if (*text == '.')
+		{
+			cstring const first = ++text;
+
+			while (*text >= '0' && *text <= '9')
+				++text;
+
+			// Horner from the last digit: fraction = (digit + fraction) / 10
+			for (cstring digit = text; digit != first; )
+			{
+				--digit;
+				result.limbs[FRACTION_LIMBS] = uint32(*digit - '0');
+				result.DivideMagnitude(10u);
+			}
+		}
+
+		result.limbs[FRACTION_LIMBS]	= integer;
+		result.negative					= isNegative && !result.IsZero();
+
+		return result;
+	}
+
+	template<uint32 LIMBS>
+	inline double FixedPoint<LIMBS>::ToDouble() const
+	{
+		int32 top = int32(LIMBS) - 1;
+
+		while (top >= 0 && !limbs[top])
+			--top;
+
+		if (top < 0)
+			return 0.;
+
+		// three limbs cover the 53 bits of the mantissa
+		double value = 0.;
+
+		for (int32 i = top; i >= std::max(0, top - 2); --i)
+			value += std::ldexp(double(limbs[i]), 32 * i - FRACTION_BITS);
+
+		return negative ? -value : value;
+	}
+
+	template<uint32 LIMBS>
+	inline bool FixedPoint<LIMBS>::IsZero() const
+	{
+		for (uint32 i = 0u; i < LIMBS; ++i)
+		{
+			if (limbs[i])
+				return false;
+		}
+
+		return true;
+	}
+
+	template<uint32 LIMBS>
+	inline FixedPoint<LIMBS> FixedPoint<LIMBS>::operator-() const
+	{
+		FixedPoint result	= *this;
+		result.negative		= !negative && !IsZero();
+
+		return result;
+	}
+
+	template<uint32 LIMBS>
+	inline int32 FixedPoint<LIMBS>::CompareMagnitude(FixedPoint const & a, FixedPoint const & b)
+	{
+		for (uint32 i = LIMBS; i-- > 0u; )
+		{
+			if (a.limbs[i] != b.limbs[i])
+				return a.limbs[i] < b.limbs[i] ? -1 : 1;
+		}
+
+		return 0;
+	}
+
+	template<uint32 LIMBS>
+	inline void FixedPoint<LIMBS>::AddMagnitude(FixedPoint & a, FixedPoint const & b)
+	{
+		uint64 carry = 0u;
+
+		for (uint32 i = 0u; i < LIMBS; ++i)
+		{
+			carry		= uint64(a.limbs[i]) + b.limbs[i] + carry;
+			a.limbs[i]	= uint32(carry);
+			carry	  >>= 32u;
+		}
+	}
+
+	template<uint32 LIMBS>
+	inline void FixedPoint<LIMBS>::SubtractMagnitude(FixedPoint & a, FixedPoint const & b)
+	{
+		uint64 borrow = 0u;
+
+		for (uint32 i = 0u; i < LIMBS; ++i)
+		{
+			uint64 const difference = uint64(a.limbs[i]) - b.limbs[i] - borrow;
+
+			a.limbs[i]	= uint32(difference);
+			borrow		= (difference >> 32u) & 1u;
+		}
+	}
+
+	template<uint32 LIMBS>
+	inline uint32 FixedPoint<LIMBS>::DivideMagnitude(uint32 divisor)
+	{
+		uint64 remainder = 0u;
+
+		for (uint32 i = LIMBS; i-- > 0u; )
+		{
+			uint64 const current = (remainder << 32u) | limbs[i];
+
+			limbs[i]	= uint32(current / divisor);
+			remainder	= current % divisor;
+		}
+
+		return uint32(remainder);
+	}
+
+	template<uint32 LIMBS>
+	inline FixedPoint<LIMBS> & FixedPoint<LIMBS>::operator+=(FixedPoint const & other)
+	{
+		if (negative == other.negative)
+		{
+			AddMagnitude(*this, other);
+		}
+		else if (CompareMagnitude(*this, other) >= 0)
+		{
+			SubtractMagnitude(*this, other);
+		}
+		else
+		{
+			FixedPoint larger = other;
+			SubtractMagnitude(larger, *this);
+
+			*this = larger;
+		}
+
+		negative = negative && !IsZero();
+
+		return *this;
+	}
+
+	template<uint32 LIMBS>
+	inline FixedPoint<LIMBS> & FixedPoint<LIMBS>::operator-=(FixedPoint const & other)
+	{
+		return *this += -other;
+	}
+
+	template<uint32 LIMBS>
+	inline void FixedPoint<LIMBS>::TakeProduct(uint32 const * product)
+	{
+		std::copy(product + FRACTION_LIMBS, product + FRACTION_LIMBS + LIMBS, limbs);
+	}
+
+	template<uint32 LIMBS>
+	inline FixedPoint<LIMBS> & FixedPoint<LIMBS>::operator*=(FixedPoint const & other)
+	{
+		// one extra limb, arrays can not be empty
+		uint32 product[2u * LIMBS];
+		uint32 scratch[Limbs::ScratchSize(LIMBS) + 1u];
+
+		Limbs::Multiply(limbs, other.limbs, LIMBS, product, scratch);
+		TakeProduct(product);
+
+		negative = negative != other.negative && !IsZero();
+
+		return *this;
+	}
+
+	template<uint32 LIMBS>
+	inline FixedPoint<LIMBS> FixedPoint<LIMBS>::Squared() const
+	{
+		uint32 product[2u * LIMBS];
+		uint32 scratch[Limbs::ScratchSize(LIMBS) + 1u];
+
+		Limbs::Square(limbs, LIMBS, product, scratch);
+
+		FixedPoint result;
+		result.TakeProduct(product);
+		result.negative = false;
+
+		return result;
+	}
+
+	template<uint32 LIMBS>
+	inline FixedPoint<LIMBS> FixedPoint<LIMBS>::operator+(FixedPoint const & other) const
+	{
+		FixedPoint result = *this;
+		return result += other;
+	}
+
+	template<uint32 LIMBS>
+	inline FixedPoint<LIMBS> FixedPoint<LIMBS>::operator-(FixedPoint const & other) const
+	{
+		FixedPoint result = *this;
+		return result -= other;
+	}
+
+	template<uint32 LIMBS>
+	inline FixedPoint<LIMBS> FixedPoint<LIMBS>::operator*(FixedPoint const & other) const
+	{
+		FixedPoint result = *this;
+		return result *= other;
+	}
+
+	template<uint32 LIMBS>
+	inline bool FixedPoint<LIMBS>::operator==(FixedPoint const & other) const
+	{
+		return negative == other.negative && CompareMagnitude(*this, other) == 0;
+	}
+
+	template<uint32 LIMBS>
+	inline bool FixedPoint<LIMBS>::operator!=(FixedPoint const & other) const
+	{
+		return !(*this == other);
+	}
+
+	template<uint32 LIMBS>
+	inline bool FixedPoint<LIMBS>::operator<(FixedPoint const & other) const
+	{
+		if (negative != other.negative)
+			return negative;
+
+		int32 const magnitude = CompareMagnitude(*this, other);
+
+		return negative ? magnitude > 0 : magnitude < 0;
+	}
+
+	template<uint32 LIMBS>
+	inline bool FixedPoint<LIMBS>::operator>(FixedPoint const & other) const
+	{
+		return other < *this;
+	}
+
+	template<uint32 LIMBS>
+	inline bool FixedPoint<LIMBS>::operator<=(FixedPoint const & other) const
+	{
+		return !(other < *this);
+	}
+
+	template<uint32 LIMBS>
+	inline bool FixedPoint<LIMBS>::operator>=(FixedPoint const & other) const
+	{
+		return !(*this < other);
+	}
+}
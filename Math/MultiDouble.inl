@@ -0,0 +1,348 @@
+#pragma once
+
+#include "../Util.h"
+
+namespace math
+{
+	// s = a + b rounded, error receives exactly what the rounding lost
+	double inline TwoSum(double a, double b, double & error)
+	{
+		double const sum		= a + b;
+		double const bVirtual	= sum - a;
+
+		error = (a - (sum - bVirtual)) + (b - bVirtual);
+
+		return sum;
+	}
+
+	// as TwoSum, only valid when |a| >= |b|
+	double inline QuickTwoSum(double a, double b, double & error)
+	{
+		double const sum = a + b;
+
+		error = b - (sum - a);
+
+		return sum;
+	}
+
+	double inline TwoProduct(double a, double b, double & error)
+	{
+		double const product = a * b;
+
+		error = std::fma(a, b, -product);
+
+		return product;
+	}
+
+	// Unevaluated sum of N doubles, most significant first, every component roughly
+	// below half an ulp of the previous one, so about 53 * N bits of mantissa with the
+	// exponent range of a double. Only what the escape-time iteration needs is there.
+	// It is trivially copyable so it can be stored in vec2<T>.
+	template<uint32 N>
+	struct MultiDouble
+	{
+		static_assert(N >= 2u, "MultiDouble needs at least two components");
+
+		double components[N];
+
+		MultiDouble() = default;
+		MultiDouble(double value);
+
+		explicit operator double()	const;
+		explicit operator float()	const;
+
+		MultiDouble operator-() const;
+
+		MultiDouble& operator+=(MultiDouble const & other);
+		MultiDouble& operator-=(MultiDouble const & other);
+		MultiDouble& operator*=(MultiDouble const & other);
+		MultiDouble& operator/=(MultiDouble const & other);
+
+		MultiDouble operator+(MultiDouble const & other) const;
+		MultiDouble operator-(MultiDouble const & other) const;
+		MultiDouble operator*(MultiDouble const & other) const;
+		MultiDouble operator/(MultiDouble const & other) const;
+
+		// exact when scale is a power of two
+		MultiDouble Scaled(double scale) const;
+
+		// lexicographic over the components, exact for normalised values
+		bool operator==(MultiDouble const & other) const;
+		bool operator!=(MultiDouble const & other) const;
+		bool operator< (MultiDouble const & other) const;
+		bool operator> (MultiDouble const & other) const;
+		bool operator<=(MultiDouble const & other) const;
+		bool operator>=(MultiDouble const & other) const;
+
+		// Sums the terms without error, overwriting them, and keeps the leading N
+		// components. The terms should come roughly in decreasing magnitude.
+		static MultiDouble Renormalize(double * terms, uint32 count);
+	};
+
+	typedef MultiDouble<2u> DoubleDouble;	// ~106 bits
+	typedef MultiDouble<4u> QuadDouble;		// ~212 bits
+
+	template<uint32 N>
+	inline MultiDouble<N>::MultiDouble(double value)
+	{
+		components[0] = value;
+		std::fill(components + 1, components + N, 0.);
+	}
+
+	template<uint32 N>
+	inline MultiDouble<N>::operator double() const
+	{
+		double sum = 0.;
+
+		for (uint32 i = N; i-- > 0u;)
+			sum += components[i];
+
+		return sum;
+	}
+
+	template<uint32 N>
+	inline MultiDouble<N>::operator float() const
+	{
+		return float(double(*this));
+	}
+
+	template<uint32 N>
+	inline MultiDouble<N> MultiDouble<N>::operator-() const
+	{
+		MultiDouble result;
+
+		for (uint32 i = 0u; i < N; ++i)
+			result.components[i] = -components[i];
+
+		return result;
+	}
+
+	template<uint32 N>
+	inline MultiDouble<N> MultiDouble<N>::Renormalize(double * terms, uint32 count)
+	{
+		// from the bottom up, the running sum ends in terms[0] and every rounding error
+		// stays in place of the term it was added to
+		double sum = terms[count - 1u];
+
+		for (uint32 i = count - 1u; i-- > 0u;)
+			sum = TwoSum(terms[i], sum, terms[i + 1u]);
+
+		terms[0] = sum;
+
+		// top down, a component is emitted whenever the sum stops absorbing the next error
+		MultiDouble result;
+		uint32		emitted = 0u;
+
+		for (uint32 i = 1u; i < count && emitted < N; ++i)
+		{
+			double error;
+			sum = TwoSum(sum, terms[i], error);
+
+			if (error != 0.)
+			{
+				result.components[emitted++]	= sum;
+				sum								= error;
+			}
+		}
+
+		if (emitted < N)
+			result.components[emitted++] = sum;
+
+		std::fill(result.components + emitted, result.components + N, 0.);
+
+		return result;
+	}
+
+	template<uint32 N>
+	inline MultiDouble<N> & MultiDouble<N>::operator+=(MultiDouble const & other)
+	{
+		// s0, s1, e0, s2, e1, ... keeps every error next to the sums of its magnitude
+		double terms[2u * N];
+
+		terms[0] = TwoSum(components[0], other.components[0], terms[2]);
+
+		for (uint32 i = 1u; i < N; ++i)
+		{
+			double error;
+			terms[2u * i - 1u]	= TwoSum(components[i], other.components[i], error);
+			terms[2u * i + (i + 1u < N ? 2u : 1u)] = error;
+		}
+
+		return *this = Renormalize(terms, 2u * N);
+	}
+
+	template<uint32 N>
+	inline MultiDouble<N> & MultiDouble<N>::operator-=(MultiDouble const & other)
+	{
+		return *this += -other;
+	}
+
+	template<uint32 N>
+	inline MultiDouble<N> & MultiDouble<N>::operator*=(MultiDouble const & other)
+	{
+		// products of the same order a_i * b_j, i + j = order, followed by the
+		// rounding errors of the previous order, the last order is not worth its errors
+		double terms[N * N];
+		double errors[N];
+		uint32 count		= 0u;
+		uint32 errorCount	= 0u;
+
+		for (uint32 order = 0u; order < N; ++order)
+		{
+			double	next[N];
+			uint32	nextCount = 0u;
+
+			for (uint32 i = 0u; i <= order; ++i)
+			{
+				if (order + 1u < N)
+					terms[count++] = TwoProduct(components[i], other.components[order - i], next[nextCount++]);
+				else
+					terms[count++] = components[i] * other.components[order - i];
+			}
+
+			for (uint32 i = 0u; i < errorCount; ++i)
+				terms[count++] = errors[i];
+
+			std::copy(next, next + nextCount, errors);
+			errorCount = nextCount;
+		}
+
+		return *this = Renormalize(terms, count);
+	}
+
+	template<uint32 N>
+	inline MultiDouble<N> & MultiDouble<N>::operator/=(MultiDouble const & other)
+	{
+		// long division, one quotient digit per component and one more for the rounding
+		double			quotients[N + 1u];
+		MultiDouble		remainder = *this;
+
+		for (uint32 i = 0u; i <= N; ++i)
+		{
+			quotients[i] = remainder.components[0] / other.components[0];
+
+			if (i < N)
+				remainder -= other * MultiDouble(quotients[i]);
+		}
+
+		return *this = Renormalize(quotients, N + 1u);
+	}
+
+	// the double-double cases get the usual shorter sequences
+	template<>
+	inline DoubleDouble & DoubleDouble::operator+=(DoubleDouble const & other)
+	{
+		double highError, lowError;
+
+		double high = TwoSum(components[0], other.components[0], highError);
+		double low	= TwoSum(components[1], other.components[1], lowError);
+
+		highError	+= low;
+		high		 = QuickTwoSum(high, highError, highError);
+		highError	+= lowError;
+
+		components[0] = QuickTwoSum(high, highError, components[1]);
+
+		return *this;
+	}
+
+	template<>
+	inline DoubleDouble & DoubleDouble::operator*=(DoubleDouble const & other)
+	{
+		double error;
+		double const product = TwoProduct(components[0], other.components[0], error);
+
+		error += components[0] * other.components[1] + components[1] * other.components[0];
+
+		components[0] = QuickTwoSum(product, error, components[1]);
+
+		return *this;
+	}
+
+	template<uint32 N>
+	inline MultiDouble<N> MultiDouble<N>::operator+(MultiDouble const & other) const
+	{
+		MultiDouble result = *this;
+		return result += other;
+	}
+
+	template<uint32 N>
+	inline MultiDouble<N> MultiDouble<N>::operator-(MultiDouble const & other) const
+	{
+		MultiDouble result = *this;
+		return result -= other;
+	}
+
+	template<uint32 N>
+	inline MultiDouble<N> MultiDouble<N>::operator*(MultiDouble const & other) const
+	{
+		MultiDouble result = *this;
+		return result *= other;
+	}
+
+	template<uint32 N>
+	inline MultiDouble<N> MultiDouble<N>::operator/(MultiDouble const & other) const
+	{
+		MultiDouble result = *this;
+		return result /= other;
+	}
+
+	template<uint32 N>
+	inline MultiDouble<N> MultiDouble<N>::Scaled(double scale) const
+	{
+		MultiDouble result;
+
+		for (uint32 i = 0u; i < N; ++i)
+			result.components[i] = components[i] * scale;
+
+		return result;
+	}
+
+	template<uint32 N>
+	inline bool MultiDouble<N>::operator==(MultiDouble const & other) const
+	{
+		for (uint32 i = 0u; i < N; ++i)
+		{
+			if (components[i] != other.components[i])
+				return false;
+		}
+
+		return true;
+	}
+
+	template<uint32 N>
+	inline bool MultiDouble<N>::operator!=(MultiDouble const & other) const
+	{
+		return !(*this == other);
+	}
+
+	template<uint32 N>
+	inline bool MultiDouble<N>::operator<(MultiDouble const & other) const
+	{
+		for (uint32 i = 0u; i < N; ++i)
+		{
+			if (components[i] != other.components[i])
+				return components[i] < other.components[i];
+		}
+
+		return false;
+	}
+
+	template<uint32 N>
+	inline bool MultiDouble<N>::operator>(MultiDouble const & other) const
+	{
+		return other < *this;
+	}
+
+	template<uint32 N>
+	inline bool MultiDouble<N>::operator<=(MultiDouble const & other) const
+	{
+		return !(other < *this);
+	}
+
+	template<uint32 N>
+	inline bool MultiDouble<N>::operator>=(MultiDouble const & other) const
+	{
+		return !(*this < other);
+	}
+}
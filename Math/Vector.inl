@@ -36,10 +36,12 @@ namespace math
 	typedef vec3<float> vec3f;
 	typedef vec4<float> vec4f;
 
+	typedef vec2<double> vec2d;
+
 	template<typename T>
 	struct vec2
 	{
-		typedef typename T contentType;
+		typedef T contentType;
 
 		union
 		{
@@ -83,7 +85,7 @@ namespace math
 		{
 			struct { T x, y, z; };
 			struct { T r, g, b; };
-			struct { T s, t, r; };
+			struct { T s, t, p; };
 			struct { T u, v, w; };
 		};
 
@@ -121,8 +123,7 @@ namespace math
 		{
 			struct { T x, y, z, w; };
 			struct { T r, g, b, a; };
-			struct { T s, t, r, q; };
-			struct { T u, v, w; };
+			struct { T s, t, p, q; };
 		};
 
 		vec4& operator+=(vec4 v);
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <Util.h>
+
+namespace Render
+{
+	// Copies share one flag, a Cancel through any of them is seen by all the others.
+	// Long renders poll it between rows and return early once it is set.
+	class CancellationToken
+	{
+		std::shared_ptr<std::atomic<bool>> m_cancelled;
+
+		public:
+
+			CancellationToken():
+				m_cancelled(std::make_shared<std::atomic<bool>>(false))
+			{}
+
+			void inline Cancel() {
+				m_cancelled->store(true, std::memory_order_relaxed);
+			}
+
+			bool inline IsCancelled() const {
+				return m_cancelled->load(std::memory_order_relaxed);
+			}
+	};
+}
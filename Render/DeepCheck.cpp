@@ -0,0 +1,113 @@
+#include "DeepCheck.hpp"
+
+#include "Perturbation.hpp"
+
+namespace
+{
+	struct SuiteView
+	{
+		cstring			name;
+		cstring			re, im, zoom;
+		uint32			maxIterations;
+		math::vec2u		canvas;
+	};
+
+	cstring const k_seahorseRe = "-0.743643887037158704752191506114774";
+	cstring const k_seahorseIm = "0.131825904205311970493132056385139";
+
+	SuiteView const k_suite[] =
+	{
+		{ "Seahorse 1e-6",		k_seahorseRe,	k_seahorseIm,	"1e-6",		4000u,	{ 80u,	60u } },
+		{ "Seahorse 1e-11",		k_seahorseRe,	k_seahorseIm,	"1e-11",	8000u,	{ 80u,	60u } },
+		{ "Seahorse 1e-13",		k_seahorseRe,	k_seahorseIm,	"1e-13",	8000u,	{ 80u,	60u } },
+		{ "Seahorse 1e-30",		k_seahorseRe,	k_seahorseIm,	"1e-30",	4000u,	{ 80u,	60u } },
+		{ "Below doubles 1e-320",	k_seahorseRe,	k_seahorseIm,	"1e-320",	1000u,	{ 32u,	24u } },
+	};
+
+	// the pixel centre ComputeReferenceOrbit would place a reference on
+	template<uint32 LIMBS>
+	uint32 IterateDirect(Render::DeepView const & view, uint32 x, uint32 y)
+	{
+		typedef math::FixedPoint<LIMBS> Real;
+
+		double const height = double(view.canvas.y);
+
+		math::vec2<Real> const c =
+		{
+			Real(view.offset.x) + Real::FromDouble((double(x) + .5) / height * view.zoom.mantissa, view.zoom.exponent),
+			Real(view.offset.y) + Real::FromDouble((height - double(y) - .5) / height * view.zoom.mantissa, view.zoom.exponent)
+		};
+
+		math::vec2<Real> z = { Real(0), Real(0) };
+
+		for (uint32 n = 0u; n < view.maxIterations; ++n)
+		{
+			double const re = z.x.ToDouble();
+			double const im = z.y.ToDouble();
+
+			if (re * re + im * im > double(Render::LIMIT_THRESHOLD))
+				return n;
+
+			z = Render::ComplexSquare(z) + c;
+		}
+
+		return view.maxIterations;
+	}
+}
+
+std::vector<Render::DeepCheckResult> Render::CheckDeepZoom(RenderOptions options)
+{
+	std::vector<DeepCheckResult> results;
+
+	FractalEngine engine(0u, options);
+
+	IterationBuffer	iterations;
+	ColorBuffer		colors;
+
+	for (auto const & entry : k_suite)
+	{
+		FractalView frame;
+		frame.zoom			= 1.;
+		frame.canvas		= entry.canvas;
+		frame.maxIterations	= entry.maxIterations;
+		frame.fractal		= FractalType::MANDELBROT;
+		frame.juliaConstant	= { 0.f, 0.f };
+		frame.colorModifier	= { 1.f, 1.f, 1.f };
+
+		DeepView const view = DeepView::FromCenter(frame, { DeepReal::FromString(entry.re), DeepReal::FromString(entry.im) },
+												   DeepZoom::FromString(entry.zoom));
+
+		RenderStats const perturbed = engine.RenderDeepFrame(view, iterations, colors);
+
+		DeepCheckResult result;
+		result.name			= entry.name;
+		result.pixels		= view.PixelCount();
+		result.ownOrbits	= perturbed.ownOrbits;
+		result.references	= perturbed.references;
+		result.perturbed	= perturbed.elapsed;
+
+		Misc::Stopwatch stopwatch;
+		stopwatch.Start();
+
+		// 480 bits are over twice what the views above doubles need
+		bool const belowDoubles = view.zoom.Log2() < -900.;
+
+		for (uint32 y = 0u; y < view.canvas.y; ++y)
+		{
+			for (uint32 x = 0u; x < view.canvas.x; ++x)
+			{
+				uint32 const expected = belowDoubles ? IterateDirect<DEEP_LIMBS>(view, x, y) : IterateDirect<16>(view, x, y);
+
+				if (iterations.iterations[y * view.canvas.x + x] != expected)
+					++result.mismatches;
+			}
+		}
+
+		stopwatch.Stop();
+		result.direct = stopwatch.GetTime();
+
+		results.push_back(result);
+	}
+
+	return results;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "FractalEngine.hpp"
+
+namespace Render
+{
+	struct DeepCheckResult
+	{
+		cstring					name;
+		uint64					pixels			{0u};
+		uint64					mismatches		{0u};	// iteration count differs from the direct iteration
+		uint64					ownOrbits		{0u};
+		uint32					references		{0u};
+		Misc::clock::duration	direct			{0};
+		Misc::clock::duration	perturbed		{0};
+
+		double inline Speedup() const {
+			return perturbed.count() ? double(direct.count()) / double(perturbed.count()) : 0.;
+		}
+	};
+
+	// Renders a fixed suite of deep views with RenderDeepFrame and compares every pixel
+	// with iterating its centre directly in fixed point, far more bits than the view needs
+	std::vector<DeepCheckResult> CheckDeepZoom(RenderOptions options = RenderOptions());
+}
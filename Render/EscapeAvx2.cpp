@@ -0,0 +1,93 @@
+#include "SimdKernels.hpp"
+
+#if RENDER_X86
+
+#include <immintrin.h>
+
+SIMD_TARGET_BEGIN("avx2")
+
+#include "SimdEscape.inl"
+
+namespace
+{
+	struct Avx2Float
+	{
+		typedef float	scalar;
+		typedef __m256	vec;
+		typedef __m256	mask;
+
+		static constexpr uint32 LANES = 8u;
+
+		static inline vec	Set(scalar value)				{ return _mm256_set1_ps(value); }
+		static inline vec	Load(scalar const * values)		{ return _mm256_load_ps(values); }
+		static inline void	Store(scalar * values, vec v)	{ _mm256_store_ps(values, v); }
+
+		static inline vec	Add(vec a, vec b)				{ return _mm256_add_ps(a, b); }
+		static inline vec	Sub(vec a, vec b)				{ return _mm256_sub_ps(a, b); }
+		static inline vec	Mul(vec a, vec b)				{ return _mm256_mul_ps(a, b); }
+
+		static inline mask	Greater(vec a, vec b)			{ return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+		static inline mask	Equal(vec a, vec b)				{ return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+		static inline uint32 Bits(mask m)					{ return uint32(_mm256_movemask_ps(m)); }
+
+		// m ? a : b
+		static inline vec	Select(mask m, vec a, vec b)	{ return _mm256_blendv_ps(b, a, m); }
+	};
+
+	struct Avx2Double
+	{
+		typedef double	scalar;
+		typedef __m256d	vec;
+		typedef __m256d	mask;
+
+		static constexpr uint32 LANES = 4u;
+
+		static inline vec	Set(scalar value)				{ return _mm256_set1_pd(value); }
+		static inline vec	Load(scalar const * values)		{ return _mm256_load_pd(values); }
+		static inline void	Store(scalar * values, vec v)	{ _mm256_store_pd(values, v); }
+
+		static inline vec	Add(vec a, vec b)				{ return _mm256_add_pd(a, b); }
+		static inline vec	Sub(vec a, vec b)				{ return _mm256_sub_pd(a, b); }
+		static inline vec	Mul(vec a, vec b)				{ return _mm256_mul_pd(a, b); }
+
+		static inline mask	Greater(vec a, vec b)			{ return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+		static inline mask	Equal(vec a, vec b)				{ return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+		static inline uint32 Bits(mask m)					{ return uint32(_mm256_movemask_pd(m)); }
+
+		static inline vec	Select(mask m, vec a, vec b)	{ return _mm256_blendv_pd(b, a, m); }
+	};
+}
+
+uint64 Render::Kernels::EscapeSpanAvx2F(FractalView const & view, uint32 row, uint32 column, uint32 count, EscapeSample * samples)
+{
+	return EscapeSpan<Avx2Float>(view, row, column, count, samples);
+}
+
+uint64 Render::Kernels::EscapeSpanAvx2D(FractalView const & view, uint32 row, uint32 column, uint32 count, EscapeSample * samples)
+{
+	return EscapeSpan<Avx2Double>(view, row, column, count, samples);
+}
+
+uint64 Render::Kernels::EscapePixelsAvx2F(FractalView const & view, math::vec2u const * pixels, uint32 count, EscapeSample * samples)
+{
+	return EscapePixels<Avx2Float>(view, pixels, count, samples);
+}
+
+uint64 Render::Kernels::EscapePixelsAvx2D(FractalView const & view, math::vec2u const * pixels, uint32 count, EscapeSample * samples)
+{
+	return EscapePixels<Avx2Double>(view, pixels, count, samples);
+}
+
+uint64 Render::Kernels::EscapeJuliaAvx2F(FractalView const & view, math::vec2u pixel, math::vec2f const * constants, uint32 count, EscapeSample * samples)
+{
+	return EscapeJulia<Avx2Float>(view, pixel, constants, count, samples);
+}
+
+uint64 Render::Kernels::EscapeJuliaAvx2D(FractalView const & view, math::vec2u pixel, math::vec2f const * constants, uint32 count, EscapeSample * samples)
+{
+	return EscapeJulia<Avx2Double>(view, pixel, constants, count, samples);
+}
+
+SIMD_TARGET_END()
+
+#endif
@@ -0,0 +1,93 @@
+#include "SimdKernels.hpp"
+
+#if RENDER_X86
+
+#include <immintrin.h>
+
+SIMD_TARGET_BEGIN("avx512f")
+
+#include "SimdEscape.inl"
+
+namespace
+{
+	struct Avx512Float
+	{
+		typedef float		scalar;
+		typedef __m512		vec;
+		typedef __mmask16	mask;
+
+		static constexpr uint32 LANES = 16u;
+
+		static inline vec	Set(scalar value)				{ return _mm512_set1_ps(value); }
+		static inline vec	Load(scalar const * values)		{ return _mm512_load_ps(values); }
+		static inline void	Store(scalar * values, vec v)	{ _mm512_store_ps(values, v); }
+
+		static inline vec	Add(vec a, vec b)				{ return _mm512_add_ps(a, b); }
+		static inline vec	Sub(vec a, vec b)				{ return _mm512_sub_ps(a, b); }
+		static inline vec	Mul(vec a, vec b)				{ return _mm512_mul_ps(a, b); }
+
+		static inline mask	Greater(vec a, vec b)			{ return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+		static inline mask	Equal(vec a, vec b)				{ return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+		static inline uint32 Bits(mask m)					{ return uint32(m); }
+
+		// the blend takes the second operand where the mask is set, m ? a : b
+		static inline vec	Select(mask m, vec a, vec b)	{ return _mm512_mask_blend_ps(m, b, a); }
+	};
+
+	struct Avx512Double
+	{
+		typedef double		scalar;
+		typedef __m512d		vec;
+		typedef __mmask8	mask;
+
+		static constexpr uint32 LANES = 8u;
+
+		static inline vec	Set(scalar value)				{ return _mm512_set1_pd(value); }
+		static inline vec	Load(scalar const * values)		{ return _mm512_load_pd(values); }
+		static inline void	Store(scalar * values, vec v)	{ _mm512_store_pd(values, v); }
+
+		static inline vec	Add(vec a, vec b)				{ return _mm512_add_pd(a, b); }
+		static inline vec	Sub(vec a, vec b)				{ return _mm512_sub_pd(a, b); }
+		static inline vec	Mul(vec a, vec b)				{ return _mm512_mul_pd(a, b); }
+
+		static inline mask	Greater(vec a, vec b)			{ return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+		static inline mask	Equal(vec a, vec b)				{ return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+		static inline uint32 Bits(mask m)					{ return uint32(m); }
+
+		static inline vec	Select(mask m, vec a, vec b)	{ return _mm512_mask_blend_pd(m, b, a); }
+	};
+}
+
+uint64 Render::Kernels::EscapeSpanAvx512F(FractalView const & view, uint32 row, uint32 column, uint32 count, EscapeSample * samples)
+{
+	return EscapeSpan<Avx512Float>(view, row, column, count, samples);
+}
+
+uint64 Render::Kernels::EscapeSpanAvx512D(FractalView const & view, uint32 row, uint32 column, uint32 count, EscapeSample * samples)
+{
+	return EscapeSpan<Avx512Double>(view, row, column, count, samples);
+}
+
+uint64 Render::Kernels::EscapePixelsAvx512F(FractalView const & view, math::vec2u const * pixels, uint32 count, EscapeSample * samples)
+{
+	return EscapePixels<Avx512Float>(view, pixels, count, samples);
+}
+
+uint64 Render::Kernels::EscapePixelsAvx512D(FractalView const & view, math::vec2u const * pixels, uint32 count, EscapeSample * samples)
+{
+	return EscapePixels<Avx512Double>(view, pixels, count, samples);
+}
+
+uint64 Render::Kernels::EscapeJuliaAvx512F(FractalView const & view, math::vec2u pixel, math::vec2f const * constants, uint32 count, EscapeSample * samples)
+{
+	return EscapeJulia<Avx512Float>(view, pixel, constants, count, samples);
+}
+
+uint64 Render::Kernels::EscapeJuliaAvx512D(FractalView const & view, math::vec2u pixel, math::vec2f const * constants, uint32 count, EscapeSample * samples)
+{
+	return EscapeJulia<Avx512Double>(view, pixel, constants, count, samples);
+}
+
+SIMD_TARGET_END()
+
+#endif
@@ -0,0 +1,93 @@
+#include "SimdKernels.hpp"
+
+#if RENDER_X86
+
+#include <emmintrin.h>
+
+SIMD_TARGET_BEGIN("sse2")
+
+#include "SimdEscape.inl"
+
+namespace
+{
+	struct Sse2Float
+	{
+		typedef float	scalar;
+		typedef __m128	vec;
+		typedef __m128	mask;
+
+		static constexpr uint32 LANES = 4u;
+
+		static inline vec	Set(scalar value)				{ return _mm_set1_ps(value); }
+		static inline vec	Load(scalar const * values)		{ return _mm_load_ps(values); }
+		static inline void	Store(scalar * values, vec v)	{ _mm_store_ps(values, v); }
+
+		static inline vec	Add(vec a, vec b)				{ return _mm_add_ps(a, b); }
+		static inline vec	Sub(vec a, vec b)				{ return _mm_sub_ps(a, b); }
+		static inline vec	Mul(vec a, vec b)				{ return _mm_mul_ps(a, b); }
+
+		static inline mask	Greater(vec a, vec b)			{ return _mm_cmpgt_ps(a, b); }
+		static inline mask	Equal(vec a, vec b)				{ return _mm_cmpeq_ps(a, b); }
+		static inline uint32 Bits(mask m)					{ return uint32(_mm_movemask_ps(m)); }
+
+		// SSE2 has no blendv, m ? a : b
+		static inline vec	Select(mask m, vec a, vec b)	{ return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+	};
+
+	struct Sse2Double
+	{
+		typedef double	scalar;
+		typedef __m128d	vec;
+		typedef __m128d	mask;
+
+		static constexpr uint32 LANES = 2u;
+
+		static inline vec	Set(scalar value)				{ return _mm_set1_pd(value); }
+		static inline vec	Load(scalar const * values)		{ return _mm_load_pd(values); }
+		static inline void	Store(scalar * values, vec v)	{ _mm_store_pd(values, v); }
+
+		static inline vec	Add(vec a, vec b)				{ return _mm_add_pd(a, b); }
+		static inline vec	Sub(vec a, vec b)				{ return _mm_sub_pd(a, b); }
+		static inline vec	Mul(vec a, vec b)				{ return _mm_mul_pd(a, b); }
+
+		static inline mask	Greater(vec a, vec b)			{ return _mm_cmpgt_pd(a, b); }
+		static inline mask	Equal(vec a, vec b)				{ return _mm_cmpeq_pd(a, b); }
+		static inline uint32 Bits(mask m)					{ return uint32(_mm_movemask_pd(m)); }
+
+		static inline vec	Select(mask m, vec a, vec b)	{ return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b)); }
+	};
+}
+
+uint64 Render::Kernels::EscapeSpanSse2F(FractalView const & view, uint32 row, uint32 column, uint32 count, EscapeSample * samples)
+{
+	return EscapeSpan<Sse2Float>(view, row, column, count, samples);
+}
+
+uint64 Render::Kernels::EscapeSpanSse2D(FractalView const & view, uint32 row, uint32 column, uint32 count, EscapeSample * samples)
+{
+	return EscapeSpan<Sse2Double>(view, row, column, count, samples);
+}
+
+uint64 Render::Kernels::EscapePixelsSse2F(FractalView const & view, math::vec2u const * pixels, uint32 count, EscapeSample * samples)
+{
+	return EscapePixels<Sse2Float>(view, pixels, count, samples);
+}
+
+uint64 Render::Kernels::EscapePixelsSse2D(FractalView const & view, math::vec2u const * pixels, uint32 count, EscapeSample * samples)
+{
+	return EscapePixels<Sse2Double>(view, pixels, count, samples);
+}
+
+uint64 Render::Kernels::EscapeJuliaSse2F(FractalView const & view, math::vec2u pixel, math::vec2f const * constants, uint32 count, EscapeSample * samples)
+{
+	return EscapeJulia<Sse2Float>(view, pixel, constants, count, samples);
+}
+
+uint64 Render::Kernels::EscapeJuliaSse2D(FractalView const & view, math::vec2u pixel, math::vec2f const * constants, uint32 count, EscapeSample * samples)
+{
+	return EscapeJulia<Sse2Double>(view, pixel, constants, count, samples);
+}
+
+SIMD_TARGET_END()
+
+#endif
@@ -0,0 +1,233 @@
+#pragma once
+
+#include "FractalView.hpp"
+
+#include <Math/MultiDouble.inl>
+#include <Math/FixedPoint.inl>
+
+// Scalar port of MandelbrotFragment.glsl (iteration pass) and ColoringFragment.glsl
+// (colouring pass), any change to the shaders' main loop or colouring has to be mirrored here.
+
+namespace Render
+{
+	constexpr float LIMIT_THRESHOLD = 6.f;	// k_limitThreshold
+	constexpr float COLOR_THRESHOLD = 2.f;	// k_colorThreshold
+
+	struct EscapeSample
+	{
+		uint32	iterations;	// the shader's loop counter when the loop exits
+		float	smooth;		// the shader's last SmoothIteration() before the escape
+	};
+
+	template<typename T>
+	math::vec2<T> inline ComplexSquare(math::vec2<T> z)
+	{
+		math::vec2<T> squared;
+		squared.x = math::sq(z.x) - math::sq(z.y);
+		squared.y = T(2) * z.x * z.y;
+
+		return squared;
+	}
+
+	template<typename T>
+	T inline NextComplexAbsolute(math::vec2<T> z)
+	{
+		return math::sq(z.x) + math::sq(z.y);
+	}
+
+	// (x + y)(x - y) takes one product less than x^2 - y^2 and doubling xy is exact,
+	// which matters once every operation is a handful of double operations
+	template<uint32 N>
+	math::vec2<math::MultiDouble<N>> inline MultiDoubleSquare(math::vec2<math::MultiDouble<N>> z)
+	{
+		math::vec2<math::MultiDouble<N>> squared;
+		squared.x = (z.x + z.y) * (z.x - z.y);
+		squared.y = (z.x * z.y).Scaled(2.);
+
+		return squared;
+	}
+
+	// the escape test and the smoothing only look at the leading components
+	template<uint32 N>
+	math::MultiDouble<N> inline MultiDoubleAbsolute(math::vec2<math::MultiDouble<N>> z)
+	{
+		return math::sq(z.x.components[0]) + math::sq(z.y.components[0]);
+	}
+
+	template<>
+	math::vec2<math::DoubleDouble> inline ComplexSquare(math::vec2<math::DoubleDouble> z)
+	{
+		return MultiDoubleSquare(z);
+	}
+
+	template<>
+	math::vec2<math::QuadDouble> inline ComplexSquare(math::vec2<math::QuadDouble> z)
+	{
+		return MultiDoubleSquare(z);
+	}
+
+	template<>
+	math::DoubleDouble inline NextComplexAbsolute(math::vec2<math::DoubleDouble> z)
+	{
+		return MultiDoubleAbsolute(z);
+	}
+
+	template<>
+	math::QuadDouble inline NextComplexAbsolute(math::vec2<math::QuadDouble> z)
+	{
+		return MultiDoubleAbsolute(z);
+	}
+
+	// with multi-limb numbers a squaring is the cheaper product, from 16 limbs on enough
+	// to pay for the extra additions of 2xy = (x + y)^2 - x^2 - y^2
+	template<uint32 LIMBS>
+	math::vec2<math::FixedPoint<LIMBS>> inline ComplexSquare(math::vec2<math::FixedPoint<LIMBS>> z)
+	{
+		math::FixedPoint<LIMBS> const xx = z.x.Squared();
+		math::FixedPoint<LIMBS> const yy = z.y.Squared();
+
+		math::vec2<math::FixedPoint<LIMBS>> squared;
+		squared.x = xx - yy;
+
+		if (LIMBS >= 16u)
+		{
+			squared.y = (z.x + z.y).Squared() - xx - yy;
+		}
+		else
+		{
+			math::FixedPoint<LIMBS> const xy = z.x * z.y;
+			squared.y = xy + xy;
+		}
+
+		return squared;
+	}
+
+	template<typename T>
+	math::vec2<T> inline PixelToPoint(FractalView const & view, uint32 x, uint32 y)
+	{
+		// UV runs bottom-up on the quad while the buffers are stored top-down
+		math::vec2<T> point{ (T(x) + T(.5)) / T(view.canvas.x),
+							 (T(view.canvas.y - y) - T(.5)) / T(view.canvas.y) };
+
+		point	*= T(view.zoom);
+		point.x	*= T(view.canvas.x) / T(view.canvas.y);
+
+		point	+= math::vec2<T>{ T(view.offset.x), T(view.offset.y) };
+
+		return point;
+	}
+
+	float inline SmoothIteration(float normZ, uint32 iteration)
+	{
+		float logZn  = std::log(normZ) / 2.f;
+		float offset = std::log(logZn / std::log(2.f)) / std::log(2.f);
+
+		return float(iteration) + 1.f - offset;
+	}
+
+	// Closed form membership of the main cardioid and the period-2 bulb, the two
+	// largest interior components of the Mandelbrot set
+	template<typename T>
+	bool inline IsInMainComponents(math::vec2<T> c)
+	{
+		T const x	= c.x - T(.25);
+		T const y2	= math::sq(c.y);
+		T const q	= math::sq(x) + y2;
+
+		return q * (q + x) <= T(.25) * y2 || math::sq(c.x + T(1)) + y2 <= T(.0625);
+	}
+
+	// `saved` receives the iterations that were not run because the pixel was known
+	// to be interior early, either through IsInMainComponents or because the orbit
+	// came back exactly onto the value saved at the last power of two (Brent).
+	// An exact repeat can never escape, so the sample is the same as running to the end.
+	template<typename T>
+	EscapeSample inline Iterate(math::vec2<T> point, FractalView const & view, uint32 & saved)
+	{
+		bool const isMandelbrot = view.fractal == FractalType::MANDELBROT;
+
+		saved = 0u;
+
+		if (isMandelbrot && IsInMainComponents(point))
+		{
+			saved = view.maxIterations;
+			return { view.maxIterations, 0.f };
+		}
+
+		math::vec2<T> constant = isMandelbrot ? point : math::vec2<T>{ T(view.juliaConstant.x), T(view.juliaConstant.y) };
+		math::vec2<T> z		   = isMandelbrot ? math::vec2<T>{} : point;
+		math::vec2<T> cycle	   = z;
+
+		uint32 iteration  = 0u;
+		uint32 checkpoint = 1u;
+
+		for (; iteration < view.maxIterations; ++iteration)
+		{
+			if (NextComplexAbsolute(z) > T(LIMIT_THRESHOLD))
+				break;
+
+			z = ComplexSquare(z) + constant;
+
+			if (z.x == cycle.x && z.y == cycle.y)
+			{
+				saved = view.maxIterations - iteration - 1u;
+				return { view.maxIterations, 0.f };
+			}
+
+			if (iteration + 1u == checkpoint)
+			{
+				cycle		= z;
+				checkpoint <<= 1u;
+			}
+		}
+
+		EscapeSample sample{ iteration, 0.f };
+
+		if (iteration != 0u && iteration < view.maxIterations)
+			sample.smooth = SmoothIteration(float(NextComplexAbsolute(z)), iteration - 1u);
+
+		return sample;
+	}
+
+	template<typename T>
+	EscapeSample inline Iterate(math::vec2<T> point, FractalView const & view)
+	{
+		uint32 saved;
+		return Iterate(point, view, saved);
+	}
+
+	math::vec3f inline Coloring(float iteration, uint32 maxIterations)
+	{
+		return { 0.f, iteration * 1.f / float(maxIterations) * 1.2f, iteration * 1.6f / float(maxIterations) * 2.1f };
+	}
+
+	math::vec3f inline LinearizeColor(EscapeSample sample, uint32 maxIterations)
+	{
+		// pixels that never escaped, or escaped before the first iteration, get the set colour
+		if (sample.iterations == 0u || sample.iterations >= maxIterations)
+			return { 0.f, 0.f, 0.f };
+
+		math::vec3f color1 = Coloring(float(sample.iterations - 1u), maxIterations);
+		math::vec3f color2 = Coloring(sample.smooth, maxIterations);
+
+		float weight = sample.smooth - float(int32(sample.smooth));
+
+		return color1 * (1.f - weight) + color2 * weight;
+	}
+
+	uint32 inline PackColor(math::vec3f color)
+	{
+		auto ToByte = [](float channel) -> uint32
+		{
+			return uint32(std::min(std::max(channel, 0.f), 1.f) * 255.f + .5f);
+		};
+
+		return ToByte(color.r) | (ToByte(color.g) << 8) | (ToByte(color.b) << 16) | (0xFFu << 24);
+	}
+
+	// the whole colouring pass of a pixel, it only depends on the escape sample
+	uint32 inline ShadeSample(EscapeSample sample, uint32 maxIterations, math::vec3f modifier)
+	{
+		return PackColor(LinearizeColor(sample, maxIterations) * modifier);
+	}
+}
@@ -0,0 +1,1130 @@
+#include "FractalEngine.hpp"
+
+double Render::RenderStats::LoadBalance() const
+{
+	if (workerBusy.empty())
+		return 1.;
+
+	Misc::clock::duration total		{0};
+	Misc::clock::duration longest	{0};
+
+	for (auto busy : workerBusy)
+	{
+		total	+= busy;
+		longest	 = std::max(longest, busy);
+	}
+
+	return longest.count() ? double(total.count()) / (double(longest.count()) * workerBusy.size()) : 1.;
+}
+
+Render::FractalEngine::FractalEngine(uint32 threadCount, RenderOptions options):
+	m_threadCount(threadCount ? threadCount : std::max(1u, std::thread::hardware_concurrency())),
+	m_options(options),
+	m_kernel(SelectKernel(options.precision)),
+	m_pool(new WorkStealingPool(m_threadCount)),
+	m_scratch(m_threadCount),
+	m_glitches(m_threadCount)
+{
+}
+
+Render::FractalEngine::RegionResult Render::FractalEngine::RenderSpan(FractalView const & view, IterationBuffer & iterations, ColorBuffer & colors,
+																		uint32 x, uint32 y, uint32 width, WorkerScratch & scratch)
+{
+	RegionResult result{ 0u, 0u, 0u };
+
+	scratch.samples.resize(std::max(scratch.samples.size(), size_t(width)));
+	result.saved = m_kernel.function(view, y, x, width, scratch.samples.data());
+
+	for (uint32 i = 0u; i < width; ++i)
+	{
+		EscapeSample const & sample = scratch.samples[i];
+		size_t const index			= iterations.Index(x + i, y);
+
+		iterations.iterations[index]	= sample.iterations;
+		iterations.smooth[index]		= sample.smooth;
+		colors.pixels[index]			= ShadeSample(sample, view.maxIterations, view.colorModifier);
+
+		result.iterations += sample.iterations;
+	}
+
+	// pixels stopped early still report maxIterations
+	result.iterations -= result.saved;
+
+	return result;
+}
+
+Render::FractalEngine::RegionResult Render::FractalEngine::RenderPixels(FractalView const & view, IterationBuffer & iterations, ColorBuffer & colors,
+																		  WorkerScratch & scratch, uint32 block)
+{
+	RegionResult result{ 0u, 0u, 0u };
+
+	scratch.samples.resize(std::max(scratch.samples.size(), scratch.pixels.size()));
+	result.saved = m_kernel.pixels(view, scratch.pixels.data(), uint32(scratch.pixels.size()), scratch.samples.data());
+
+	for (size_t i = 0u; i < scratch.pixels.size(); ++i)
+	{
+		EscapeSample const & sample = scratch.samples[i];
+		math::vec2u const	 pixel	= scratch.pixels[i];
+		uint32 const		 color	= ShadeSample(sample, view.maxIterations, view.colorModifier);
+
+		result.iterations += sample.iterations;
+
+		if (block == 1u)
+		{
+			size_t const index = iterations.Index(pixel.x, pixel.y);
+
+			iterations.iterations[index]	= sample.iterations;
+			iterations.smooth[index]		= sample.smooth;
+			colors.pixels[index]			= color;
+
+			continue;
+		}
+
+		uint32 const right	= std::min(pixel.x + block, iterations.width);
+		uint32 const bottom	= std::min(pixel.y + block, iterations.height);
+
+		for (uint32 y = pixel.y; y < bottom; ++y)
+		{
+			size_t const first	= iterations.Index(pixel.x, y);
+			size_t const last	= first + (right - pixel.x);
+
+			std::fill(iterations.iterations.begin() + first, iterations.iterations.begin() + last, sample.iterations);
+			std::fill(iterations.smooth.begin() + first, iterations.smooth.begin() + last, sample.smooth);
+			std::fill(colors.pixels.begin() + first, colors.pixels.begin() + last, color);
+		}
+	}
+
+	result.iterations -= result.saved;
+
+	scratch.pixels.clear();
+
+	return result;
+}
+
+Render::FractalEngine::RegionResult Render::FractalEngine::RenderRegion(FractalView const & view, IterationBuffer & iterations, ColorBuffer & colors,
+																		  Tile const & region, WorkerScratch & scratch)
+{
+	RegionResult result{ 0u, 0u, 0u };
+
+	if (m_options.subdivision == Subdivision::BRUTE_FORCE || region.width < 3u || region.height < 3u)
+	{
+		for (uint32 y = region.y; y < region.y + region.height; ++y)
+			result += RenderSpan(view, iterations, colors, region.x, y, region.width, scratch);
+
+		return result;
+	}
+
+	uint32 const right	= region.x + region.width - 1u;
+	uint32 const bottom	= region.y + region.height - 1u;
+
+	// the whole border goes through the kernel at once, columns would leave most lanes idle
+	for (uint32 x = region.x; x <= right; ++x)
+	{
+		scratch.pixels.push_back({ x, region.y });
+		scratch.pixels.push_back({ x, bottom });
+	}
+
+	for (uint32 y = region.y + 1u; y < bottom; ++y)
+	{
+		scratch.pixels.push_back({ region.x, y });
+		scratch.pixels.push_back({ right, y });
+	}
+
+	result += RenderPixels(view, iterations, colors, scratch);
+
+	result += Subdivide(view, iterations, colors, region, scratch);
+
+	return result;
+}
+
+Render::FractalEngine::RegionResult Render::FractalEngine::Subdivide(FractalView const & view, IterationBuffer & iterations, ColorBuffer & colors,
+																	   Tile const & region, WorkerScratch & scratch)
+{
+	constexpr uint32 MIN_SUBDIVIDED = 8u;
+
+	RegionResult result{ 0u, 0u, 0u };
+
+	if (region.width < 3u || region.height < 3u)
+		return result;
+
+	uint32 const right	= region.x + region.width - 1u;
+	uint32 const bottom	= region.y + region.height - 1u;
+
+	// Only the set is filled: it is full, so a border that never escapes encloses no
+	// escaping pixel, while equal escape counts would still differ in their smooth part
+	bool enclosed = true;
+
+	for (uint32 x = region.x; x <= right && enclosed; ++x)
+	{
+		enclosed = iterations.iterations[iterations.Index(x, region.y)] >= view.maxIterations &&
+				   iterations.iterations[iterations.Index(x, bottom)] >= view.maxIterations;
+	}
+
+	for (uint32 y = region.y + 1u; y < bottom && enclosed; ++y)
+	{
+		enclosed = iterations.iterations[iterations.Index(region.x, y)] >= view.maxIterations &&
+				   iterations.iterations[iterations.Index(right, y)] >= view.maxIterations;
+	}
+
+	if (enclosed)
+	{
+		EscapeSample const	inside{ view.maxIterations, 0.f };
+		uint32 const		color = ShadeSample(inside, view.maxIterations, view.colorModifier);
+
+		for (uint32 y = region.y + 1u; y < bottom; ++y)
+		{
+			size_t const first = iterations.Index(region.x + 1u, y);
+			size_t const last  = iterations.Index(right, y);
+
+			std::fill(iterations.iterations.begin() + first, iterations.iterations.begin() + last, inside.iterations);
+			std::fill(iterations.smooth.begin() + first, iterations.smooth.begin() + last, inside.smooth);
+			std::fill(colors.pixels.begin() + first, colors.pixels.begin() + last, color);
+		}
+
+		result.filled = uint64(region.width - 2u) * (region.height - 2u);
+
+		return result;
+	}
+
+	if (region.width <= MIN_SUBDIVIDED || region.height <= MIN_SUBDIVIDED)
+	{
+		for (uint32 y = region.y + 1u; y < bottom; ++y)
+		{
+			for (uint32 x = region.x + 1u; x < right; ++x)
+				scratch.pixels.push_back({ x, y });
+		}
+
+		result += RenderPixels(view, iterations, colors, scratch);
+
+		return result;
+	}
+
+	// the split lines complete the borders of the four quarters
+	uint32 const middleX = region.x + region.width / 2u;
+	uint32 const middleY = region.y + region.height / 2u;
+
+	for (uint32 x = region.x + 1u; x < right; ++x)
+		scratch.pixels.push_back({ x, middleY });
+
+	for (uint32 y = region.y + 1u; y < bottom; ++y)
+	{
+		if (y != middleY)
+			scratch.pixels.push_back({ middleX, y });
+	}
+
+	result += RenderPixels(view, iterations, colors, scratch);
+
+	Tile const quarters[4] =
+	{
+		{ region.x,	region.y,	middleX - region.x + 1u,	middleY - region.y + 1u },
+		{ middleX,	region.y,	right - middleX + 1u,		middleY - region.y + 1u },
+		{ region.x,	middleY,	middleX - region.x + 1u,	bottom - middleY + 1u	},
+		{ middleX,	middleY,	right - middleX + 1u,		bottom - middleY + 1u	},
+	};
+
+	for (auto const & quarter : quarters)
+		result += Subdivide(view, iterations, colors, quarter, scratch);
+
+	return result;
+}
+
+void Render::FractalEngine::RenderStaticRows(FractalView const & view, IterationBuffer & iterations, ColorBuffer & colors, RenderStats & stats)
+{
+	uint32 const threadCount	= std::max(1u, std::min(m_threadCount, view.canvas.y));
+	uint32 const rowsPerThread	= (view.canvas.y + threadCount - 1u) / threadCount;
+
+	std::vector<RegionResult> results(threadCount, RegionResult{ 0u, 0u, 0u });
+	std::vector<std::thread>  workers;
+	workers.reserve(threadCount);
+
+	stats.threads = threadCount;
+	stats.workerBusy.assign(threadCount, Misc::clock::duration{0});
+
+	for (uint32 i = 0u; i < threadCount; ++i)
+	{
+		uint32 const firstRow	= std::min(i * rowsPerThread, view.canvas.y);
+		uint32 const lastRow	= std::min(firstRow + rowsPerThread, view.canvas.y);
+
+		workers.emplace_back(
+			[&, i, firstRow, lastRow]()
+			{
+				Misc::Stopwatch stopwatch;
+				stopwatch.Start();
+
+				results[i] = RenderRegion(view, iterations, colors, { 0u, firstRow, view.canvas.x, lastRow - firstRow }, m_scratch[i]);
+
+				stopwatch.Stop();
+				stats.workerBusy[i] = stopwatch.GetTime();
+			});
+	}
+
+	for (auto & worker : workers)
+		worker.join();
+
+	for (auto const & result : results)
+	{
+		stats.iterations		+= result.iterations;
+		stats.iterationsSaved	+= result.saved;
+		stats.filled			+= result.filled;
+	}
+}
+
+void Render::FractalEngine::RenderTiles(FractalView const & view, std::vector<Tile> const & regions,
+										IterationBuffer & iterations, ColorBuffer & colors, RenderStats & stats)
+{
+	std::vector<Tile> tiles;
+
+	for (auto const & region : regions)
+	{
+		for (Tile tile : SplitIntoTiles(region.width, region.height, m_options.tileSize))
+		{
+			tile.x += region.x;
+			tile.y += region.y;
+
+			tiles.push_back(tile);
+		}
+	}
+
+	uint64 const stealsBefore = m_pool->GetStealCount();
+
+	std::vector<uint64> filled(tiles.size(), 0u);
+	std::vector<uint64> saved(tiles.size(), 0u);
+
+	stats.threads = m_pool->GetWorkerCount();
+	stats.tiles.resize(tiles.size());
+
+	std::vector<WorkStealingPool::Task> tasks;
+	tasks.reserve(tiles.size());
+
+	for (size_t i = 0u; i < tiles.size(); ++i)
+	{
+		tasks.emplace_back(
+			[&, i](uint32 worker)
+			{
+				Misc::Stopwatch stopwatch;
+				stopwatch.Start();
+
+				RegionResult const result = RenderRegion(view, iterations, colors, tiles[i], m_scratch[worker]);
+
+				stopwatch.Stop();
+
+				stats.tiles[i]	= { tiles[i], worker, result.iterations, stopwatch.GetTime() };
+				filled[i]		= result.filled;
+				saved[i]		= result.saved;
+			});
+	}
+
+	m_pool->Run(std::move(tasks));
+
+	stats.steals = m_pool->GetStealCount() - stealsBefore;
+	stats.workerBusy.assign(stats.threads, Misc::clock::duration{0});
+
+	for (size_t i = 0u; i < tiles.size(); ++i)
+	{
+		stats.iterations						+= stats.tiles[i].iterations;
+		stats.filled							+= filled[i];
+		stats.iterationsSaved					+= saved[i];
+		stats.workerBusy[stats.tiles[i].worker]	+= stats.tiles[i].elapsed;
+	}
+}
+
+Render::RenderStats Render::FractalEngine::RenderFrame(FractalView const & view, IterationBuffer & iterations, ColorBuffer & colors)
+{
+	FitKernel(view);
+
+	Misc::Stopwatch stopwatch;
+	stopwatch.Start();
+
+	iterations.Resize(view.canvas.x, view.canvas.y);
+	colors.Resize(view.canvas.x, view.canvas.y);
+
+	RenderStats stats;
+	stats.pixels = view.PixelCount();
+	stats.kernel = m_kernel.name;
+
+	if (m_options.scheduling == Scheduling::STATIC_ROWS)
+		RenderStaticRows(view, iterations, colors, stats);
+	else
+		RenderTiles(view, { Tile{ 0u, 0u, view.canvas.x, view.canvas.y } }, iterations, colors, stats);
+
+	stopwatch.Stop();
+	stats.elapsed = stopwatch.GetTime();
+
+	m_lastStats = stats;
+
+	return stats;
+}
+
+Render::RenderStats Render::FractalEngine::RenderJuliaSweep(FractalView const & view, std::vector<math::vec2f> const & constants,
+															std::vector<ColorBuffer> & colors)
+{
+	// sets per task, and per kernel call when the lanes are packed with constants
+	constexpr uint32 SWEEP_GROUP = 64u;
+
+	// Neighbouring pixels of one set diverge less than one pixel of neighbouring sets,
+	// wider thumbnails are better off with the span kernel run per set
+	constexpr uint32 PACKED_MAX_WIDTH = 32u;
+
+	FractalView julia = view;
+	julia.fractal = FractalType::JULIA;
+
+	// the precision has to hold the orbits of the largest constant
+	for (auto const & constant : constants)
+	{
+		if (std::abs(constant.x) + std::abs(constant.y) > std::abs(julia.juliaConstant.x) + std::abs(julia.juliaConstant.y))
+			julia.juliaConstant = constant;
+	}
+
+	FitKernel(julia);
+
+	Misc::Stopwatch stopwatch;
+	stopwatch.Start();
+
+	colors.resize(constants.size());
+
+	for (auto & thumbnail : colors)
+		thumbnail.Resize(julia.canvas.x, julia.canvas.y);
+
+	RenderStats stats;
+	stats.pixels	= julia.PixelCount() * constants.size();
+	stats.kernel	= m_kernel.name;
+	stats.threads	= m_pool->GetWorkerCount();
+
+	std::vector<Tile> const tiles		= SplitIntoTiles(julia.canvas.x, julia.canvas.y, m_options.tileSize);
+	size_t const			groups		= (constants.size() + SWEEP_GROUP - 1u) / SWEEP_GROUP;
+	bool const				packLanes	= julia.canvas.x <= PACKED_MAX_WIDTH;
+
+	std::vector<RegionResult>			results(groups * tiles.size(), RegionResult{ 0u, 0u, 0u });
+	std::vector<uint32>					workers(results.size(), 0u);
+	std::vector<Misc::clock::duration>	busy(results.size());
+
+	uint64 const stealsBefore = m_pool->GetStealCount();
+
+	std::vector<WorkStealingPool::Task> tasks;
+	tasks.reserve(results.size());
+
+	for (size_t group = 0u; group < groups; ++group)
+	{
+		for (size_t tile = 0u; tile < tiles.size(); ++tile)
+		{
+			tasks.emplace_back(
+				[&, group, tile](uint32 worker)
+				{
+					Misc::Stopwatch taskTime;
+					taskTime.Start();
+
+					size_t const		first	= group * SWEEP_GROUP;
+					uint32 const		count	= uint32(std::min<size_t>(SWEEP_GROUP, constants.size() - first));
+					Tile const &		region	= tiles[tile];
+					RegionResult &		result	= results[group * tiles.size() + tile];
+					WorkerScratch &		scratch	= m_scratch[worker];
+
+					scratch.samples.resize(std::max<size_t>({ scratch.samples.size(), SWEEP_GROUP, region.width }));
+
+					if (packLanes)
+					{
+						for (uint32 y = region.y; y < region.y + region.height; ++y)
+						{
+							for (uint32 x = region.x; x < region.x + region.width; ++x)
+							{
+								result.saved += m_kernel.julia(julia, { x, y }, constants.data() + first, count, scratch.samples.data());
+
+								for (uint32 i = 0u; i < count; ++i)
+								{
+									ColorBuffer & thumbnail = colors[first + i];
+
+									thumbnail.pixels[thumbnail.Index(x, y)] = ShadeSample(scratch.samples[i], julia.maxIterations, julia.colorModifier);
+									result.iterations += scratch.samples[i].iterations;
+								}
+							}
+						}
+					}
+					else
+					{
+						FractalView set = julia;
+
+						for (uint32 i = 0u; i < count; ++i)
+						{
+							ColorBuffer & thumbnail = colors[first + i];
+							set.juliaConstant		= constants[first + i];
+
+							for (uint32 y = region.y; y < region.y + region.height; ++y)
+							{
+								result.saved += m_kernel.function(set, y, region.x, region.width, scratch.samples.data());
+
+								for (uint32 x = 0u; x < region.width; ++x)
+								{
+									thumbnail.pixels[thumbnail.Index(region.x + x, y)] = ShadeSample(scratch.samples[x], julia.maxIterations, julia.colorModifier);
+									result.iterations += scratch.samples[x].iterations;
+								}
+							}
+						}
+					}
+
+					// pixels stopped early still report maxIterations
+					result.iterations -= result.saved;
+
+					taskTime.Stop();
+
+					workers[group * tiles.size() + tile]	= worker;
+					busy[group * tiles.size() + tile]		= taskTime.GetTime();
+				});
+		}
+	}
+
+	m_pool->Run(std::move(tasks));
+
+	stats.steals = m_pool->GetStealCount() - stealsBefore;
+	stats.workerBusy.assign(stats.threads, Misc::clock::duration{0});
+
+	for (size_t i = 0u; i < results.size(); ++i)
+	{
+		stats.iterations			+= results[i].iterations;
+		stats.iterationsSaved		+= results[i].saved;
+		stats.workerBusy[workers[i]]	+= busy[i];
+	}
+
+	stopwatch.Stop();
+	stats.elapsed = stopwatch.GetTime();
+
+	m_lastStats = stats;
+
+	return stats;
+}
+
+Render::RenderStats Render::FractalEngine::RenderDeepFrame(DeepView const & view, IterationBuffer & iterations, ColorBuffer & colors)
+{
+	constexpr uint32 MAX_REFERENCES = 32u;
+	constexpr size_t PIXELS_PER_TASK = 4096u;
+	constexpr size_t OWN_ORBITS_PER_TASK = 4u;
+
+	Misc::Stopwatch stopwatch;
+	stopwatch.Start();
+
+	iterations.Resize(view.canvas.x, view.canvas.y);
+	colors.Resize(view.canvas.x, view.canvas.y);
+
+	RenderStats stats;
+	stats.pixels	= view.PixelCount();
+	stats.kernel	= "Perturbation double";
+	stats.threads	= m_pool->GetWorkerCount();
+	stats.workerBusy.assign(stats.threads, Misc::clock::duration{0});
+
+	std::vector<uint32> pending(size_t(view.PixelCount()));
+
+	for (size_t i = 0u; i < pending.size(); ++i)
+		pending[i] = uint32(i);
+
+	math::vec2u referencePixel{ view.canvas.x / 2u, view.canvas.y / 2u };
+
+	while (!pending.empty() && stats.references < MAX_REFERENCES)
+	{
+		Misc::Stopwatch referenceWatch;
+		referenceWatch.Start();
+
+		ReferenceOrbit const reference = ComputeReferenceOrbit(view, referencePixel);
+
+		SeriesApproximation const series = m_options.skipSeries ?
+			ComputeSeriesApproximation(view, reference) : SeriesApproximation();
+
+		referenceWatch.Stop();
+
+		size_t const iterated = pending.size();
+
+		if (!stats.references)
+			stats.seriesSkip = series.skipped;
+
+		stats.skippedIterations += uint64(series.skipped) * pending.size();
+
+		stats.referenceTime		+= referenceWatch.GetTime();
+		stats.referenceLimbs	 = std::max(stats.referenceLimbs, reference.limbs);
+
+		++stats.references;
+
+		std::vector<WorkStealingPool::Task> tasks;
+
+		for (size_t first = 0u; first < pending.size(); first += PIXELS_PER_TASK)
+		{
+			size_t const last = std::min(first + PIXELS_PER_TASK, pending.size());
+
+			tasks.emplace_back(
+				[&, first, last](uint32 worker)
+				{
+					Misc::Stopwatch taskWatch;
+					taskWatch.Start();
+
+					for (size_t i = first; i < last; ++i)
+					{
+						uint32 const index = pending[i];
+						EscapeSample sample;
+
+						if (!IteratePerturbed(view, reference, series, index % view.canvas.x, index / view.canvas.x, sample))
+							m_glitches[worker].push_back(index);
+
+						iterations.iterations[index]	= sample.iterations;
+						iterations.smooth[index]		= sample.smooth;
+						colors.pixels[index]			= ShadeSample(sample, view.maxIterations, view.colorModifier);
+					}
+
+					taskWatch.Stop();
+					stats.workerBusy[worker] += taskWatch.GetTime();
+				});
+		}
+
+		m_pool->Run(std::move(tasks));
+
+		pending.clear();
+
+		for (auto & glitches : m_glitches)
+		{
+			pending.insert(pending.end(), glitches.begin(), glitches.end());
+			glitches.clear();
+		}
+
+		stats.glitchedPixels += pending.size();
+
+		// Pixels that glitch on their own rounding error rather than on the reference
+		// glitch against the next one as well, they are left to their own orbits.
+		if (pending.empty() || pending.size() * 2u > iterated)
+			break;
+
+		// a glitched pixel cannot glitch against its own orbit, so every pass settles at least one
+		std::sort(pending.begin(), pending.end());
+
+		uint32 const next	= pending[pending.size() / 2u];
+		referencePixel		= { next % view.canvas.x, next / view.canvas.x };
+	}
+
+	// whatever is still glitched is iterated as its own reference, which follows the
+	// point in full precision and can not glitch against itself
+	std::vector<WorkStealingPool::Task> tasks;
+
+	for (size_t first = 0u; first < pending.size(); first += OWN_ORBITS_PER_TASK)
+	{
+		size_t const last = std::min(first + OWN_ORBITS_PER_TASK, pending.size());
+
+		tasks.emplace_back(
+			[&, first, last](uint32 worker)
+			{
+				Misc::Stopwatch taskWatch;
+				taskWatch.Start();
+
+				for (size_t i = first; i < last; ++i)
+				{
+					uint32 const			index	= pending[i];
+					math::vec2u const		pixel	{ index % view.canvas.x, index / view.canvas.x };
+					ReferenceOrbit const	orbit	= ComputeReferenceOrbit(view, pixel);
+					EscapeSample			sample;
+
+					IteratePerturbed(view, orbit, SeriesApproximation(), pixel.x, pixel.y, sample);
+
+					iterations.iterations[index]	= sample.iterations;
+					iterations.smooth[index]		= sample.smooth;
+					colors.pixels[index]			= ShadeSample(sample, view.maxIterations, view.colorModifier);
+				}
+
+				taskWatch.Stop();
+				stats.workerBusy[worker] += taskWatch.GetTime();
+			});
+	}
+
+	m_pool->Run(std::move(tasks));
+
+	stats.ownOrbits = pending.size();
+
+	for (size_t i = 0u; i < iterations.iterations.size(); ++i)
+		stats.iterations += iterations.iterations[i];
+
+	stopwatch.Stop();
+	stats.elapsed = stopwatch.GetTime();
+
+	m_lastStats = stats;
+
+	return stats;
+}
+
+void Render::FractalEngine::RecolorRegion(FractalView const & view, IterationBuffer const & iterations, ColorBuffer & colors, Tile const & region)
+{
+	constexpr uint32 ROWS_PER_TASK = 32u;
+
+	std::vector<WorkStealingPool::Task> tasks;
+
+	for (uint32 first = region.y; first < region.y + region.height; first += ROWS_PER_TASK)
+	{
+		tasks.emplace_back(
+			[&, first](uint32)
+			{
+				uint32 const last = std::min(first + ROWS_PER_TASK, region.y + region.height);
+
+				for (uint32 y = first; y < last; ++y)
+				{
+					size_t const begin = iterations.Index(region.x, y);
+
+					for (size_t i = begin; i < begin + region.width; ++i)
+					{
+						EscapeSample const sample{ iterations.iterations[i], iterations.smooth[i] };
+						colors.pixels[i] = ShadeSample(sample, view.maxIterations, view.colorModifier);
+					}
+				}
+			});
+	}
+
+	m_pool->Run(std::move(tasks));
+}
+
+Render::RenderStats Render::FractalEngine::Recolor(FractalView const & view, IterationBuffer const & iterations, ColorBuffer & colors)
+{
+	Misc::Stopwatch stopwatch;
+	stopwatch.Start();
+
+	colors.Resize(iterations.width, iterations.height);
+
+	RecolorRegion(view, iterations, colors, { 0u, 0u, iterations.width, iterations.height });
+
+	RenderStats stats;
+	stats.pixels	= uint64(iterations.width) * iterations.height;
+	stats.kernel	= "Recolor";
+	stats.threads	= m_pool->GetWorkerCount();
+
+	stopwatch.Stop();
+	stats.elapsed = stopwatch.GetTime();
+
+	return stats;
+}
+
+void Render::FractalEngine::FitKernel(FractalView const & view)
+{
+	if (!m_options.fitPrecision)
+		return;
+
+	Precision const precision = FitPrecision(view);
+
+	// a frame shifted from samples of another precision would mix both
+	if (precision != m_kernel.precision)
+	{
+		m_kernel	= SelectKernel(precision);
+		m_panBuffer	= nullptr;
+	}
+}
+
+bool Render::FractalEngine::ShiftPanned(FractalView const & view, IterationBuffer & iterations, ColorBuffer & colors, RenderStats & stats)
+{
+	// the offset has to land within this fraction of a pixel from a whole shift
+	constexpr double SHIFT_TOLERANCE = 1e-3;
+
+	FractalView const	previous	= m_panView;
+	bool const			retained	= m_panBuffer == &iterations;
+
+	m_panView	= view;
+	m_panBuffer	= &iterations;
+
+	double const pixelSpan	= double(view.zoom) / double(view.canvas.y);
+	double const shiftX		= (double(view.offset.x) - double(previous.offset.x)) / pixelSpan;
+	double const shiftY		= (double(view.offset.y) - double(previous.offset.y)) / pixelSpan;
+
+	int64 const dx = int64(std::round(shiftX));
+	int64 const dy = int64(std::round(shiftY));
+
+	// the escape samples decide, the colours of the kept pixels are redone when only the modifier differs
+	FractalView moved	= previous;
+	moved.offset		= view.offset;
+
+	bool const recolor = previous.colorModifier.x != view.colorModifier.x ||
+						 previous.colorModifier.y != view.colorModifier.y ||
+						 previous.colorModifier.z != view.colorModifier.z;
+
+	bool const shiftable = retained && moved.SharesEscape(view) &&
+		iterations.width == view.canvas.x && iterations.height == view.canvas.y &&
+		colors.width == view.canvas.x && colors.height == view.canvas.y &&
+		std::abs(shiftX - double(dx)) < SHIFT_TOLERANCE && std::abs(shiftY - double(dy)) < SHIFT_TOLERANCE &&
+		std::abs(dx) < int64(view.canvas.x) && std::abs(dy) < int64(view.canvas.y);
+
+	if (!shiftable)
+		return false;
+
+	uint32 const width	= view.canvas.x;
+	uint32 const height	= view.canvas.y;
+	uint32 const kept	= width - uint32(std::abs(dx));
+
+	// new pixel (x, y) is the old (x + dx, y - dy), rows are walked away from their source
+	// so a row is never overwritten before it was moved
+	uint32 const sourceX	= dx > 0 ? uint32(dx) : 0u;
+	uint32 const targetX	= dx < 0 ? uint32(-dx) : 0u;
+	uint32 const firstRow	= dy > 0 ? uint32(dy) : 0u;
+	uint32 const lastRow	= dy < 0 ? height - uint32(-dy) : height;
+
+	auto Shift = [&](auto & pixels)
+	{
+		for (uint32 i = 0u; i < lastRow - firstRow; ++i)
+		{
+			uint32 const y = dy > 0 ? lastRow - 1u - i : firstRow + i;
+
+			auto * target = pixels.data() + size_t(y) * width + targetX;
+			auto * source = pixels.data() + size_t(int64(y) - dy) * width + sourceX;
+
+			std::memmove(target, source, kept * sizeof(*target));
+		}
+	};
+
+	Shift(iterations.iterations);
+	Shift(iterations.smooth);
+
+	if (recolor)
+		RecolorRegion(view, iterations, colors, { targetX, firstRow, kept, lastRow - firstRow });
+	else
+		Shift(colors.pixels);
+
+	stats.pixels = view.PixelCount();
+	stats.kernel = m_kernel.name;
+	stats.reused = uint64(kept) * (lastRow - firstRow);
+
+	// the exposed column strip runs the full height, the row strip only spans the kept columns
+	std::vector<Tile> exposed;
+
+	if (dx)
+		exposed.push_back({ dx > 0 ? kept : 0u, 0u, uint32(std::abs(dx)), height });
+
+	if (dy)
+		exposed.push_back({ targetX, dy > 0 ? 0u : lastRow, kept, height - (lastRow - firstRow) });
+
+	RenderTiles(view, exposed, iterations, colors, stats);
+
+	return true;
+}
+
+Render::RenderStats Render::FractalEngine::RenderPannedFrame(FractalView const & view, IterationBuffer & iterations, ColorBuffer & colors)
+{
+	FitKernel(view);
+
+	Misc::Stopwatch stopwatch;
+	stopwatch.Start();
+
+	RenderStats stats;
+
+	if (!ShiftPanned(view, iterations, colors, stats))
+		return RenderFrame(view, iterations, colors);
+
+	stopwatch.Stop();
+	stats.elapsed = stopwatch.GetTime();
+
+	m_lastStats = stats;
+
+	return stats;
+}
+
+Render::RenderStats Render::FractalEngine::RenderProgressiveFrame(FractalView const & view, IterationBuffer & iterations, ColorBuffer & colors,
+																   CancellationToken const & token, PassCallback const & onPass)
+{
+	FitKernel(view);
+
+	// a multiple of every block size, so a task always owns the rows its blocks fill
+	constexpr uint32 ROWS_PER_TASK	= 16u;
+	constexpr uint32 FIRST_BLOCK	= 4u;
+
+	Misc::Stopwatch stopwatch;
+	stopwatch.Start();
+
+	RenderStats stats;
+
+	if (ShiftPanned(view, iterations, colors, stats))
+	{
+		stopwatch.Stop();
+
+		stats.passes		= 1u;
+		stats.elapsed		= stopwatch.GetTime();
+		stats.firstImage	= stats.elapsed;
+
+		if (onPass)
+			onPass(stats);
+
+		m_lastStats = stats;
+
+		return stats;
+	}
+
+	iterations.Resize(view.canvas.x, view.canvas.y);
+	colors.Resize(view.canvas.x, view.canvas.y);
+
+	stats.pixels	= view.PixelCount();
+	stats.kernel	= m_kernel.name;
+	stats.threads	= m_pool->GetWorkerCount();
+	stats.workerBusy.assign(stats.threads, Misc::clock::duration{0});
+
+	std::vector<RegionResult> results;
+
+	for (uint32 block = FIRST_BLOCK; block && !stats.cancelled; block /= 2u)
+	{
+		// samples on the grid of the previous pass are already there
+		uint32 const coarser = block == FIRST_BLOCK ? 0u : block * 2u;
+
+		results.assign((view.canvas.y + ROWS_PER_TASK - 1u) / ROWS_PER_TASK, RegionResult{ 0u, 0u, 0u });
+
+		std::vector<WorkStealingPool::Task> tasks;
+		tasks.reserve(results.size());
+
+		for (uint32 task = 0u; task < results.size(); ++task)
+		{
+			tasks.emplace_back(
+				[&, task, block, coarser](uint32 worker)
+				{
+					Misc::Stopwatch taskWatch;
+					taskWatch.Start();
+
+					WorkerScratch & scratch = m_scratch[worker];
+					uint32 const	last	= std::min((task + 1u) * ROWS_PER_TASK, view.canvas.y);
+
+					for (uint32 y = task * ROWS_PER_TASK; y < last && !token.IsCancelled(); y += block)
+					{
+						bool const coarseRow = coarser && y % coarser == 0u;
+
+						// the rows the last pass adds whole still go through the contiguous kernel
+						if (block == 1u && !coarseRow)
+						{
+							results[task] += RenderSpan(view, iterations, colors, 0u, y, view.canvas.x, scratch);
+							continue;
+						}
+
+						for (uint32 x = 0u; x < view.canvas.x; x += block)
+						{
+							if (!coarseRow || x % coarser)
+								scratch.pixels.push_back({ x, y });
+						}
+
+						results[task] += RenderPixels(view, iterations, colors, scratch, block);
+					}
+
+					taskWatch.Stop();
+					stats.workerBusy[worker] += taskWatch.GetTime();
+				});
+		}
+
+		m_pool->Run(std::move(tasks));
+
+		for (auto const & result : results)
+		{
+			stats.iterations		+= result.iterations;
+			stats.iterationsSaved	+= result.saved;
+		}
+
+		stopwatch.Stop();
+
+		stats.cancelled = token.IsCancelled();
+		stats.elapsed	= stopwatch.GetTime();
+
+		if (stats.cancelled)
+			break;
+
+		if (!stats.passes++)
+			stats.firstImage = stats.elapsed;
+
+		if (onPass)
+			onPass(stats);
+	}
+
+	// a partial frame cannot be shifted by the next pan
+	if (stats.cancelled)
+		m_panBuffer = nullptr;
+
+	stopwatch.Stop();
+	stats.elapsed = stopwatch.GetTime();
+
+	m_lastStats = stats;
+
+	return stats;
+}
+
+Render::RenderStats Render::FractalEngine::RenderCachedFrame(FractalView const & view, TileCache & cache,
+															  IterationBuffer & iterations, ColorBuffer & colors)
+{
+	FitKernel(view);
+
+	Misc::Stopwatch stopwatch;
+	stopwatch.Start();
+
+	iterations.Resize(view.canvas.x, view.canvas.y);
+	colors.Resize(view.canvas.x, view.canvas.y);
+
+	RenderStats stats;
+	stats.pixels	= view.PixelCount();
+	stats.kernel	= m_kernel.name;
+	stats.threads	= m_pool->GetWorkerCount();
+
+	double const pixelSpan	= double(view.zoom) / double(view.canvas.y);
+	int32 const	 level		= std::max(0, int32(std::ceil(std::log2(CACHE_ROOT_SPAN / (CACHE_TILE_SIZE * pixelSpan)))));
+	double const tileSpan	= std::ldexp(CACHE_ROOT_SPAN, -level);
+
+	// the tile coordinate only grows along a row and only shrinks down a column,
+	// so every tile covers one contiguous range of columns and one of rows
+	struct TileRange
+	{
+		int64	tile;
+		uint32	first, last;
+	};
+
+	std::vector<TileRange>	columns, rows;
+	std::vector<uint32>		columnSamples(view.canvas.x);
+	std::vector<uint32>		rowSamples(view.canvas.y);
+
+	auto Locate = [tileSpan](double position, uint32 pixel, std::vector<TileRange> & ranges) -> uint32
+	{
+		double const scaled	= position / tileSpan;
+		int64 const	 tile	= int64(std::floor(scaled));
+
+		if (ranges.empty() || ranges.back().tile != tile)
+			ranges.push_back({ tile, pixel, pixel });
+
+		++ranges.back().last;
+
+		return std::min(CACHE_TILE_SIZE - 1u, uint32((scaled - double(tile)) * CACHE_TILE_SIZE));
+	};
+
+	// pixel centres, as in PixelToPoint
+	for (uint32 x = 0u; x < view.canvas.x; ++x)
+	{
+		double const re = double(view.offset.x) + (double(x) + .5) / double(view.canvas.y) * double(view.zoom);
+		columnSamples[x] = Locate(re, x, columns);
+	}
+
+	// tile rows are stored top-down as well
+	for (uint32 y = 0u; y < view.canvas.y; ++y)
+	{
+		double const im = double(view.offset.y) + (double(view.canvas.y - y) - .5) / double(view.canvas.y) * double(view.zoom);
+		rowSamples[y] = CACHE_TILE_SIZE - 1u - Locate(im, y, rows);
+	}
+
+	size_t const tileCount = columns.size() * rows.size();
+
+	std::vector<byte>	hits(tileCount, 0u);
+	std::vector<uint64>	saved(tileCount, 0u);
+
+	stats.tiles.resize(tileCount);
+
+	std::vector<WorkStealingPool::Task> tasks;
+	tasks.reserve(tileCount);
+
+	for (size_t i = 0u; i < tileCount; ++i)
+	{
+		tasks.emplace_back(
+			[&, i](uint32 worker)
+			{
+				Misc::Stopwatch tileWatch;
+				tileWatch.Start();
+
+				TileRange const & column	= columns[i % columns.size()];
+				TileRange const & row		= rows[i / columns.size()];
+
+				TileKey const key = TileKey::FromView(view, m_kernel.precision, level, column.tile, row.tile);
+
+				Misc::MappedFile	file;
+				TileSamples			samples;
+				uint64				iterationCount = 0u;
+
+				if (cache.Load(key, file, samples))
+				{
+					hits[i] = 1u;
+				}
+				else
+				{
+					FractalView const	tileView	= key.ToView();
+					WorkerScratch &		scratch		= m_scratch[worker];
+					IterationBuffer &	tile		= scratch.tile;
+
+					tile.Resize(CACHE_TILE_SIZE, CACHE_TILE_SIZE);
+					scratch.samples.resize(std::max(scratch.samples.size(), size_t(CACHE_TILE_SIZE)));
+
+					for (uint32 y = 0u; y < CACHE_TILE_SIZE; ++y)
+					{
+						saved[i] += m_kernel.function(tileView, y, 0u, CACHE_TILE_SIZE, scratch.samples.data());
+
+						for (uint32 x = 0u; x < CACHE_TILE_SIZE; ++x)
+						{
+							tile.iterations[tile.Index(x, y)]	= scratch.samples[x].iterations;
+							tile.smooth[tile.Index(x, y)]		= scratch.samples[x].smooth;
+
+							iterationCount += scratch.samples[x].iterations;
+						}
+					}
+
+					iterationCount -= saved[i];
+
+					cache.Store(key, tile.iterations.data(), tile.smooth.data());
+
+					samples = { tile.iterations.data(), tile.smooth.data() };
+				}
+
+				for (uint32 y = row.first; y < row.last; ++y)
+				{
+					for (uint32 x = column.first; x < column.last; ++x)
+					{
+						uint32 const	   sample	= rowSamples[y] * CACHE_TILE_SIZE + columnSamples[x];
+						EscapeSample const escape	{ samples.iterations[sample], samples.smooth[sample] };
+						size_t const	   index	= iterations.Index(x, y);
+
+						iterations.iterations[index]	= escape.iterations;
+						iterations.smooth[index]		= escape.smooth;
+						colors.pixels[index]			= ShadeSample(escape, view.maxIterations, view.colorModifier);
+					}
+				}
+
+				tileWatch.Stop();
+
+				Tile const pixels{ column.first, row.first, column.last - column.first, row.last - row.first };
+				stats.tiles[i] = { pixels, worker, iterationCount, tileWatch.GetTime() };
+			});
+	}
+
+	m_pool->Run(std::move(tasks));
+
+	stats.workerBusy.assign(stats.threads, Misc::clock::duration{0});
+
+	for (size_t i = 0u; i < tileCount; ++i)
+	{
+		stats.iterations						+= stats.tiles[i].iterations;
+		stats.iterationsSaved					+= saved[i];
+		stats.cacheHits							+= hits[i];
+		stats.workerBusy[stats.tiles[i].worker]	+= stats.tiles[i].elapsed;
+	}
+
+	stats.cacheMisses = tileCount - stats.cacheHits;
+
+	stopwatch.Stop();
+	stats.elapsed = stopwatch.GetTime();
+
+	m_lastStats = stats;
+
+	return stats;
+}
+
+void Render::FractalEngine::SetOptions(RenderOptions options)
+{
+	m_options	= options;
+	m_kernel	= SelectKernel(options.precision);
+	m_panBuffer	= nullptr;
+}
+
+void Render::FractalEngine::SetPrecision(Precision precision, InstructionSet limit)
+{
+	m_options.precision = precision;
+	m_kernel			= SelectKernel(precision, limit);
+	m_panBuffer			= nullptr;
+}
+
+uint32 Render::FractalEngine::GetThreadCount() const
+{
+	return m_threadCount;
+}
+
+Render::RenderOptions Render::FractalEngine::GetOptions() const
+{
+	return m_options;
+}
+
+Render::EscapeKernel Render::FractalEngine::GetKernel() const
+{
+	return m_kernel;
+}
+
+Render::RenderStats Render::FractalEngine::GetLastStats() const
+{
+	return m_lastStats;
+}
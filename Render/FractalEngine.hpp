@@ -0,0 +1,203 @@
+#pragma once
+
+#include "EscapeTime.hpp"
+#include "RenderBuffer.hpp"
+#include "SimdKernels.hpp"
+#include "TileScheduler.hpp"
+#include "Perturbation.hpp"
+#include "TileCache.hpp"
+#include "CancellationToken.hpp"
+
+#include <Utils/Stopwatch.h>
+
+namespace Render
+{
+	enum class Scheduling:
+		byte
+	{
+		STATIC_ROWS,	// one contiguous band of rows per thread
+		WORK_STEALING	// square tiles on the work-stealing pool
+	};
+
+	enum class Subdivision:
+		byte
+	{
+		BRUTE_FORCE,	// every pixel is iterated
+		MARIANI_SILVER	// rectangles whose border never escapes are filled without iterating
+	};
+
+	struct RenderOptions
+	{
+		Scheduling	scheduling		{ Scheduling::WORK_STEALING };
+		Subdivision	subdivision		{ Subdivision::BRUTE_FORCE };
+		uint32		tileSize		{ 64u };
+		Precision	precision		{ Precision::FLOAT };
+		bool		fitPrecision	{ true };	// every frame picks its own with FitPrecision, precision is ignored
+		bool		skipSeries		{ true };	// series approximation on deep frames
+	};
+
+	struct RenderStats
+	{
+		uint64					pixels			{0u};
+		uint64					iterations		{0u};
+		uint64					steals			{0u};
+		uint64					filled			{0u};	// pixels set by subdivision without iterating
+		uint64					reused			{0u};	// pixels shifted over from the previous frame
+		uint64					iterationsSaved	{0u};	// not run thanks to the cardioid, bulb and periodicity checks
+		uint32					threads			{0u};
+		cstring					kernel			{""};
+		Misc::clock::duration	elapsed			{0};
+
+		std::vector<TileTiming>				tiles;
+		std::vector<Misc::clock::duration>	workerBusy;
+
+		// perturbation only
+		uint32					references			{0u};
+		uint32					referenceLimbs		{0u};
+		uint32					seriesSkip			{0u};	// iterations skipped around the first reference
+		uint64					glitchedPixels		{0u};
+		uint64					ownOrbits			{0u};	// glitched after the last reference, iterated alone
+		uint64					skippedIterations	{0u};
+		Misc::clock::duration	referenceTime		{0};
+
+		// tile cache only
+		uint64					cacheHits			{0u};
+		uint64					cacheMisses			{0u};
+
+		// progressive only
+		uint32					passes				{0u};	// finished so far
+		bool					cancelled			{false};
+		Misc::clock::duration	firstImage			{0};	// until the coarsest pass covered the whole frame
+
+		double inline Seconds() const {
+			return std::chrono::duration<double>(elapsed).count();
+		}
+
+		double inline PixelsPerSecond() const {
+			return Seconds() > 0. ? double(pixels) / Seconds() : 0.;
+		}
+
+		double inline IterationsPerSecond() const {
+			return Seconds() > 0. ? double(iterations) / Seconds() : 0.;
+		}
+
+		// mean over max busy time of the workers, 1 means every core was busy until the end
+		double LoadBalance() const;
+	};
+
+	// Headless renderer producing the same image as MandelbrotFragment.glsl
+	class FractalEngine:
+		public Misc::Noncopyable
+	{
+		uint32			m_threadCount;
+		RenderOptions	m_options;
+		EscapeKernel	m_kernel;
+		RenderStats		m_lastStats;
+
+		// last frame of RenderPannedFrame, still held by the caller's buffers
+		FractalView				m_panView;
+		IterationBuffer const *	m_panBuffer	{nullptr};
+
+		struct WorkerScratch
+		{
+			std::vector<EscapeSample>	samples;
+			std::vector<math::vec2u>	pixels;
+			IterationBuffer				tile;	// cache tiles that missed
+		};
+
+		struct RegionResult
+		{
+			uint64 iterations;	// actually run
+			uint64 saved;
+			uint64 filled;
+
+			RegionResult inline & operator+=(RegionResult const & other)
+			{
+				iterations	+= other.iterations;
+				saved		+= other.saved;
+				filled		+= other.filled;
+
+				return *this;
+			}
+		};
+
+		std::unique_ptr<WorkStealingPool>	m_pool;
+		std::vector<WorkerScratch>			m_scratch;
+		std::vector<std::vector<uint32>>	m_glitches;
+
+		RegionResult RenderSpan(FractalView const & view, IterationBuffer & iterations, ColorBuffer & colors,
+								uint32 x, uint32 y, uint32 width, WorkerScratch & scratch);
+
+		// renders and clears scratch.pixels, each sample also fills the block x block square below and right of it
+		RegionResult RenderPixels(FractalView const & view, IterationBuffer & iterations, ColorBuffer & colors,
+								  WorkerScratch & scratch, uint32 block = 1u);
+
+		RegionResult RenderRegion(FractalView const & view, IterationBuffer & iterations, ColorBuffer & colors,
+								  Tile const & region, WorkerScratch & scratch);
+
+		// region's border is already rendered, fills it or renders the split lines and recurses
+		RegionResult Subdivide(FractalView const & view, IterationBuffer & iterations, ColorBuffer & colors,
+							   Tile const & region, WorkerScratch & scratch);
+
+		// shades the region's samples again with the view's modifier
+		void RecolorRegion(FractalView const & view, IterationBuffer const & iterations, ColorBuffer & colors, Tile const & region);
+
+		// switches m_kernel to FitPrecision(view) when the options ask for it
+		void FitKernel(FractalView const & view);
+
+		// shifts the previous frame and renders the exposed strips when RenderPannedFrame can, false otherwise
+		bool ShiftPanned(FractalView const & view, IterationBuffer & iterations, ColorBuffer & colors, RenderStats & stats);
+
+		void RenderStaticRows	(FractalView const & view, IterationBuffer & iterations, ColorBuffer & colors, RenderStats & stats);
+		// every region is split into tiles of m_options.tileSize
+		void RenderTiles		(FractalView const & view, std::vector<Tile> const & regions,
+								 IterationBuffer & iterations, ColorBuffer & colors, RenderStats & stats);
+
+		public:
+
+			typedef std::function<void(RenderStats const & progress)> PassCallback;
+
+			explicit FractalEngine(uint32 threadCount = 0u, RenderOptions options = RenderOptions());
+
+			RenderStats RenderFrame(FractalView const & view, IterationBuffer & iterations, ColorBuffer & colors);
+
+			// The view as a Julia set once per constant, colors[i] for constants[i], whatever the
+			// view's fractal. For thumbnail sized views a kernel call runs one pixel in a group of
+			// sets, the sets spread over the SIMD lanes; the tiles of all groups go to the pool as
+			// a single batch.
+			RenderStats RenderJuliaSweep(FractalView const & view, std::vector<math::vec2f> const & constants, std::vector<ColorBuffer> & colors);
+
+			// perturbation against high precision reference orbits, for zooms past what floats and doubles resolve
+			RenderStats RenderDeepFrame(DeepView const & view, IterationBuffer & iterations, ColorBuffer & colors);
+
+			// colouring pass alone over an already rendered frame, for modifier or palette changes
+			RenderStats Recolor(FractalView const & view, IterationBuffer const & iterations, ColorBuffer & colors);
+
+			// When only the offset moved, by a whole number of pixels, since the last call with
+			// the same buffers, the previous frame is shifted and only the exposed strips get
+			// rendered; a changed colour modifier recolours the kept pixels on top. Anything
+			// else, fractional offsets included, renders the full frame. The buffers must not
+			// be written to by anything else between two calls.
+			RenderStats RenderPannedFrame(FractalView const & view, IterationBuffer & iterations, ColorBuffer & colors);
+
+			// As RenderPannedFrame, but a full render goes in passes, one sample per 4x4, 2x2 and
+			// finally every pixel, each pass only adding the samples the previous ones lacked and
+			// onPass running after every one of them. Returns early, marked cancelled, once the token
+			// is; the buffers then hold a coarser frame and the next call renders from scratch.
+			RenderStats RenderProgressiveFrame(FractalView const & view, IterationBuffer & iterations, ColorBuffer & colors,
+											   CancellationToken const & token, PassCallback const & onPass = PassCallback());
+
+			// assembles the frame from the quadtree tiles of the cache, rendering and storing
+			// the missing ones, each pixel takes the nearest sample of the coarsest level
+			// that is at least as fine as the pixels
+			RenderStats RenderCachedFrame(FractalView const & view, TileCache & cache, IterationBuffer & iterations, ColorBuffer & colors);
+
+			void SetOptions		(RenderOptions options);
+			void SetPrecision	(Precision precision, InstructionSet limit = InstructionSet::AVX512);
+
+			uint32			GetThreadCount()	const;
+			RenderOptions	GetOptions()		const;
+			EscapeKernel	GetKernel()			const;
+			RenderStats		GetLastStats()		const;
+	};
+}
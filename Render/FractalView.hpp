@@ -0,0 +1,80 @@
+#pragma once
+
+#include <Util.h>
+#include <Math/Vector.inl>
+
+enum class FractalType:
+	byte
+{
+	MANDELBROT = 0,
+	JULIA
+};
+
+namespace Render
+{
+	// The ViewBlock uniform block of MandelbrotFragment.glsl and ColoringFragment.glsl in
+	// its std140 layout: a vec3 is aligned as a vec4, a bool takes 4 bytes. The whole
+	// block goes to the GPU in one write, FractalView::GetUniforms fills it.
+	struct alignas(16) ViewUniforms
+	{
+		math::vec2f		offset;
+		math::vec2f		juliaConstant;
+		math::vec3f		colorModifier;
+		float			zoom;
+		math::vec2u		canvas;
+		uint32			maxIterations;
+		uint32			fractalType;	// a bool in the shader, FractalType::JULIA when set
+	};
+
+	static_assert(offsetof(ViewUniforms, offset)		== 0u,	"std140 offset of u_offset");
+	static_assert(offsetof(ViewUniforms, juliaConstant)	== 8u,	"std140 offset of u_juliaConstant");
+	static_assert(offsetof(ViewUniforms, colorModifier)	== 16u,	"std140 offset of u_colorModifier");
+	static_assert(offsetof(ViewUniforms, zoom)			== 28u,	"std140 offset of u_zoom");
+	static_assert(offsetof(ViewUniforms, canvas)		== 32u,	"std140 offset of u_canvas");
+	static_assert(offsetof(ViewUniforms, maxIterations)	== 40u,	"std140 offset of u_maxIter");
+	static_assert(offsetof(ViewUniforms, fractalType)	== 44u,	"std140 offset of u_fractalType");
+	static_assert(sizeof(ViewUniforms)					== 48u,	"std140 size of ViewBlock");
+
+	// CPU side copy of the uniforms read by MandelbrotFragment.glsl, zoom and offset
+	// are kept in double for the CPU kernels and rounded to float for the shader
+	struct FractalView
+	{
+		double			zoom;
+		math::vec2d		offset;
+		math::vec2u		canvas;
+		uint32			maxIterations;
+		FractalType		fractal;
+		math::vec2f		juliaConstant;
+		math::vec3f		colorModifier;
+
+		float inline AspectRatio() const {
+			return float(canvas.x) / float(canvas.y);
+		}
+
+		uint64 inline PixelCount() const {
+			return uint64(canvas.x) * canvas.y;
+		}
+
+		ViewUniforms inline GetUniforms() const
+		{
+			ViewUniforms uniforms;
+			uniforms.offset			= { float(offset.x), float(offset.y) };
+			uniforms.juliaConstant	= juliaConstant;
+			uniforms.colorModifier	= colorModifier;
+			uniforms.zoom			= float(zoom);
+			uniforms.canvas			= canvas;
+			uniforms.maxIterations	= maxIterations;
+			uniforms.fractalType	= fractal == FractalType::JULIA ? 1u : 0u;
+
+			return uniforms;
+		}
+
+		// everything but the colour modifier, such views give the same escape samples
+		bool inline SharesEscape(FractalView const & other) const
+		{
+			return zoom == other.zoom && offset.x == other.offset.x && offset.y == other.offset.y &&
+				   canvas.x == other.canvas.x && canvas.y == other.canvas.y && maxIterations == other.maxIterations &&
+				   fractal == other.fractal && juliaConstant.x == other.juliaConstant.x && juliaConstant.y == other.juliaConstant.y;
+		}
+	};
+}
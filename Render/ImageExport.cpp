@@ -0,0 +1,313 @@
+#include "ImageExport.hpp"
+
+namespace
+{
+	constexpr uint32 JOURNAL_VERSION = 2u;
+
+	cstring const JOURNAL_EXTENSION = ".progress";
+
+	// FNV-1a of everything that changes the pixels, so the journal of another export never resumes this one
+	uint64 HashExport(Render::FractalView const & view, Render::Precision precision, uint32 bandHeight)
+	{
+		uint64 hash = 14695981039346656037ull;
+
+		auto Mix = [&hash](void const * data, size_t size)
+		{
+			for (size_t i = 0u; i < size; ++i)
+			{
+				hash ^= static_cast<byte const *>(data)[i];
+				hash *= 1099511628211ull;
+			}
+		};
+
+		// field by field, the padding between them is undefined
+		Mix(&view.zoom,				sizeof(view.zoom));
+		Mix(&view.offset.x,			sizeof(double));
+		Mix(&view.offset.y,			sizeof(double));
+		Mix(&view.canvas.x,			sizeof(uint32));
+		Mix(&view.canvas.y,			sizeof(uint32));
+		Mix(&view.maxIterations,	sizeof(view.maxIterations));
+		Mix(&view.fractal,			sizeof(view.fractal));
+		Mix(&view.juliaConstant.x,	sizeof(float));
+		Mix(&view.juliaConstant.y,	sizeof(float));
+		Mix(&view.colorModifier.x,	sizeof(float));
+		Mix(&view.colorModifier.y,	sizeof(float));
+		Mix(&view.colorModifier.z,	sizeof(float));
+		Mix(&precision,				sizeof(precision));
+		Mix(&bandHeight,			sizeof(bandHeight));
+
+		return hash;
+	}
+
+	struct Journal
+	{
+		uint32 finished	{0u};
+		uint64 bytes	{0u};	// PNG only, the file up to the checkpoint after the last finished band
+		uint32 adler	{1u};
+	};
+
+	// nothing finished without a journal or with the journal of another export
+	Journal LoadJournal(std::string const & path, uint64 hash)
+	{
+		std::ifstream journal(path);
+
+		uint32				version;
+		unsigned long long	journalHash;
+		Journal				loaded;
+		unsigned long long	bytes;
+
+		if (!(journal >> version >> std::hex >> journalHash >> std::dec >> loaded.finished >> bytes >> loaded.adler))
+			return Journal();
+
+		loaded.bytes = bytes;
+
+		return version == JOURNAL_VERSION && journalHash == hash ? loaded : Journal();
+	}
+
+	// written aside and renamed, a crash leaves either the old or the new journal
+	bool SaveJournal(std::string const & path, uint64 hash, Journal const & saved)
+	{
+		std::string const temporary = path + ".tmp";
+
+		{
+			std::ofstream journal(temporary, std::ios::trunc);
+
+			journal << JOURNAL_VERSION << ' ' << std::hex << std::setw(16) << std::setfill('0') << hash
+					<< ' ' << std::dec << saved.finished << ' ' << saved.bytes << ' ' << saved.adler << '\n';
+
+			if (!journal)
+				return false;
+		}
+
+		std::remove(path.c_str());
+
+		return std::rename(temporary.c_str(), path.c_str()) == 0;
+	}
+
+	bool IsPng(std::string const & path)
+	{
+		if (path.size() < 4u)
+			return false;
+
+		std::string extension = path.substr(path.size() - 4u);
+		std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return char(std::tolower(c)); });
+
+		return extension == ".png";
+	}
+}
+
+uint32 Render::ExportBandHeight(math::vec2u canvas)
+{
+	uint64 const rows = EXPORT_BAND_PIXELS / std::max(1u, canvas.x);
+
+	return uint32(std::max<uint64>(1u, std::min<uint64>(rows, canvas.y)));
+}
+
+Render::FractalView Render::BandView(FractalView const & view, uint32 y, uint32 rows)
+{
+	// the zoom spans the height, keeping the pixel size keeps every sample in place
+	double const pixel = view.zoom / double(view.canvas.y);
+
+	FractalView band = view;
+	band.zoom		= pixel * double(rows);
+	band.offset.y	= view.offset.y + pixel * double(view.canvas.y - y - rows);
+	band.canvas		= { view.canvas.x, rows };
+
+	return band;
+}
+
+Render::ExportStats Render::ExportImage(FractalEngine & engine, FractalView const & view, std::string const & path,
+										CancellationToken const & token, ExportCallback const & onBand)
+{
+	Misc::Stopwatch stopwatch;
+	stopwatch.Start();
+
+	ExportStats stats;
+	stats.bandHeight	= ExportBandHeight(view.canvas);
+	stats.bands			= (view.canvas.y + stats.bandHeight - 1u) / stats.bandHeight;
+	stats.bandBytes		= uint64(view.canvas.x) * stats.bandHeight * (sizeof(uint32) + sizeof(float) + sizeof(uint32) + 3u);
+
+	// FitPrecision of a single band could differ from its neighbours'
+	RenderOptions const previous	= engine.GetOptions();
+	RenderOptions		options		= previous;
+
+	options.precision		= previous.fitPrecision ? FitPrecision(view) : previous.precision;
+	options.fitPrecision	= false;
+
+	uint64 const		hash		= HashExport(view, options.precision, stats.bandHeight);
+	std::string const	journal		= path + JOURNAL_EXTENSION;
+	uint64 const		rowBytes	= 3ull * view.canvas.x;
+	Journal const		previousRun	= LoadJournal(journal, hash);
+
+	char header[64];
+	uint64 const headerBytes = uint64(std::snprintf(header, sizeof(header), "P6\n%u %u\n255\n", view.canvas.x, view.canvas.y));
+
+	std::fstream						file;
+	std::unique_ptr<Misc::PngWriter>	png;
+
+	if (IsPng(path))
+	{
+		png.reset(new Misc::PngWriter());
+
+		// bands count once their checkpoint is in the file, a few pieces after they rendered
+		png->SetCheckpointCallback([&](Misc::PngWriter::Checkpoint const & checkpoint)
+		{
+			Journal saved;
+			saved.finished	= (checkpoint.rows + stats.bandHeight - 1u) / stats.bandHeight;
+			saved.bytes		= checkpoint.bytes;
+			saved.adler		= checkpoint.adler;
+
+			if (!SaveJournal(journal, hash, saved))
+			{
+				stats.failed = true;
+				return;
+			}
+
+			stats.finished = saved.finished;
+
+			stopwatch.Stop();
+			stats.elapsed	= stopwatch.GetTime();
+			stats.encode	= png->GetStats();
+
+			if (onBand)
+				onBand(stats);
+		});
+
+		Misc::PngWriter::Checkpoint checkpoint;
+		checkpoint.rows		= std::min(std::min(previousRun.finished, stats.bands) * stats.bandHeight, view.canvas.y);
+		checkpoint.bytes	= previousRun.bytes;
+		checkpoint.adler	= previousRun.adler;
+
+		// resumes only if the image still holds everything up to the checkpoint
+		if (checkpoint.rows && png->Resume(path, view.canvas.x, view.canvas.y, checkpoint))
+			stats.resumed = stats.finished = std::min(previousRun.finished, stats.bands);
+		else if (!png->Open(path, view.canvas.x, view.canvas.y))
+		{
+			stats.failed = true;
+			return stats;
+		}
+	}
+	else
+	{
+		// resumes only if the image still holds every band the journal claims
+		if (uint32 const finished = std::min(previousRun.finished, stats.bands))
+		{
+			file.open(path, std::ios::in | std::ios::out | std::ios::binary);
+			file.seekg(0, std::ios::end);
+
+			uint64 const written = std::min(uint64(finished) * stats.bandHeight, uint64(view.canvas.y));
+
+			if (file && uint64(file.tellg()) >= headerBytes + written * rowBytes)
+				stats.resumed = stats.finished = finished;
+			else
+				file.close();
+		}
+
+		if (!file.is_open())
+		{
+			file.open(path, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+			file.write(header, std::streamsize(headerBytes));
+		}
+
+		if (!file)
+		{
+			stats.failed = true;
+			return stats;
+		}
+	}
+
+	engine.SetOptions(options);
+
+	IterationBuffer		iterations;
+	ColorBuffer			colors;
+	std::vector<byte>	rgb(png ? 0u : size_t(rowBytes) * stats.bandHeight);
+
+	for (uint32 band = stats.resumed; band < stats.bands && !stats.failed; ++band)
+	{
+		if (token.IsCancelled())
+		{
+			stats.cancelled = true;
+			break;
+		}
+
+		uint32 const y		= band * stats.bandHeight;
+		uint32 const rows	= std::min(stats.bandHeight, view.canvas.y - y);
+
+		Misc::Stopwatch renderTime;
+		renderTime.Start();
+
+		RenderStats const frame = engine.RenderFrame(BandView(view, y, rows), iterations, colors);
+
+		renderTime.Stop();
+
+		stats.pixels		+= frame.pixels;
+		stats.iterations	+= frame.iterations;
+		stats.imageBytes	+= rowBytes * rows;
+		stats.render		+= renderTime.GetTime();
+
+		// the writer takes the band and returns as soon as its queue has room
+		if (png)
+		{
+			if (!png->WriteRows(colors.pixels.data(), rows))
+				stats.failed = true;
+
+			png->MarkCheckpoint();
+			continue;
+		}
+
+		// packed RGBA, R in the lowest byte
+		for (size_t i = 0u; i < size_t(view.canvas.x) * rows; ++i)
+		{
+			uint32 const pixel = colors.pixels[i];
+
+			rgb[3u * i]			= byte(pixel);
+			rgb[3u * i + 1u]	= byte(pixel >> 8u);
+			rgb[3u * i + 2u]	= byte(pixel >> 16u);
+		}
+
+		file.seekp(std::streamoff(headerBytes + uint64(y) * rowBytes));
+		file.write(reinterpret_cast<char const *>(rgb.data()), std::streamsize(rowBytes * rows));
+		file.flush();
+
+		Journal saved;
+		saved.finished = band + 1u;
+
+		// the band only counts once it reached the file
+		if (!file || !SaveJournal(journal, hash, saved))
+		{
+			stats.failed = true;
+			break;
+		}
+
+		stats.finished = saved.finished;
+
+		stopwatch.Stop();
+		stats.elapsed = stopwatch.GetTime();
+
+		if (onBand)
+			onBand(stats);
+	}
+
+	engine.SetOptions(previous);
+
+	if (png)
+	{
+		// Close only completes a file with every row, whatever is left stays resumable
+		if (stats.cancelled || stats.failed)
+			png->Abandon();
+		else if (!png->Close())
+			stats.failed = true;
+
+		stats.encode = png->GetStats();
+	}
+	else
+		file.close();
+
+	if (stats.finished == stats.bands && !stats.failed)
+		std::remove(journal.c_str());
+
+	stopwatch.Stop();
+	stats.elapsed = stopwatch.GetTime();
+
+	return stats;
+}
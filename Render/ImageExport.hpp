@@ -0,0 +1,65 @@
+#pragma once
+
+#include "FractalEngine.hpp"
+
+#include <Utils/PngWriter.h>
+
+// Images far larger than the window, 32k x 32k prints, rendered in bands of full
+// rows and streamed into the file one band at a time, so memory stays bounded by a
+// single band whatever the image size. A journal next to the image records the
+// finished bands; an export interrupted for any reason, a crash included, picks up
+// after the last of them when run again with the same view and path.
+//
+// A path ending in .png is encoded while the next bands render, see Misc::PngWriter,
+// anything else is written as a binary PPM.
+
+namespace Render
+{
+	// pixels per band, a band costs about 15 bytes per pixel while it is in flight
+	constexpr uint64 EXPORT_BAND_PIXELS = 1ull << 22u;
+
+	struct ExportStats
+	{
+		uint32					bands			{0u};
+		uint32					bandHeight		{0u};
+		uint32					finished		{0u};	// bands on disk, the resumed ones included
+		uint32					resumed			{0u};	// bands already on disk from an earlier run
+		uint64					pixels			{0u};	// rendered by this run
+		uint64					iterations		{0u};
+		uint64					bandBytes		{0u};	// buffers of one band, the bound on the memory used
+		uint64					imageBytes		{0u};	// RGB rendered by this run
+		Misc::clock::duration	render			{0};	// spent in RenderFrame
+		Misc::PngWriter::Stats	encode;					// empty for a PPM
+		bool					cancelled		{false};
+		bool					failed			{false};
+		Misc::clock::duration	elapsed			{0};
+
+		double inline Seconds() const {
+			return std::chrono::duration<double>(elapsed).count();
+		}
+
+		double inline PixelsPerSecond() const {
+			return Seconds() > 0. ? double(pixels) / Seconds() : 0.;
+		}
+
+		double inline RenderMegabytesPerSecond() const {
+			double const seconds = std::chrono::duration<double>(render).count();
+			return seconds > 0. ? double(imageBytes) / seconds / 1e6 : 0.;
+		}
+	};
+
+	typedef std::function<void(ExportStats const & progress)> ExportCallback;
+
+	// rows of the band so that it stays around EXPORT_BAND_PIXELS
+	uint32 ExportBandHeight(math::vec2u canvas);
+
+	// rows [y, y + rows) of the view as a view of their own, sampled at the same points
+	FractalView BandView(FractalView const & view, uint32 y, uint32 rows);
+
+	// Renders view.canvas into a PNG or a binary PPM at path. The precision is fitted once for the
+	// whole image so that no seam shows between bands, the engine's options are restored
+	// afterwards. onBand runs after every band made it to the disk. Cancelling keeps the
+	// journal, the next call with the same arguments resumes.
+	ExportStats ExportImage(FractalEngine & engine, FractalView const & view, std::string const & path,
+							CancellationToken const & token = CancellationToken(), ExportCallback const & onBand = ExportCallback());
+}
@@ -0,0 +1,475 @@
+#include "IterationFile.hpp"
+
+#include <Utils/Deflate.h>
+
+namespace
+{
+	constexpr uint32 ITERATION_MAGIC	= 0x52544946u;	// "FITR"
+	constexpr uint32 ITERATION_VERSION	= 1u;
+	constexpr uint64 TILE_ALIGNMENT		= 16u;
+
+	struct IterationFileHeader
+	{
+		uint32	magic;
+		uint32	version;
+		uint32	width;
+		uint32	height;
+		uint32	tileSize;
+		uint32	flags;			// 1 when tiles may be compressed
+		uint32	maxIterations;
+		uint32	fractal;
+		uint32	precision;
+		uint32	reserved;
+		double	zoom;
+		double	offset[2];
+		float	juliaConstant[2];
+		float	colorModifier[3];
+		uint32	padding;
+	};
+
+	static_assert(sizeof(IterationFileHeader) == 88u, "the header is part of the file format");
+	static_assert(sizeof(Render::IterationTileEntry) == 16u, "the tile table is part of the file format");
+
+	uint32 inline TileCount(uint32 size, uint32 tileSize) {
+		return (size + tileSize - 1u) / tileSize;
+	}
+
+	// the 4 byte values as 4 planes, the high bytes of iteration counts are mostly equal
+	void Shuffle(byte const * values, size_t count, byte * planes)
+	{
+		for (size_t i = 0u; i < count; ++i)
+		{
+			for (size_t plane = 0u; plane < 4u; ++plane)
+				planes[plane * count + i] = values[4u * i + plane];
+		}
+	}
+
+	void Unshuffle(byte const * planes, size_t count, byte * values)
+	{
+		for (size_t i = 0u; i < count; ++i)
+		{
+			for (size_t plane = 0u; plane < 4u; ++plane)
+				values[4u * i + plane] = planes[plane * count + i];
+		}
+	}
+
+	// the stored form of one tile, raw unless deflating makes it smaller
+	Render::TileEncoding EncodeTile(Render::IterationBuffer const & rows, uint32 x, uint32 width, uint32 height,
+									bool compress, std::vector<byte> & out)
+	{
+		size_t const samples = size_t(width) * height;
+
+		std::vector<byte> raw(2u * samples * sizeof(uint32));
+
+		for (uint32 row = 0u; row < height; ++row)
+		{
+			std::memcpy(raw.data() + size_t(row) * width * sizeof(uint32),
+						&rows.iterations[rows.Index(x, row)], width * sizeof(uint32));
+
+			std::memcpy(raw.data() + (samples + size_t(row) * width) * sizeof(float),
+						&rows.smooth[rows.Index(x, row)], width * sizeof(float));
+		}
+
+		if (compress)
+		{
+			std::vector<byte> planes(raw.size());
+			Shuffle(raw.data(), 2u * samples, planes.data());
+
+			out.clear();
+			Misc::Deflate::Compress(planes.data(), 0u, planes.size(), true, out);
+
+			if (out.size() < raw.size())
+				return Render::TileEncoding::SHUFFLED_DEFLATE;
+		}
+
+		out.swap(raw);
+
+		return Render::TileEncoding::RAW;
+	}
+}
+
+bool Render::IterationFileWriter::Open(std::string const & path, FractalView const & view, Precision precision, uint32 tileSize, bool compress)
+{
+	m_view			= view;
+	m_precision		= precision;
+	m_tileSize		= std::max(1u, tileSize);
+	m_compress		= compress;
+	m_tiles			= { TileCount(view.canvas.x, m_tileSize), TileCount(view.canvas.y, m_tileSize) };
+	m_pendingRows	= 0u;
+	m_rowsWritten	= 0u;
+	m_failed		= false;
+
+	m_table.assign(size_t(m_tiles.x) * m_tiles.y, IterationTileEntry{ 0u, 0u, TileEncoding::RAW });
+	m_pending.Resize(view.canvas.x, std::min(m_tileSize, view.canvas.y));
+
+	// the header stays zero until Close, so an unfinished file is no valid one
+	m_fileBytes = sizeof(IterationFileHeader) + m_table.size() * sizeof(IterationTileEntry);
+
+	m_file.close();
+	m_file.clear();
+	m_file.open(path, std::ios::binary | std::ios::trunc);
+
+	std::vector<char> const zeros(sizeof(IterationFileHeader) + m_table.size() * sizeof(IterationTileEntry), 0);
+	m_file.write(zeros.data(), std::streamsize(zeros.size()));
+
+	return bool(m_file);
+}
+
+void Render::IterationFileWriter::WriteTileRow()
+{
+	uint32 const tileY = m_rowsWritten / m_tileSize;
+
+	// tiles are independent, one task per core takes every n-th
+	std::vector<std::vector<byte>>	stored(m_tiles.x);
+	std::vector<TileEncoding>		encodings(m_tiles.x);
+	std::vector<std::future<void>>	tasks;
+
+	uint32 const taskCount = std::max(1u, std::min(m_tiles.x, std::thread::hardware_concurrency()));
+
+	for (uint32 task = 0u; task < taskCount; ++task)
+	{
+		tasks.push_back(std::async(std::launch::async, [&, task]()
+		{
+			for (uint32 tileX = task; tileX < m_tiles.x; tileX += taskCount)
+			{
+				uint32 const x		= tileX * m_tileSize;
+				uint32 const width	= std::min(m_tileSize, m_view.canvas.x - x);
+
+				encodings[tileX] = EncodeTile(m_pending, x, width, m_pendingRows, m_compress, stored[tileX]);
+			}
+		}));
+	}
+
+	for (auto & task : tasks)
+		task.get();
+
+	for (uint32 tileX = 0u; tileX < m_tiles.x; ++tileX)
+	{
+		uint64 const aligned = (m_fileBytes + TILE_ALIGNMENT - 1u) / TILE_ALIGNMENT * TILE_ALIGNMENT;
+
+		char const padding[TILE_ALIGNMENT] = {};
+		m_file.write(padding, std::streamsize(aligned - m_fileBytes));
+		m_file.write(reinterpret_cast<char const *>(stored[tileX].data()), std::streamsize(stored[tileX].size()));
+
+		m_table[size_t(tileY) * m_tiles.x + tileX] = { aligned, uint32(stored[tileX].size()), encodings[tileX] };
+		m_fileBytes = aligned + stored[tileX].size();
+	}
+
+	m_rowsWritten += m_pendingRows;
+	m_pendingRows  = 0u;
+
+	if (!m_file)
+		m_failed = true;
+}
+
+bool Render::IterationFileWriter::WriteRows(IterationBuffer const & rows)
+{
+	if (!m_file.is_open() || rows.width != m_view.canvas.x || m_rowsWritten + m_pendingRows + rows.height > m_view.canvas.y)
+		return false;
+
+	for (uint32 row = 0u; row < rows.height; ++row)
+	{
+		std::copy(&rows.iterations[rows.Index(0u, row)], &rows.iterations[rows.Index(0u, row)] + rows.width,
+				  &m_pending.iterations[m_pending.Index(0u, m_pendingRows)]);
+
+		std::copy(&rows.smooth[rows.Index(0u, row)], &rows.smooth[rows.Index(0u, row)] + rows.width,
+				  &m_pending.smooth[m_pending.Index(0u, m_pendingRows)]);
+
+		if (++m_pendingRows == m_tileSize)
+			WriteTileRow();
+	}
+
+	return !m_failed;
+}
+
+bool Render::IterationFileWriter::Close()
+{
+	if (!m_file.is_open())
+		return false;
+
+	if (m_pendingRows)
+		WriteTileRow();
+
+	bool const complete = m_rowsWritten == m_view.canvas.y && !m_failed;
+
+	if (complete)
+	{
+		IterationFileHeader header = {};
+		header.magic			= ITERATION_MAGIC;
+		header.version			= ITERATION_VERSION;
+		header.width			= m_view.canvas.x;
+		header.height			= m_view.canvas.y;
+		header.tileSize			= m_tileSize;
+		header.flags			= m_compress ? 1u : 0u;
+		header.maxIterations	= m_view.maxIterations;
+		header.fractal			= uint32(m_view.fractal);
+		header.precision		= uint32(m_precision);
+		header.zoom				= m_view.zoom;
+		header.offset[0]		= m_view.offset.x;
+		header.offset[1]		= m_view.offset.y;
+		header.juliaConstant[0]	= m_view.juliaConstant.x;
+		header.juliaConstant[1]	= m_view.juliaConstant.y;
+		header.colorModifier[0]	= m_view.colorModifier.x;
+		header.colorModifier[1]	= m_view.colorModifier.y;
+		header.colorModifier[2]	= m_view.colorModifier.z;
+
+		// the table first, the header only once everything it points at is in place
+		m_file.seekp(std::streamoff(sizeof(header)));
+		m_file.write(reinterpret_cast<char const *>(m_table.data()), std::streamsize(m_table.size() * sizeof(IterationTileEntry)));
+		m_file.flush();
+
+		m_file.seekp(0);
+		m_file.write(reinterpret_cast<char const *>(&header), sizeof(header));
+	}
+
+	m_file.close();
+
+	return complete && !m_file.fail();
+}
+
+uint64 Render::IterationFileWriter::GetFileBytes() const
+{
+	return m_fileBytes;
+}
+
+bool Render::IterationFileReader::Open(std::string const & path)
+{
+	Close();
+
+	if (!m_file.Open(path) || m_file.GetSize() < sizeof(IterationFileHeader))
+	{
+		m_file.Close();
+		return false;
+	}
+
+	IterationFileHeader header;
+	std::memcpy(&header, m_file.GetData(), sizeof(header));
+
+	if (header.magic != ITERATION_MAGIC || header.version != ITERATION_VERSION || !header.tileSize || !header.width || !header.height)
+	{
+		m_file.Close();
+		return false;
+	}
+
+	m_tileSize	= header.tileSize;
+	m_tiles		= { TileCount(header.width, m_tileSize), TileCount(header.height, m_tileSize) };
+
+	uint64 const tableEnd = sizeof(header) + uint64(m_tiles.x) * m_tiles.y * sizeof(IterationTileEntry);
+
+	if (m_file.GetSize() < tableEnd)
+	{
+		m_file.Close();
+		return false;
+	}
+
+	m_table		= reinterpret_cast<IterationTileEntry const *>(m_file.GetData() + sizeof(header));
+	m_precision	= Precision(header.precision);
+
+	m_view.zoom				= header.zoom;
+	m_view.offset			= { header.offset[0], header.offset[1] };
+	m_view.canvas			= { header.width, header.height };
+	m_view.maxIterations	= header.maxIterations;
+	m_view.fractal			= FractalType(header.fractal);
+	m_view.juliaConstant	= { header.juliaConstant[0], header.juliaConstant[1] };
+	m_view.colorModifier	= { header.colorModifier[0], header.colorModifier[1], header.colorModifier[2] };
+
+	return true;
+}
+
+void Render::IterationFileReader::Close()
+{
+	m_file.Close();
+
+	m_table		= nullptr;
+	m_tileSize	= 0u;
+	m_tiles		= { 0u, 0u };
+}
+
+Render::FractalView const & Render::IterationFileReader::GetView() const
+{
+	return m_view;
+}
+
+Render::Precision Render::IterationFileReader::GetPrecision() const
+{
+	return m_precision;
+}
+
+uint32 Render::IterationFileReader::GetTileSize() const
+{
+	return m_tileSize;
+}
+
+math::vec2u Render::IterationFileReader::GetTileCount() const
+{
+	return m_tiles;
+}
+
+bool Render::IterationFileReader::GetTile(uint32 tileX, uint32 tileY, IterationTile & tile, std::vector<byte> & scratch) const
+{
+	if (!m_table || tileX >= m_tiles.x || tileY >= m_tiles.y)
+		return false;
+
+	tile.x		= tileX * m_tileSize;
+	tile.y		= tileY * m_tileSize;
+	tile.width	= std::min(m_tileSize, m_view.canvas.x - tile.x);
+	tile.height	= std::min(m_tileSize, m_view.canvas.y - tile.y);
+
+	IterationTileEntry const	entry	= m_table[size_t(tileY) * m_tiles.x + tileX];
+	size_t const				samples	= size_t(tile.width) * tile.height;
+	size_t const				bytes	= 2u * samples * sizeof(uint32);
+
+	if (entry.offset % TILE_ALIGNMENT || entry.offset > m_file.GetSize() || entry.bytes > m_file.GetSize() - entry.offset)
+		return false;
+
+	byte const * data = m_file.GetData() + entry.offset;
+
+	switch (entry.encoding)
+	{
+		case TileEncoding::RAW:
+		{
+			if (entry.bytes != bytes)
+				return false;
+
+			break;
+		}
+
+		case TileEncoding::SHUFFLED_DEFLATE:
+		{
+			scratch.resize(2u * bytes);
+
+			if (!Misc::Deflate::Decompress(data, entry.bytes, scratch.data() + bytes, bytes))
+				return false;
+
+			Unshuffle(scratch.data() + bytes, 2u * samples, scratch.data());
+
+			data = scratch.data();
+			break;
+		}
+
+		default:
+			return false;
+	}
+
+	tile.iterations	= reinterpret_cast<uint32 const *>(data);
+	tile.smooth		= reinterpret_cast<float const *>(data + samples * sizeof(uint32));
+
+	return true;
+}
+
+bool Render::IterationFileReader::ReadRegion(uint32 x, uint32 y, uint32 width, uint32 height, IterationBuffer & region) const
+{
+	if (!m_table || !width || !height || x >= m_view.canvas.x || y >= m_view.canvas.y ||
+		width > m_view.canvas.x - x || height > m_view.canvas.y - y)
+		return false;
+
+	region.Resize(width, height);
+
+	IterationTile		tile;
+	std::vector<byte>	scratch;
+
+	for (uint32 tileY = y / m_tileSize; tileY <= (y + height - 1u) / m_tileSize; ++tileY)
+	{
+		for (uint32 tileX = x / m_tileSize; tileX <= (x + width - 1u) / m_tileSize; ++tileX)
+		{
+			if (!GetTile(tileX, tileY, tile, scratch))
+				return false;
+
+			// the overlap of the tile and the region, in image coordinates
+			uint32 const left	= std::max(x, tile.x);
+			uint32 const right	= std::min(x + width, tile.x + tile.width);
+			uint32 const top	= std::max(y, tile.y);
+			uint32 const bottom	= std::min(y + height, tile.y + tile.height);
+
+			for (uint32 row = top; row < bottom; ++row)
+			{
+				size_t const source = size_t(row - tile.y) * tile.width + (left - tile.x);
+
+				std::copy(tile.iterations + source, tile.iterations + source + (right - left), &region.iterations[region.Index(left - x, row - y)]);
+				std::copy(tile.smooth + source, tile.smooth + source + (right - left), &region.smooth[region.Index(left - x, row - y)]);
+			}
+		}
+	}
+
+	return true;
+}
+
+Render::ExportStats Render::ExportIterations(FractalEngine & engine, FractalView const & view, std::string const & path, bool compress,
+											 CancellationToken const & token, ExportCallback const & onBand)
+{
+	Misc::Stopwatch stopwatch;
+	stopwatch.Start();
+
+	ExportStats stats;
+	stats.bandHeight	= ExportBandHeight(view.canvas);
+	stats.bands			= (view.canvas.y + stats.bandHeight - 1u) / stats.bandHeight;
+	stats.bandBytes		= uint64(view.canvas.x) * (stats.bandHeight + ITERATION_TILE_SIZE) * (sizeof(uint32) + sizeof(float)) +
+						  uint64(view.canvas.x) * stats.bandHeight * sizeof(uint32);
+
+	// one precision for the whole image, as in ExportImage
+	RenderOptions const previous	= engine.GetOptions();
+	RenderOptions		options		= previous;
+
+	options.precision		= previous.fitPrecision ? FitPrecision(view) : previous.precision;
+	options.fitPrecision	= false;
+
+	IterationFileWriter writer;
+
+	if (!writer.Open(path, view, options.precision, ITERATION_TILE_SIZE, compress))
+	{
+		stats.failed = true;
+		return stats;
+	}
+
+	engine.SetOptions(options);
+
+	IterationBuffer	iterations;
+	ColorBuffer		colors;
+
+	for (uint32 band = 0u; band < stats.bands; ++band)
+	{
+		if (token.IsCancelled())
+		{
+			stats.cancelled = true;
+			break;
+		}
+
+		uint32 const y		= band * stats.bandHeight;
+		uint32 const rows	= std::min(stats.bandHeight, view.canvas.y - y);
+
+		Misc::Stopwatch renderTime;
+		renderTime.Start();
+
+		RenderStats const frame = engine.RenderFrame(BandView(view, y, rows), iterations, colors);
+
+		renderTime.Stop();
+
+		if (!writer.WriteRows(iterations))
+		{
+			stats.failed = true;
+			break;
+		}
+
+		stats.finished		 = band + 1u;
+		stats.pixels		+= frame.pixels;
+		stats.iterations	+= frame.iterations;
+		stats.imageBytes	+= uint64(view.canvas.x) * rows * (sizeof(uint32) + sizeof(float));
+		stats.render		+= renderTime.GetTime();
+
+		stopwatch.Stop();
+		stats.elapsed = stopwatch.GetTime();
+
+		if (onBand)
+			onBand(stats);
+	}
+
+	engine.SetOptions(previous);
+
+	if (!writer.Close() && !stats.cancelled)
+		stats.failed = true;
+
+	stopwatch.Stop();
+	stats.elapsed = stopwatch.GetTime();
+
+	return stats;
+}
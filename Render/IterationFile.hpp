@@ -0,0 +1,125 @@
+#pragma once
+
+#include "ImageExport.hpp"
+
+#include <Utils/MappedFile.h>
+
+// Raw escape-time results on disk, for tools that recolour or analyse a render
+// without running it again. All values are little endian; a file is laid out as
+//
+//	header		88 bytes, see IterationFileHeader in IterationFile.cpp: "FITR", the
+//				version, width, height, tile size, flags, then the view (max iterations,
+//				fractal, precision, zoom, offset, Julia constant, colour modifier)
+//	tile table	one 16 byte entry per tile, row by row: uint64 offset into the file,
+//				uint32 stored bytes, uint32 encoding
+//	tiles		each at a 16 byte aligned offset
+//
+// Tiles are tileSize squares, clipped at the right and bottom edges, starting at the top
+// left of the image. A tile holds its width * height uint32 iterations row by row, then
+// as many float smooth values. With the RAW encoding those bytes are stored as they are;
+// with SHUFFLED_DEFLATE the 4 byte values are split into 4 planes, byte 0 of every value
+// first, and the planes are one raw deflate stream. The header is written last, a file
+// whose export did not complete does not open.
+
+namespace Render
+{
+	constexpr uint32 ITERATION_TILE_SIZE = 256u;
+
+	enum class TileEncoding:
+		uint32
+	{
+		RAW,
+		SHUFFLED_DEFLATE
+	};
+
+	struct IterationTileEntry
+	{
+		uint64			offset;
+		uint32			bytes;
+		TileEncoding	encoding;
+	};
+
+	// one tile of a file, the samples point into the mapping for a raw tile
+	struct IterationTile
+	{
+		uint32			x, y;			// of the top left pixel
+		uint32			width, height;
+		uint32 const *	iterations;
+		float const *	smooth;
+	};
+
+	// Takes the rows of the image top to bottom in bands of any height, keeps at most
+	// one row of tiles in memory and compresses its tiles on all cores.
+	class IterationFileWriter:
+		public Misc::Noncopyable
+	{
+		std::ofstream						m_file;
+		FractalView							m_view;
+		Precision							m_precision		{Precision::FLOAT};
+		uint32								m_tileSize		{ITERATION_TILE_SIZE};
+		bool								m_compress		{true};
+		math::vec2u							m_tiles			{0u, 0u};
+
+		std::vector<IterationTileEntry>		m_table;
+		IterationBuffer						m_pending;		// the row of tiles being filled
+		uint32								m_pendingRows	{0u};
+		uint32								m_rowsWritten	{0u};
+		uint64								m_fileBytes		{0u};
+		bool								m_failed		{false};
+
+		void WriteTileRow();
+
+		public:
+
+			IterationFileWriter() = default;
+
+			bool Open(std::string const & path, FractalView const & view, Precision precision,
+					  uint32 tileSize = ITERATION_TILE_SIZE, bool compress = true);
+
+			// the next rows of the image, rows.width has to be the width of the view
+			bool WriteRows(IterationBuffer const & rows);
+
+			// writes the table and the header, false if rows are missing
+			bool Close();
+
+			uint64 GetFileBytes() const;
+	};
+
+	// Maps the file, so opening it costs the same whatever its size and only the
+	// tiles asked for are ever read from the disk.
+	class IterationFileReader:
+		public Misc::Noncopyable
+	{
+		Misc::MappedFile				m_file;
+		FractalView						m_view;
+		Precision						m_precision		{Precision::FLOAT};
+		uint32							m_tileSize		{0u};
+		math::vec2u						m_tiles			{0u, 0u};
+		IterationTileEntry const *		m_table			{nullptr};
+
+		public:
+
+			IterationFileReader() = default;
+
+			// false for a missing, incomplete or foreign file
+			bool Open(std::string const & path);
+			void Close();
+
+			FractalView const &	GetView()		const;
+			Precision			GetPrecision()	const;
+			uint32				GetTileSize()	const;
+			math::vec2u			GetTileCount()	const;
+
+			// a compressed tile is inflated into scratch, the tile is valid as long as
+			// scratch and the file are; false for a damaged tile
+			bool GetTile(uint32 tileX, uint32 tileY, IterationTile & tile, std::vector<byte> & scratch) const;
+
+			// any rectangle of the image, reading only the tiles it overlaps
+			bool ReadRegion(uint32 x, uint32 y, uint32 width, uint32 height, IterationBuffer & region) const;
+	};
+
+	// Renders view.canvas band by band like ExportImage and keeps the iterations instead
+	// of the colours. There is no journal, a cancelled export leaves a file that does not open.
+	ExportStats ExportIterations(FractalEngine & engine, FractalView const & view, std::string const & path, bool compress = true,
+								 CancellationToken const & token = CancellationToken(), ExportCallback const & onBand = ExportCallback());
+}
@@ -0,0 +1,150 @@
+#include "JuliaSweep.hpp"
+
+#include <Utils/PngWriter.h>
+
+namespace
+{
+	bool IsPng(std::string const & path)
+	{
+		if (path.size() < 4u)
+			return false;
+
+		std::string extension = path.substr(path.size() - 4u);
+		std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return char(std::tolower(c)); });
+
+		return extension == ".png";
+	}
+
+	bool WritePpm(std::string const & path, Render::ColorBuffer const & image)
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file << "P6\n" << image.width << ' ' << image.height << "\n255\n";
+
+		std::vector<byte> row(3u * size_t(image.width));
+
+		for (uint32 y = 0u; y < image.height && file; ++y)
+		{
+			uint32 const * const pixels = image.pixels.data() + image.Index(0u, y);
+
+			for (uint32 x = 0u; x < image.width; ++x)
+			{
+				row[3u * x]			= byte(pixels[x]);
+				row[3u * x + 1u]	= byte(pixels[x] >> 8u);
+				row[3u * x + 2u]	= byte(pixels[x] >> 16u);
+			}
+
+			file.write(reinterpret_cast<char const *>(row.data()), std::streamsize(row.size()));
+		}
+
+		return bool(file);
+	}
+}
+
+std::vector<math::vec2f> Render::JuliaGrid(math::vec2f min, math::vec2f max, math::vec2u count)
+{
+	std::vector<math::vec2f> constants;
+	constants.reserve(size_t(count.x) * count.y);
+
+	for (uint32 y = 0u; y < count.y; ++y)
+	{
+		float const v = count.y > 1u ? float(y) / float(count.y - 1u) : .5f;
+
+		for (uint32 x = 0u; x < count.x; ++x)
+		{
+			float const u = count.x > 1u ? float(x) / float(count.x - 1u) : .5f;
+
+			constants.push_back({ min.x + (max.x - min.x) * u, min.y + (max.y - min.y) * v });
+		}
+	}
+
+	return constants;
+}
+
+std::vector<math::vec2f> Render::JuliaPath(std::vector<math::vec2f> const & points, uint32 count)
+{
+	std::vector<math::vec2f> constants;
+
+	if (points.empty() || !count)
+		return constants;
+
+	// length along the path up to every point
+	std::vector<double> lengths(points.size(), 0.);
+
+	for (size_t i = 1u; i < points.size(); ++i)
+		lengths[i] = lengths[i - 1u] + std::hypot(double(points[i].x) - points[i - 1u].x, double(points[i].y) - points[i - 1u].y);
+
+	constants.reserve(count);
+
+	size_t segment = 1u;
+
+	for (uint32 i = 0u; i < count; ++i)
+	{
+		double const length = count > 1u ? lengths.back() * double(i) / double(count - 1u) : 0.;
+
+		while (segment + 1u < points.size() && lengths[segment] < length)
+			++segment;
+
+		if (points.size() == 1u || lengths.back() <= 0.)
+		{
+			constants.push_back(points.front());
+			continue;
+		}
+
+		math::vec2f const	from	= points[segment - 1u];
+		math::vec2f const	to		= points[segment];
+		double const		span	= lengths[segment] - lengths[segment - 1u];
+		double const		t		= span > 0. ? std::min((length - lengths[segment - 1u]) / span, 1.) : 0.;
+
+		constants.push_back({ float(from.x + (to.x - from.x) * t), float(from.y + (to.y - from.y) * t) });
+	}
+
+	return constants;
+}
+
+void Render::PackAtlas(std::vector<ColorBuffer> const & thumbnails, uint32 columns, ColorBuffer & atlas)
+{
+	if (thumbnails.empty() || !columns)
+	{
+		atlas.Resize(0u, 0u);
+		return;
+	}
+
+	uint32 const width	= thumbnails.front().width;
+	uint32 const height	= thumbnails.front().height;
+	uint32 const rows	= uint32((thumbnails.size() + columns - 1u) / columns);
+
+	atlas.Resize(width * columns, height * rows);
+	std::fill(atlas.pixels.begin(), atlas.pixels.end(), 0xFF000000u);
+
+	for (size_t i = 0u; i < thumbnails.size(); ++i)
+	{
+		uint32 const left	= uint32(i % columns) * width;
+		uint32 const top	= uint32(i / columns) * height;
+
+		for (uint32 y = 0u; y < height; ++y)
+		{
+			std::memcpy(atlas.pixels.data() + atlas.Index(left, top + y), thumbnails[i].pixels.data() + thumbnails[i].Index(0u, y),
+						width * sizeof(uint32));
+		}
+	}
+}
+
+bool Render::RenderJuliaAtlas(FractalEngine & engine, FractalView const & view, std::vector<math::vec2f> const & constants,
+							  uint32 columns, std::string const & path, RenderStats & stats)
+{
+	std::vector<ColorBuffer> thumbnails;
+	stats = engine.RenderJuliaSweep(view, constants, thumbnails);
+
+	ColorBuffer atlas;
+	PackAtlas(thumbnails, columns, atlas);
+
+	// the thumbnails are no longer needed, the encoder gets their memory
+	std::vector<ColorBuffer>().swap(thumbnails);
+
+	if (!IsPng(path))
+		return WritePpm(path, atlas);
+
+	Misc::PngWriter png;
+
+	return png.Open(path, atlas.width, atlas.height) && png.WriteRows(atlas.pixels.data(), atlas.height) && png.Close();
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "FractalEngine.hpp"
+
+// Parameter atlases: many Julia sets of the same view side by side, one per constant,
+// rendered in a single RenderJuliaSweep. The constants of one kernel call share a
+// pixel and diverge only as far as their sets differ, constants that are close
+// together in the list (neighbours in a grid row, steps along a path) keep the lanes
+// busy the longest.
+
+namespace Render
+{
+	// count.x * count.y constants spread evenly over [min, max], row by row from min.y
+	std::vector<math::vec2f> JuliaGrid(math::vec2f min, math::vec2f max, math::vec2u count);
+
+	// count constants evenly spaced by length along the polyline through points, both ends included
+	std::vector<math::vec2f> JuliaPath(std::vector<math::vec2f> const & points, uint32 count);
+
+	// thumbnails of the same size in rows of `columns`, the cells past the last one are left black
+	void PackAtlas(std::vector<ColorBuffer> const & thumbnails, uint32 columns, ColorBuffer & atlas);
+
+	// renders view (its canvas the size of one thumbnail) for every constant and writes the
+	// atlas to a PNG or PPM file by the extension; false when the file could not be written
+	bool RenderJuliaAtlas(FractalEngine & engine, FractalView const & view, std::vector<math::vec2f> const & constants,
+						  uint32 columns, std::string const & path, RenderStats & stats);
+}
@@ -0,0 +1,131 @@
+#include "KernelBenchmark.hpp"
+
+#include <Math/FixedPoint.inl>
+
+namespace
+{
+	template<uint32 LIMBS>
+	Render::SquareBenchmarkResult BenchmarkSquaring(uint32 repetitions)
+	{
+		Render::SquareBenchmarkResult result;
+		result.bits			= 32u * LIMBS;
+		result.squarings	= std::max(1000u, 2000000u / LIMBS);
+
+		// every limb set, zero limbs would let the schoolbook loops skip rows
+		math::FixedPoint<LIMBS> x{ 0 };
+		uint32 state = 0x9e3779b9u;
+
+		for (auto & limb : x.limbs)
+		{
+			state = state * 1664525u + 1013904223u;
+			limb  = state | 1u;
+		}
+
+		uint32 product[2u * LIMBS];
+		uint32 sink = 0u;
+
+		for (uint32 run = 0u; run < std::max(1u, repetitions); ++run)
+		{
+			Misc::Stopwatch stopwatch;
+			stopwatch.Start();
+
+			for (uint32 i = 0u; i < result.squarings; ++i)
+			{
+				x.limbs[0] ^= i;
+				math::Limbs::MultiplySchoolbook(x.limbs, x.limbs, LIMBS, product);
+				sink += product[LIMBS];
+			}
+
+			stopwatch.Stop();
+
+			if (run == 0u || stopwatch.GetTime() < result.schoolbook)
+				result.schoolbook = stopwatch.GetTime();
+
+			stopwatch.Start();
+
+			for (uint32 i = 0u; i < result.squarings; ++i)
+			{
+				x.limbs[0] ^= i;
+				sink += x.Squared().limbs[0];
+			}
+
+			stopwatch.Stop();
+
+			if (run == 0u || stopwatch.GetTime() < result.squared)
+				result.squared = stopwatch.GetTime();
+		}
+
+		// keeps the loops from being optimised away
+		if (sink == 0x12345678u)
+			result.squarings++;
+
+		return result;
+	}
+}
+
+std::vector<Render::KernelBenchmarkResult> Render::BenchmarkKernels(FractalView const & view, uint32 repetitions)
+{
+	std::vector<KernelBenchmarkResult>	results;
+	std::vector<EscapeSample>			samples(view.canvas.x);
+
+	for (auto const & kernel : GetAvailableKernels())
+	{
+		KernelBenchmarkResult result;
+		result.kernel = kernel;
+
+		// keep the fastest run, the others mostly measure scheduling noise
+		for (uint32 run = 0u; run < std::max(1u, repetitions); ++run)
+		{
+			uint64 iterations = 0u;
+
+			Misc::Stopwatch stopwatch;
+			stopwatch.Start();
+
+			for (uint32 y = 0u; y < view.canvas.y; ++y)
+			{
+				uint64 const saved = kernel.function(view, y, 0u, view.canvas.x, samples.data());
+
+				for (auto const & sample : samples)
+					iterations += sample.iterations;
+
+				iterations -= saved;
+			}
+
+			stopwatch.Stop();
+
+			if (run == 0u || stopwatch.GetTime() < result.elapsed)
+				result.elapsed = stopwatch.GetTime();
+
+			result.iterations = iterations;
+		}
+
+		results.push_back(result);
+	}
+
+	for (auto & result : results)
+	{
+		for (auto const & baseline : results)
+		{
+			if (baseline.kernel.instructionSet == InstructionSet::SCALAR &&
+				baseline.kernel.precision == result.kernel.precision &&
+				baseline.LanesPerSecond() > 0.)
+			{
+				result.speedup = result.LanesPerSecond() / baseline.LanesPerSecond();
+			}
+		}
+	}
+
+	return results;
+}
+
+std::vector<Render::SquareBenchmarkResult> Render::BenchmarkSquarings(uint32 repetitions)
+{
+	return
+	{
+		BenchmarkSquaring<8>	(repetitions),
+		BenchmarkSquaring<16>	(repetitions),
+		BenchmarkSquaring<32>	(repetitions),
+		BenchmarkSquaring<64>	(repetitions),
+		BenchmarkSquaring<128>	(repetitions),
+	};
+}
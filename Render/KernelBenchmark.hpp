@@ -0,0 +1,46 @@
+#pragma once
+
+#include "SimdKernels.hpp"
+
+#include <Utils/Stopwatch.h>
+
+namespace Render
+{
+	struct KernelBenchmarkResult
+	{
+		EscapeKernel			kernel;
+		uint64					iterations	{0u};
+		Misc::clock::duration	elapsed		{0};
+		double					speedup		{1.};	// against the scalar kernel of the same precision
+
+		// every iteration advances one lane
+		double inline LanesPerSecond() const
+		{
+			double seconds = std::chrono::duration<double>(elapsed).count();
+			return seconds > 0. ? double(iterations) / seconds : 0.;
+		}
+	};
+
+	// Runs every kernel the CPU supports over the whole view on the calling thread
+	std::vector<KernelBenchmarkResult> BenchmarkKernels(FractalView const & view, uint32 repetitions = 3u);
+
+	// The reference orbits of deep zooms are mostly squarings of FixedPoint numbers
+	struct SquareBenchmarkResult
+	{
+		uint32					bits		{0u};
+		uint32					squarings	{0u};
+		Misc::clock::duration	schoolbook	{0};	// the full schoolbook product x * x
+		Misc::clock::duration	squared		{0};	// FixedPoint::Squared
+
+		double inline Speedup() const {
+			return squared.count() > 0 ? double(schoolbook.count()) / double(squared.count()) : 0.;
+		}
+
+		double inline NanosecondsPerSquaring() const {
+			return std::chrono::duration<double, std::nano>(squared).count() / double(std::max(1u, squarings));
+		}
+	};
+
+	// 256 to 4096 bit numbers, the sizes deep-zoom references are iterated with
+	std::vector<SquareBenchmarkResult> BenchmarkSquarings(uint32 repetitions = 3u);
+}
@@ -0,0 +1,72 @@
+#include "PanCheck.hpp"
+
+namespace
+{
+	struct PanStep
+	{
+		cstring			name;
+		math::vec2f		shift;			// in pixels
+		math::vec3f		colorModifier;
+	};
+
+	PanStep const k_steps[] =
+	{
+		{ "First frame",		{   0.f,	 0.f	},	{ 1.f,	1.f,	1.f		} },
+		{ "Whole pixel pan",	{  13.f,	-9.f	},	{ 1.f,	1.f,	1.f		} },
+		{ "Modifier only",		{   0.f,	 0.f	},	{ 0.5f,	1.f,	0.25f	} },
+		{ "Pan and modifier",	{ -25.f,	 7.f	},	{ 1.f,	0.75f,	0.5f	} },
+		{ "Fractional pan",		{   0.5f,	 0.f	},	{ 1.f,	0.75f,	0.5f	} },
+	};
+}
+
+std::vector<Render::PanCheckResult> Render::CheckPanning(RenderOptions options)
+{
+	std::vector<PanCheckResult> results;
+
+	FractalEngine engine(0u, options);
+
+	IterationBuffer	pannedIterations,	fullIterations;
+	ColorBuffer		pannedColors,		fullColors;
+
+	// a power of two canvas, pixels 1/256 apart and an offset on that grid: a shifted pixel
+	// lands on exactly the coordinate a full frame gives it, whatever the kernel's precision
+	constexpr double		PIXEL_SPAN	= 1. / 256.;
+	math::vec2u const		canvas		= { 512u, 512u };
+
+	FractalView view;
+	view.zoom			= double(canvas.y) * PIXEL_SPAN;
+	view.canvas			= canvas;
+	view.maxIterations	= 1000u;
+	view.fractal		= FractalType::MANDELBROT;
+	view.juliaConstant	= { 0.f, 0.f };
+	view.offset			= { std::round((-0.75 - view.zoom * view.AspectRatio() / 2.) / PIXEL_SPAN) * PIXEL_SPAN,
+							std::round(-view.zoom / 2. / PIXEL_SPAN) * PIXEL_SPAN };
+
+	for (auto const & step : k_steps)
+	{
+		view.offset.x		+= double(step.shift.x) * PIXEL_SPAN;
+		view.offset.y		+= double(step.shift.y) * PIXEL_SPAN;
+		view.colorModifier	= step.colorModifier;
+
+		RenderStats const panned = engine.RenderPannedFrame(view, pannedIterations, pannedColors);
+		engine.RenderFrame(view, fullIterations, fullColors);
+
+		PanCheckResult result;
+		result.name		= step.name;
+		result.pixels	= view.PixelCount();
+		result.reused	= panned.reused;
+
+		for (size_t i = 0u; i < fullColors.pixels.size(); ++i)
+		{
+			if (pannedIterations.iterations[i] != fullIterations.iterations[i] ||
+				pannedColors.pixels[i] != fullColors.pixels[i])
+			{
+				++result.mismatches;
+			}
+		}
+
+		results.push_back(result);
+	}
+
+	return results;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "FractalEngine.hpp"
+
+namespace Render
+{
+	struct PanCheckResult
+	{
+		cstring		name;
+		uint64		pixels		{0u};
+		uint64		reused		{0u};	// shifted from the previous step instead of rendered
+		uint64		mismatches	{0u};	// iteration count or colour differs from a full frame
+	};
+
+	// Steps a view through whole pixel pans, colour modifier changes and both at once with
+	// RenderPannedFrame and compares every step pixel by pixel with RenderFrame
+	std::vector<PanCheckResult> CheckPanning(RenderOptions options = RenderOptions());
+}
@@ -0,0 +1,430 @@
+#include "Perturbation.hpp"
+
+namespace
+{
+	constexpr double REFERENCE_BAILOUT	= 1e4;	// |Z|^2 kept small enough for the integer limb
+	constexpr double GUARD_BITS			= 64.;	// reference bits past the pixel spacing, for the digits the orbit eats
+	constexpr double ROUNDING_ERROR		= 1e-15;	// a few roundings of a double, relative
+	constexpr int32	 PLAIN_EXPONENT		= -960;	// deltas above 2^-960 are normal doubles
+	constexpr double RESCALE_LIMIT		= 4294967296.;
+	constexpr int32	 RESCALE_BITS		= 32;
+	constexpr double SERIES_BITS		= 40.;	// the series' remainder stays this far below its first term
+
+	template<uint32 LIMBS>
+	void IterateReference(Render::DeepView const & view, math::vec2<Render::DeepReal> const & point, Render::ReferenceOrbit & reference)
+	{
+		typedef math::FixedPoint<LIMBS> Real;
+
+		bool const isMandelbrot = view.fractal == FractalType::MANDELBROT;
+
+		math::vec2<Real> const c = isMandelbrot ? math::vec2<Real>{ Real(point.x), Real(point.y) }
+												: math::vec2<Real>{ Real(view.juliaConstant.x), Real(view.juliaConstant.y) };
+
+		math::vec2<Real> z = isMandelbrot ? math::vec2<Real>{ Real(0), Real(0) }
+										  : math::vec2<Real>{ Real(point.x), Real(point.y) };
+
+		reference.limbs = LIMBS;
+		reference.re.reserve(view.maxIterations + 1u);
+		reference.im.reserve(view.maxIterations + 1u);
+
+		for (uint32 n = 0u; n <= view.maxIterations; ++n)
+		{
+			double const re = z.x.ToDouble();
+			double const im = z.y.ToDouble();
+
+			reference.re.push_back(re);
+			reference.im.push_back(im);
+
+			if (re * re + im * im > REFERENCE_BAILOUT)
+				break;
+
+			// the squaring is where the reference orbit spends its time
+			z = Render::ComplexSquare(z) + c;
+		}
+	}
+
+	Render::EscapeSample EscapedSample(double norm, uint32 iteration, uint32 maxIterations)
+	{
+		Render::EscapeSample sample{ iteration, 0.f };
+
+		if (iteration != 0u && iteration < maxIterations)
+			sample.smooth = Render::SmoothIteration(float(norm), iteration - 1u);
+
+		return sample;
+	}
+}
+
+Render::DeepZoom Render::DeepZoom::FromDouble(double zoom)
+{
+	DeepZoom result;
+	result.mantissa = std::frexp(zoom, &result.exponent);
+
+	return result;
+}
+
+Render::DeepZoom Render::DeepZoom::FromString(cstring text)
+{
+	// split mantissa and decimal exponent, the whole value may not fit a double
+	cstring const separator = std::strpbrk(text, "eE");
+
+	double const mantissa	= std::strtod(separator ? std::string(text, separator).c_str() : text, nullptr);
+	long const	 decimal	= separator ? std::strtol(separator + 1, nullptr, 10) : 0;
+
+	if (!(mantissa > 0.) || !std::isfinite(mantissa))
+		return FromDouble(1.);
+
+	double const log2		= std::log2(mantissa) + double(decimal) * 3.32192809488736234787;
+	double const exponent	= std::floor(log2);
+
+	DeepZoom result;
+	result.mantissa = std::exp2(log2 - exponent);
+	result.exponent = int32(exponent);
+
+	return result;
+}
+
+Render::DeepZoom Render::DeepZoom::Deepest(uint32 height)
+{
+	DeepZoom deepest;
+	deepest.mantissa = 1.;
+	deepest.exponent = int32(std::ceil(std::log2(double(std::max(height, 1u))) + GUARD_BITS)) - DeepReal::FRACTION_BITS;
+
+	return deepest;
+}
+
+double Render::DeepZoom::Log2() const
+{
+	return std::log2(mantissa) + double(exponent);
+}
+
+Render::DeepView Render::DeepView::FromView(FractalView const & view)
+{
+	DeepView deep;
+	deep.offset			= { DeepReal::FromDouble(view.offset.x), DeepReal::FromDouble(view.offset.y) };
+	deep.zoom			= DeepZoom::FromDouble(view.zoom);
+	deep.canvas			= view.canvas;
+	deep.maxIterations	= view.maxIterations;
+	deep.fractal		= view.fractal;
+	deep.juliaConstant	= view.juliaConstant;
+	deep.colorModifier	= view.colorModifier;
+
+	return deep;
+}
+
+Render::DeepView Render::DeepView::FromCenter(FractalView const & view, math::vec2<DeepReal> center, DeepZoom zoom)
+{
+	DeepZoom const deepest = DeepZoom::Deepest(view.canvas.y);
+
+	if (zoom.Log2() < deepest.Log2())
+		zoom = deepest;
+
+	DeepView deep	= FromView(view);
+	deep.zoom		= zoom;
+
+	deep.offset.x = center.x - DeepReal::FromDouble(zoom.mantissa * view.AspectRatio() / 2., zoom.exponent);
+	deep.offset.y = center.y - DeepReal::FromDouble(zoom.mantissa / 2., zoom.exponent);
+
+	return deep;
+}
+
+Render::ReferenceOrbit Render::ComputeReferenceOrbit(DeepView const & view, math::vec2u pixel)
+{
+	double const height = double(view.canvas.y);
+
+	math::vec2<DeepReal> point;
+	point.x = view.offset.x + DeepReal::FromDouble((double(pixel.x) + .5) / height * view.zoom.mantissa, view.zoom.exponent);
+	point.y = view.offset.y + DeepReal::FromDouble((height - double(pixel.y) - .5) / height * view.zoom.mantissa, view.zoom.exponent);
+
+	ReferenceOrbit reference;
+	reference.pixel = pixel;
+
+	// the pixel spacing plus guard bits, never past DeepReal for a zoom within DeepZoom::Deepest
+	double const requiredBits = std::log2(height) - view.zoom.Log2() + GUARD_BITS;
+
+	if		(requiredBits <= math::FixedPoint<4>::FRACTION_BITS)	IterateReference<4>	(view, point, reference);
+	else if (requiredBits <= math::FixedPoint<8>::FRACTION_BITS)	IterateReference<8>	(view, point, reference);
+	else if (requiredBits <= math::FixedPoint<16>::FRACTION_BITS)	IterateReference<16>(view, point, reference);
+	else if (requiredBits <= math::FixedPoint<32>::FRACTION_BITS)	IterateReference<32>(view, point, reference);
+	else															IterateReference<DEEP_LIMBS>(view, point, reference);
+
+	return reference;
+}
+
+Render::ScaledComplex Render::ScaledComplex::Normalized() const
+{
+	double const largest = std::max(std::abs(re), std::abs(im));
+
+	if (largest == 0.)
+		return { 0., 0., 0 };
+
+	int32 shift;
+	std::frexp(largest, &shift);
+
+	return { std::ldexp(re, -shift), std::ldexp(im, -shift), exponent + shift };
+}
+
+double Render::ScaledComplex::Log2Abs() const
+{
+	if (re == 0. && im == 0.)
+		return -HUGE_VAL;
+
+	return std::log2(std::hypot(re, im)) + double(exponent);
+}
+
+Render::ScaledComplex Render::ScaledComplex::Abs() const
+{
+	return ScaledComplex{ std::hypot(re, im), 0., exponent }.Normalized();
+}
+
+Render::ScaledComplex Render::ScaledComplex::operator+(ScaledComplex const & other) const
+{
+	if (other.re == 0. && other.im == 0.)
+		return *this;
+
+	if (re == 0. && im == 0.)
+		return other;
+
+	ScaledComplex const & larger	= exponent >= other.exponent ? *this : other;
+	ScaledComplex const & smaller	= exponent >= other.exponent ? other : *this;
+
+	int32 const shift = smaller.exponent - larger.exponent;
+
+	return ScaledComplex{ larger.re + std::ldexp(smaller.re, shift), larger.im + std::ldexp(smaller.im, shift), larger.exponent }.Normalized();
+}
+
+Render::ScaledComplex Render::ScaledComplex::operator*(ScaledComplex const & other) const
+{
+	return ScaledComplex{ re * other.re - im * other.im, re * other.im + im * other.re, exponent + other.exponent }.Normalized();
+}
+
+Render::ScaledComplex Render::SeriesApproximation::Evaluate(double ux, double uy) const
+{
+	ScaledComplex const u = ScaledComplex{ ux, uy, 0 }.Normalized();
+
+	return ((terms[2] * u + terms[1]) * u + terms[0]) * u;
+}
+
+Render::SeriesApproximation Render::ComputeSeriesApproximation(DeepView const & view, ReferenceOrbit const & reference)
+{
+	bool const	 isMandelbrot	= view.fractal == FractalType::MANDELBROT;
+	uint32 const length			= uint32(reference.re.size());
+	int32 const	 zoomExponent	= view.zoom.exponent;
+
+	// the farthest corner bounds |u| over the view
+	double const height	= double(view.canvas.y);
+	double const farX	= std::max(double(reference.pixel.x), double(view.canvas.x) - double(reference.pixel.x));
+	double const farY	= std::max(double(reference.pixel.y), height - double(reference.pixel.y));
+
+	ScaledComplex const U	= ScaledComplex{ std::hypot(farX, farY) / height * view.zoom.mantissa, 0., 0 }.Normalized();
+	ScaledComplex const U2	= U * U;
+	ScaledComplex const U3	= U2 * U;
+	ScaledComplex const U4	= U2 * U2;
+
+	// a' = 2Za + 1, b' = 2Zb + 2^e a^2, c' = 2Zc + 2^e 2ab, Julia starts from a = 1 and has no constant
+	ScaledComplex const one		= { .5, 0., 1 };
+	ScaledComplex const two		= { .5, 0., 2 };
+	ScaledComplex const zero	= { 0., 0., 0 };
+
+	ScaledComplex a = isMandelbrot ? zero : one;
+	ScaledComplex b = zero;
+	ScaledComplex c = zero;
+
+	// Everything the cubic leaves out, |d - 2^e (au + bu^2 + cu^3)| <= 2^e r |u|^4 for
+	// every |u| <= U. Squaring the series adds the terms past u^3 and the cross terms
+	// with the remainder, the rest of it grows by 2Z like the coefficients do:
+	//		r' = 2|Z| r + 2^e (|b|^2 + 2|ac| + 2|bc|U + |c|^2 U^2 + 2r (|a| + |b|U + |c|U^2) + r^2 U^4)
+	ScaledComplex r = zero;
+
+	SeriesApproximation series;
+
+	for (uint32 n = 0u; n < view.maxIterations && n + 1u < length; ++n)
+	{
+		ScaledComplex const absA = a.Abs();
+		ScaledComplex const absB = b.Abs();
+		ScaledComplex const absC = c.Abs();
+
+		// the remainder stays this far below the first term all over the view
+		if (n && r.Log2Abs() + U3.Log2Abs() > absA.Log2Abs() - SERIES_BITS)
+			break;
+
+		series.skipped		= n;
+		series.terms[0]		= a;
+		series.terms[1]		= b;
+		series.terms[2]		= c;
+		series.remainder	= r;
+
+		// no pixel may escape within the skipped iterations
+		ScaledComplex reach = absA * U + absB * U2 + absC * U3 + r * U4;
+		reach.exponent += zoomExponent;
+
+		if (std::hypot(reference.re[n], reference.im[n]) + std::exp2(reach.Log2Abs()) >= std::sqrt(double(LIMIT_THRESHOLD)))
+			break;
+
+		ScaledComplex const twoZ	= ScaledComplex{ 2. * reference.re[n], 2. * reference.im[n], 0 }.Normalized();
+		ScaledComplex const span	= absA + absB * U + absC * U2;
+
+		ScaledComplex squared = absB * absB + two * absA * absC + two * absB * absC * U + absC * absC * U2 +
+								two * r * span + r * r * U4;
+		squared.exponent += zoomExponent;
+
+		r = twoZ.Abs() * r + squared;
+
+		ScaledComplex squareA	= a * a;
+		ScaledComplex twoAB		= a * b;
+		squareA.exponent	+= zoomExponent;
+		twoAB.exponent		+= zoomExponent + 1;
+
+		c = twoZ * c + twoAB;
+		b = twoZ * b + squareA;
+		a = isMandelbrot ? twoZ * a + one : twoZ * a;
+	}
+
+	return series;
+}
+
+bool Render::IteratePerturbed(DeepView const & view, ReferenceOrbit const & reference, SeriesApproximation const & series,
+							  uint32 x, uint32 y, EscapeSample & sample)
+{
+	bool const	 isMandelbrot	= view.fractal == FractalType::MANDELBROT;
+	uint32 const length			= uint32(reference.re.size());
+	double const height			= double(view.canvas.y);
+	int32 const	 zoomExponent	= view.zoom.exponent;
+
+	// distance to the reference in units of the zoom
+	double const ux = (double(x) - double(reference.pixel.x)) / height * view.zoom.mantissa;
+	double const uy = (double(reference.pixel.y) - double(y)) / height * view.zoom.mantissa;
+
+	double const * const Zx = reference.re.data();
+	double const * const Zy = reference.im.data();
+
+	sample = { view.maxIterations, 0.f };
+
+	uint32 iteration = series.skipped;
+
+	ScaledComplex delta = { isMandelbrot ? 0. : ux, isMandelbrot ? 0. : uy, zoomExponent };
+
+	if (series.skipped)
+	{
+		delta			 = series.Evaluate(ux, uy);
+		delta.exponent	+= zoomExponent;
+	}
+
+	// d = w * 2^scale until d becomes representable, the d^2 term stays
+	// below the last bit of 2 * Z * d and underflows along the way
+	int32  scale = std::max(zoomExponent, delta.re == 0. && delta.im == 0. ? zoomExponent : delta.exponent);
+	double wx	 = std::ldexp(delta.re, delta.exponent - scale);
+	double wy	 = std::ldexp(delta.im, delta.exponent - scale);
+	double wcx	 = isMandelbrot ? std::ldexp(ux, zoomExponent - scale) : 0.;
+	double wcy	 = isMandelbrot ? std::ldexp(uy, zoomExponent - scale) : 0.;
+
+	// Bound on the absolute error of z, in units of 2^scale as long as w is: what the
+	// series leaves out and what every step rounds off, grown by |2z| like any
+	// difference in z is. Far from the reference the pixel is iterated in plain doubles
+	// and a chaotic one can drift off its true orbit, it glitches as soon as the bound
+	// leaves open which side of the escape radius z is on.
+	double error = ROUNDING_ERROR * (std::abs(wx) + std::abs(wy));
+
+	if (series.skipped)
+	{
+		ScaledComplex const distance	= ScaledComplex{ std::hypot(ux, uy), 0., 0 }.Normalized();
+		ScaledComplex const left		= series.remainder * (distance * distance) * (distance * distance);
+
+		error += std::ldexp(left.re, left.exponent + zoomExponent - scale);
+	}
+
+	for (; scale < PLAIN_EXPONENT; ++iteration)
+	{
+		if (iteration >= view.maxIterations)
+			return true;
+
+		if (iteration >= length)
+			return false;
+
+		// z is Z to the last bit
+		double const norm = Zx[iteration] * Zx[iteration] + Zy[iteration] * Zy[iteration];
+
+		if (norm > double(LIMIT_THRESHOLD))
+		{
+			sample = EscapedSample(norm, iteration, view.maxIterations);
+			return true;
+		}
+
+		double const nx = 2. * (Zx[iteration] * wx - Zy[iteration] * wy) + std::ldexp(wx * wx - wy * wy, scale) + wcx;
+		double const ny = 2. * (Zx[iteration] * wy + Zy[iteration] * wx) + std::ldexp(2. * wx * wy, scale) + wcy;
+
+		error = error * 2. * std::sqrt(norm) + ROUNDING_ERROR * (2. * (std::abs(Zx[iteration]) + std::abs(Zy[iteration])) *
+				(std::abs(wx) + std::abs(wy)) + std::abs(wcx) + std::abs(wcy));
+
+		wx = nx;
+		wy = ny;
+
+		if (std::max(std::abs(wx), std::abs(wy)) > RESCALE_LIMIT)
+		{
+			wx		= std::ldexp(wx,	-RESCALE_BITS);
+			wy		= std::ldexp(wy,	-RESCALE_BITS);
+			wcx		= std::ldexp(wcx,	-RESCALE_BITS);
+			wcy		= std::ldexp(wcy,	-RESCALE_BITS);
+			error	= std::ldexp(error,	-RESCALE_BITS);
+			scale  += RESCALE_BITS;
+		}
+	}
+
+	double dx	= std::ldexp(wx,  scale);
+	double dy	= std::ldexp(wy,  scale);
+	double dcx	= std::ldexp(wcx, scale);
+	double dcy	= std::ldexp(wcy, scale);
+
+	double const escapeRadius	= std::sqrt(double(LIMIT_THRESHOLD));
+	double const dcSize			= std::abs(dcx) + std::abs(dcy);
+
+	error = std::ldexp(error, scale);
+
+	// the reference index, rebasing takes it back to the start of the orbit
+	uint32 n = iteration;
+
+	for (; iteration < view.maxIterations; ++iteration, ++n)
+	{
+		if (n >= length)
+			return false;
+
+		double const zx		= Zx[n] + dx;
+		double const zy		= Zy[n] + dy;
+		double const norm	= zx * zx + zy * zy;
+		double const radius	= std::sqrt(norm);
+
+		if (error >= std::abs(radius - escapeRadius))
+			return false;
+
+		if (norm > double(LIMIT_THRESHOLD))
+		{
+			sample = EscapedSample(norm, iteration, view.maxIterations);
+			return true;
+		}
+
+		// Once z is closer to the orbit's start than to Z_n the difference to Z_n carries
+		// fewer bits of z than a difference to Z_0 would, which is where the cancellation
+		// glitches come from: the pixel carries on from Z_0 with the smaller difference.
+		double const rx = zx - Zx[0];
+		double const ry = zy - Zy[0];
+
+		if (n && rx * rx + ry * ry < dx * dx + dy * dy)
+		{
+			dx		= rx;
+			dy		= ry;
+			n		= 0u;
+			error  += ROUNDING_ERROR * (std::abs(zx) + std::abs(zy));
+		}
+
+		double const size	= std::abs(dx) + std::abs(dy);
+		double const nx		= 2. * (Zx[n] * dx - Zy[n] * dy) + dx * dx - dy * dy + dcx;
+		double const ny		= 2. * (Zx[n] * dy + Zy[n] * dx) + 2. * dx * dy + dcy;
+
+		error = error * (2. * radius + error) +
+				ROUNDING_ERROR * ((2. * (std::abs(Zx[n]) + std::abs(Zy[n])) + size) * size + dcSize);
+
+		dx = nx;
+		dy = ny;
+	}
+
+	return true;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "EscapeTime.hpp"
+
+#include <Math/FixedPoint.inl>
+
+// Deep zoom through perturbation: one orbit is iterated in high precision and every
+// pixel only follows its difference to it in doubles, z = Z + d with
+//		d' = 2 * Z * d + d^2 + dc
+// A pixel that comes closer to the start of the orbit than to Z rebases onto the start.
+// Pixels that outlive the orbit or whose rounding error could decide their count are
+// re-rendered around a reference taken from among them, and once that stops settling
+// them each is iterated as its own reference. While the differences are still tiny
+// every pixel follows the same cubic in its offset, so the first iterations can be
+// skipped by evaluating that series instead.
+
+namespace Render
+{
+	// 2016 fractional bits, less the canvas height and the reference's 64 guard bits: zooms
+	// down to 2^-1941 (~1e-584) at 1080 rows, see DeepZoom::Deepest
+	constexpr uint32 DEEP_LIMBS = 64u;
+
+	typedef math::FixedPoint<DEEP_LIMBS> DeepReal;
+
+	// zoom = mantissa * 2^exponent, since 1e-300 is close to the bottom of a double
+	struct DeepZoom
+	{
+		double	mantissa;
+		int32	exponent;
+
+		static DeepZoom FromDouble(double zoom);
+
+		// decimal scientific notation, "1e-300", "2.5e-500"
+		static DeepZoom FromString(cstring text);
+
+		// the deepest zoom whose pixels and reference orbit DeepReal still resolves on a
+		// canvas this many rows high
+		static DeepZoom Deepest(uint32 height);
+
+		double Log2() const;
+	};
+
+	// Same layout as FractalView, offset still being the bottom left corner
+	struct DeepView
+	{
+		math::vec2<DeepReal>	offset;
+		DeepZoom				zoom;
+		math::vec2u				canvas;
+		uint32					maxIterations;
+		FractalType				fractal;
+		math::vec2f				juliaConstant;
+		math::vec3f				colorModifier;
+
+		static DeepView FromView(FractalView const & view);
+
+		// offset such that the view is centred on the given point, zooms past
+		// DeepZoom::Deepest are clamped to it since DeepReal could not place the pixels
+		static DeepView FromCenter(FractalView const & view, math::vec2<DeepReal> center, DeepZoom zoom);
+
+		uint64 inline PixelCount() const {
+			return uint64(canvas.x) * canvas.y;
+		}
+	};
+
+	struct ReferenceOrbit
+	{
+		math::vec2u			pixel;		// the reference sits on this pixel's centre
+		uint32				limbs;		// precision it was iterated with
+		std::vector<double>	re, im;		// Z_0 .. Z_n, continued past the escape radius
+	};
+
+	// (re + i * im) * 2^exponent, the series coefficients outgrow a double long before 1e-300
+	struct ScaledComplex
+	{
+		double	re, im;
+		int32	exponent;
+
+		ScaledComplex	Normalized()	const;
+		ScaledComplex	Abs()			const;
+		double			Log2Abs()		const;
+
+		ScaledComplex operator+(ScaledComplex const & other) const;
+		ScaledComplex operator*(ScaledComplex const & other) const;
+	};
+
+	// d_skipped = 2^zoom.exponent * (a * u + b * u^2 + c * u^3), u being the pixel's
+	// distance to the reference in units of the zoom mantissa, off by no more than
+	// 2^zoom.exponent * remainder * |u|^4 anywhere in the view
+	struct SeriesApproximation
+	{
+		uint32			skipped		{0u};
+		ScaledComplex	terms[3]	{};
+		ScaledComplex	remainder	{};
+
+		ScaledComplex Evaluate(double ux, double uy) const;
+	};
+
+	ReferenceOrbit ComputeReferenceOrbit(DeepView const & view, math::vec2u pixel);
+
+	// Skips as far as a bound on everything the cubic leaves out stays 40 bits below
+	// its first term over the whole view and no pixel can escape. The bound goes on into
+	// each pixel's rounding error, so a pixel the skip could change glitches instead.
+	SeriesApproximation ComputeSeriesApproximation(DeepView const & view, ReferenceOrbit const & reference);
+
+	// false when the pixel glitched, either outliving its orbit or with a bound on its
+	// rounding error that reaches the escape radius, the sample is only meaningful when true
+	bool IteratePerturbed(DeepView const & view, ReferenceOrbit const & reference, SeriesApproximation const & series,
+						  uint32 x, uint32 y, EscapeSample & sample);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <Util.h>
+
+namespace Render
+{
+	// Raw escape-time result of every pixel, row 0 is the top of the image
+	struct IterationBuffer
+	{
+		uint32				width	{0u};
+		uint32				height	{0u};
+
+		std::vector<uint32>	iterations;
+		std::vector<float>	smooth;
+
+		void inline Resize(uint32 newWidth, uint32 newHeight)
+		{
+			width	= newWidth;
+			height	= newHeight;
+
+			iterations.resize(size_t(width) * height);
+			smooth.resize(size_t(width) * height);
+		}
+
+		size_t inline Index(uint32 x, uint32 y) const {
+			return size_t(y) * width + x;
+		}
+	};
+
+	// Packed RGBA8 pixels (R in the lowest byte), row 0 is the top of the image
+	struct ColorBuffer
+	{
+		uint32				width	{0u};
+		uint32				height	{0u};
+
+		std::vector<uint32>	pixels;
+
+		void inline Resize(uint32 newWidth, uint32 newHeight)
+		{
+			width	= newWidth;
+			height	= newHeight;
+
+			pixels.resize(size_t(width) * height);
+		}
+
+		size_t inline Index(uint32 x, uint32 y) const {
+			return size_t(y) * width + x;
+		}
+	};
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "SimdKernels.hpp"
+
+// Lane-parallel version of Render::Iterate. Only included by the Escape<ISA>.cpp
+// files, between SIMD_TARGET_BEGIN and SIMD_TARGET_END, with an Ops type wrapping
+// the intrinsics of one instruction set.
+
+namespace Render
+{
+	namespace Kernels
+	{
+		// pixelAt(i) gives the coordinates of the i-th pixel to iterate and constantAt(i)
+		// its Julia constant, returns the iterations saved like Render::Iterate
+		template<typename Ops, typename PixelAt, typename ConstantAt>
+		uint64 EscapeLanes(FractalView const & view, uint32 count, PixelAt pixelAt, ConstantAt constantAt, EscapeSample * samples)
+		{
+			typedef typename Ops::scalar	scalar;
+			typedef typename Ops::vec		vec;
+			typedef typename Ops::mask		mask;
+
+			constexpr uint32 LANES = Ops::LANES;
+
+			bool const isMandelbrot = view.fractal == FractalType::MANDELBROT;
+
+			alignas(64) scalar pointX[LANES];
+			alignas(64) scalar pointY[LANES];
+			alignas(64) scalar juliaX[LANES];
+			alignas(64) scalar juliaY[LANES];
+			alignas(64) scalar norms [LANES];
+
+			vec const limit		= Ops::Set(scalar(LIMIT_THRESHOLD));
+			vec const two		= Ops::Set(scalar(2));
+
+			uint64 saved = 0u;
+
+			for (uint32 first = 0u; first < count; first += LANES)
+			{
+				uint32 const lanes = std::min(LANES, count - first);
+
+				EscapeSample * out		= samples + first;
+				uint32		   active	= (1u << lanes) - 1u;
+				uint32		   iteration = 0u;
+
+				// lanes past the end of the span repeat the last pixel and are never written back
+				for (uint32 lane = 0u; lane < LANES; ++lane)
+				{
+					uint32 const		index		= first + std::min(lane, lanes - 1u);
+					math::vec2u const	pixel		= pixelAt(index);
+					math::vec2f const	constant	= constantAt(index);
+					math::vec2<scalar>	point		= PixelToPoint<scalar>(view, pixel.x, pixel.y);
+
+					pointX[lane] = point.x;
+					pointY[lane] = point.y;
+					juliaX[lane] = scalar(constant.x);
+					juliaY[lane] = scalar(constant.y);
+
+					if (isMandelbrot && lane < lanes && IsInMainComponents(point))
+					{
+						out[lane]	= { view.maxIterations, 0.f };
+						saved	   += view.maxIterations;
+						active	   &= ~(1u << lane);
+					}
+				}
+
+				if (!active)
+					continue;
+
+				vec x	= isMandelbrot ? Ops::Set(scalar(0)) : Ops::Load(pointX);
+				vec y	= isMandelbrot ? Ops::Set(scalar(0)) : Ops::Load(pointY);
+				vec cx	= Ops::Load(isMandelbrot ? pointX : juliaX);
+				vec cy	= Ops::Load(isMandelbrot ? pointY : juliaY);
+
+				vec	   cycleX	  = x;
+				vec	   cycleY	  = y;
+				uint32 checkpoint = 1u;
+
+				for (; iteration < view.maxIterations; ++iteration)
+				{
+					vec x2	 = Ops::Mul(x, x);
+					vec y2	 = Ops::Mul(y, y);
+					vec norm = Ops::Add(x2, y2);
+
+					// escaped lanes are frozen below, so they stay in this mask
+					mask   escapedMask	= Ops::Greater(norm, limit);
+					uint32 escaped		= Ops::Bits(escapedMask) & active;
+
+					if (escaped)
+					{
+						Ops::Store(norms, norm);
+						active &= ~escaped;
+
+						for (; escaped; escaped &= escaped - 1u)
+						{
+							uint32 const lane = LowestSetBit(escaped);
+
+							out[lane].iterations = iteration;
+							out[lane].smooth	 = iteration ? SmoothIteration(float(norms[lane]), iteration - 1u) : 0.f;
+						}
+
+						if (!active)
+							break;
+					}
+
+					vec nextX = Ops::Add(Ops::Sub(x2, y2), cx);
+					vec nextY = Ops::Add(Ops::Mul(Ops::Mul(two, x), y), cy);
+
+					x = Ops::Select(escapedMask, x, nextX);
+					y = Ops::Select(escapedMask, y, nextY);
+
+					// all lanes share the iteration count, so they also share Brent's checkpoints
+					uint32 periodic = Ops::Bits(Ops::Equal(x, cycleX)) & Ops::Bits(Ops::Equal(y, cycleY)) & active;
+
+					if (periodic)
+					{
+						active &= ~periodic;
+
+						for (; periodic; periodic &= periodic - 1u)
+						{
+							uint32 const lane = LowestSetBit(periodic);
+
+							out[lane]	= { view.maxIterations, 0.f };
+							saved	   += view.maxIterations - iteration - 1u;
+						}
+
+						if (!active)
+							break;
+					}
+
+					if (iteration + 1u == checkpoint)
+					{
+						cycleX		= x;
+						cycleY		= y;
+						checkpoint <<= 1u;
+					}
+				}
+
+				for (; active; active &= active - 1u)
+				{
+					uint32 const lane = LowestSetBit(active);
+
+					out[lane].iterations = view.maxIterations;
+					out[lane].smooth	 = 0.f;
+				}
+			}
+
+			return saved;
+		}
+
+		template<typename Ops>
+		uint64 EscapeSpan(FractalView const & view, uint32 row, uint32 column, uint32 count, EscapeSample * samples)
+		{
+			return EscapeLanes<Ops>(view, count, [=](uint32 i) { return math::vec2u{ column + i, row }; },
+									[&](uint32) { return view.juliaConstant; }, samples);
+		}
+
+		template<typename Ops>
+		uint64 EscapePixels(FractalView const & view, math::vec2u const * pixels, uint32 count, EscapeSample * samples)
+		{
+			return EscapeLanes<Ops>(view, count, [=](uint32 i) { return pixels[i]; },
+									[&](uint32) { return view.juliaConstant; }, samples);
+		}
+
+		// the lanes hold the same pixel in Julia sets of different constants
+		template<typename Ops>
+		uint64 EscapeJulia(FractalView const & view, math::vec2u pixel, math::vec2f const * constants, uint32 count, EscapeSample * samples)
+		{
+			FractalView julia = view;
+			julia.fractal = FractalType::JULIA;
+
+			return EscapeLanes<Ops>(julia, count, [=](uint32) { return pixel; }, [=](uint32 i) { return constants[i]; }, samples);
+		}
+	}
+}
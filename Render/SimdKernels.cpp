@@ -0,0 +1,205 @@
+#include "SimdKernels.hpp"
+
+#if RENDER_X86 && !defined(_MSC_VER)
+	#include <cpuid.h>
+#endif
+
+namespace
+{
+#if RENDER_X86
+	struct CpuidRegisters
+	{
+		uint32 eax, ebx, ecx, edx;
+	};
+
+	CpuidRegisters QueryCpuid(uint32 leaf, uint32 subleaf = 0u)
+	{
+		CpuidRegisters registers{ 0u, 0u, 0u, 0u };
+
+	#ifdef _MSC_VER
+		int values[4];
+		__cpuidex(values, int(leaf), int(subleaf));
+
+		registers = { uint32(values[0]), uint32(values[1]), uint32(values[2]), uint32(values[3]) };
+	#else
+		__cpuid_count(leaf, subleaf, registers.eax, registers.ebx, registers.ecx, registers.edx);
+	#endif
+
+		return registers;
+	}
+
+	// which register files the OS saves on a context switch
+	uint64 QueryEnabledStates()
+	{
+	#ifdef _MSC_VER
+		return _xgetbv(0);
+	#else
+		uint32 low, high;
+		__asm__ volatile("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+
+		return (uint64(high) << 32) | low;
+	#endif
+	}
+#endif
+
+	Render::EscapeKernel const k_kernels[] =
+	{
+		{ "Scalar float",	Render::InstructionSet::SCALAR, Render::Precision::FLOAT,	1u,		Render::Kernels::EscapeSpanScalar<float>,
+			Render::Kernels::EscapePixelsScalar<float>,		Render::Kernels::EscapeJuliaScalar<float>	},
+		{ "Scalar double",	Render::InstructionSet::SCALAR, Render::Precision::DOUBLE,	1u,		Render::Kernels::EscapeSpanScalar<double>,
+			Render::Kernels::EscapePixelsScalar<double>,	Render::Kernels::EscapeJuliaScalar<double>	},
+		{ "Scalar double-double",	Render::InstructionSet::SCALAR, Render::Precision::DOUBLE_DOUBLE,	1u,
+			Render::Kernels::EscapeSpanScalar<math::DoubleDouble>,	Render::Kernels::EscapePixelsScalar<math::DoubleDouble>,
+			Render::Kernels::EscapeJuliaScalar<math::DoubleDouble>	},
+		{ "Scalar quad-double",		Render::InstructionSet::SCALAR, Render::Precision::QUAD_DOUBLE,		1u,
+			Render::Kernels::EscapeSpanScalar<math::QuadDouble>,	Render::Kernels::EscapePixelsScalar<math::QuadDouble>,
+			Render::Kernels::EscapeJuliaScalar<math::QuadDouble>	},
+	#if RENDER_X86
+		{ "SSE2 float",		Render::InstructionSet::SSE2,	Render::Precision::FLOAT,	4u,		Render::Kernels::EscapeSpanSse2F,	Render::Kernels::EscapePixelsSse2F,		Render::Kernels::EscapeJuliaSse2F	},
+		{ "SSE2 double",	Render::InstructionSet::SSE2,	Render::Precision::DOUBLE,	2u,		Render::Kernels::EscapeSpanSse2D,	Render::Kernels::EscapePixelsSse2D,		Render::Kernels::EscapeJuliaSse2D	},
+		{ "AVX2 float",		Render::InstructionSet::AVX2,	Render::Precision::FLOAT,	8u,		Render::Kernels::EscapeSpanAvx2F,	Render::Kernels::EscapePixelsAvx2F,		Render::Kernels::EscapeJuliaAvx2F	},
+		{ "AVX2 double",	Render::InstructionSet::AVX2,	Render::Precision::DOUBLE,	4u,		Render::Kernels::EscapeSpanAvx2D,	Render::Kernels::EscapePixelsAvx2D,		Render::Kernels::EscapeJuliaAvx2D	},
+		{ "AVX-512 float",	Render::InstructionSet::AVX512, Render::Precision::FLOAT,	16u,	Render::Kernels::EscapeSpanAvx512F,	Render::Kernels::EscapePixelsAvx512F,	Render::Kernels::EscapeJuliaAvx512F	},
+		{ "AVX-512 double",	Render::InstructionSet::AVX512, Render::Precision::DOUBLE,	8u,		Render::Kernels::EscapeSpanAvx512D,	Render::Kernels::EscapePixelsAvx512D,	Render::Kernels::EscapeJuliaAvx512D	},
+	#endif
+	};
+}
+
+Render::InstructionSet Render::DetectInstructionSet()
+{
+	static InstructionSet const k_detected = []() -> InstructionSet
+	{
+	#if RENDER_X86
+		constexpr uint32 SSE2_BIT		= ENUM(26);	// leaf 1, edx
+		constexpr uint32 OSXSAVE_BIT	= ENUM(27);	// leaf 1, ecx
+		constexpr uint32 AVX_BIT		= ENUM(28);	// leaf 1, ecx
+		constexpr uint32 AVX2_BIT		= ENUM(5);	// leaf 7, ebx
+		constexpr uint32 AVX512F_BIT	= ENUM(16);	// leaf 7, ebx
+
+		constexpr uint64 YMM_STATE		= 0x06u;	// XMM | YMM
+		constexpr uint64 ZMM_STATE		= 0xE6u;	// XMM | YMM | opmask | ZMM_Hi256 | Hi16_ZMM
+
+		if (QueryCpuid(0u).eax < 1u)
+			return InstructionSet::SCALAR;
+
+		CpuidRegisters features = QueryCpuid(1u);
+
+		if (!(features.edx & SSE2_BIT))
+			return InstructionSet::SCALAR;
+
+		if (!(features.ecx & OSXSAVE_BIT) || !(features.ecx & AVX_BIT) || QueryCpuid(0u).eax < 7u)
+			return InstructionSet::SSE2;
+
+		uint64			enabledStates	= QueryEnabledStates();
+		CpuidRegisters	extended		= QueryCpuid(7u);
+
+		if ((enabledStates & YMM_STATE) != YMM_STATE || !(extended.ebx & AVX2_BIT))
+			return InstructionSet::SSE2;
+
+		if ((enabledStates & ZMM_STATE) != ZMM_STATE || !(extended.ebx & AVX512F_BIT))
+			return InstructionSet::AVX2;
+
+		return InstructionSet::AVX512;
+	#else
+		return InstructionSet::SCALAR;
+	#endif
+	}();
+
+	return k_detected;
+}
+
+std::vector<Render::EscapeKernel> Render::GetAvailableKernels()
+{
+	InstructionSet const supported = DetectInstructionSet();
+
+	std::vector<EscapeKernel> kernels;
+
+	for (auto const & kernel : k_kernels)
+	{
+		if (kernel.instructionSet <= supported)
+			kernels.push_back(kernel);
+	}
+
+	return kernels;
+}
+
+Render::EscapeKernel Render::SelectKernel(Precision precision, InstructionSet limit)
+{
+	InstructionSet const supported = std::min(DetectInstructionSet(), limit);
+
+	// every precision has a scalar kernel, those come first
+	EscapeKernel selected = *std::find_if(std::begin(k_kernels), std::end(k_kernels),
+		[precision](EscapeKernel const & kernel) { return kernel.precision == precision; });
+
+	for (auto const & kernel : k_kernels)
+	{
+		if (kernel.precision == precision &&
+			kernel.instructionSet <= supported &&
+			kernel.instructionSet > selected.instructionSet)
+		{
+			selected = kernel;
+		}
+	}
+
+	return selected;
+}
+
+Render::Precision Render::FitPrecision(FractalView const & view)
+{
+	constexpr int32 GUARD_BITS = 4;
+
+	// mantissa bits, a little short of the full 106 and 212 for the sums of doubles
+	struct Tier
+	{
+		Precision	precision;
+		int32		bits;
+	};
+
+	constexpr Tier TIERS[] =
+	{
+		{ Precision::FLOAT,			24	},
+		{ Precision::DOUBLE,		53	},
+		{ Precision::DOUBLE_DOUBLE,	104	},
+		{ Precision::QUAD_DOUBLE,	208	},
+	};
+
+	double const width		= view.zoom * double(view.canvas.x) / double(view.canvas.y);
+	double const spacing	= view.zoom / double(view.canvas.y);
+
+	// orbits wander up to the escape radius whatever the view
+	double const magnitude = std::max({ std::sqrt(double(LIMIT_THRESHOLD)),
+										std::abs(view.offset.x), std::abs(view.offset.x + width),
+										std::abs(view.offset.y), std::abs(view.offset.y + view.zoom) });
+
+	for (auto const & tier : TIERS)
+	{
+		if (spacing >= std::ldexp(magnitude, GUARD_BITS - tier.bits))
+			return tier.precision;
+	}
+
+	return Precision::QUAD_DOUBLE;
+}
+
+cstring Render::ToString(InstructionSet instructionSet)
+{
+	switch (instructionSet)
+	{
+		case InstructionSet::SSE2:		return "SSE2";
+		case InstructionSet::AVX2:		return "AVX2";
+		case InstructionSet::AVX512:	return "AVX-512";
+		case InstructionSet::SCALAR:
+		default:						return "Scalar";
+	}
+}
+
+cstring Render::ToString(Precision precision)
+{
+	switch (precision)
+	{
+		case Precision::DOUBLE:			return "double";
+		case Precision::DOUBLE_DOUBLE:	return "double-double";
+		case Precision::QUAD_DOUBLE:	return "quad-double";
+		case Precision::FLOAT:
+		default:						return "float";
+	}
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "EscapeTime.hpp"
+#include "SimdTarget.hpp"
+
+namespace Render
+{
+	// cheapest first, see FitPrecision
+	enum class Precision:
+		byte
+	{
+		FLOAT,
+		DOUBLE,
+		DOUBLE_DOUBLE,	// math::DoubleDouble, scalar only
+		QUAD_DOUBLE		// math::QuadDouble, scalar only
+	};
+
+	enum class InstructionSet:
+		byte
+	{
+		SCALAR,
+		SSE2,
+		AVX2,
+		AVX512
+	};
+
+	// Iterates `count` pixels of `row` starting at `column`, the samples are written in order.
+	// Returns the iterations saved by the interior checks, see Render::Iterate
+	typedef uint64(*EscapeSpanFunc)(FractalView const & view, uint32 row, uint32 column, uint32 count, EscapeSample * samples);
+
+	// Iterates an arbitrary list of pixels, bit exact with the span version
+	typedef uint64(*EscapePixelsFunc)(FractalView const & view, math::vec2u const * pixels, uint32 count, EscapeSample * samples);
+
+	// Iterates one pixel of the view as a Julia set once per constant, sample i being what
+	// the span version gives for that pixel with juliaConstant = constants[i]
+	typedef uint64(*EscapeJuliaFunc)(FractalView const & view, math::vec2u pixel, math::vec2f const * constants, uint32 count, EscapeSample * samples);
+
+	struct EscapeKernel
+	{
+		cstring				name;
+		InstructionSet		instructionSet;
+		Precision			precision;
+		uint32				lanes;
+		EscapeSpanFunc		function;
+		EscapePixelsFunc	pixels;
+		EscapeJuliaFunc		julia;
+	};
+
+	InstructionSet				DetectInstructionSet();
+	std::vector<EscapeKernel>	GetAvailableKernels();
+	EscapeKernel				SelectKernel(Precision precision, InstructionSet limit = InstructionSet::AVX512);
+
+	// The cheapest precision in which neighbouring pixels are still 16 ulps apart at the
+	// largest coordinate the view or an orbit reaches, QUAD_DOUBLE when none is enough
+	Precision FitPrecision(FractalView const & view);
+
+	cstring ToString(InstructionSet instructionSet);
+	cstring ToString(Precision precision);
+
+	namespace Kernels
+	{
+		template<typename T>
+		uint64 EscapeSpanScalar(FractalView const & view, uint32 row, uint32 column, uint32 count, EscapeSample * samples)
+		{
+			uint64 saved = 0u;
+
+			for (uint32 i = 0u; i < count; ++i)
+			{
+				uint32 pixelSaved;
+
+				samples[i]	= Iterate(PixelToPoint<T>(view, column + i, row), view, pixelSaved);
+				saved	   += pixelSaved;
+			}
+
+			return saved;
+		}
+
+		template<typename T>
+		uint64 EscapePixelsScalar	(FractalView const & view, math::vec2u const * pixels, uint32 count, EscapeSample * samples)
+		{
+			uint64 saved = 0u;
+
+			for (uint32 i = 0u; i < count; ++i)
+			{
+				uint32 pixelSaved;
+
+				samples[i]	= Iterate(PixelToPoint<T>(view, pixels[i].x, pixels[i].y), view, pixelSaved);
+				saved	   += pixelSaved;
+			}
+
+			return saved;
+		}
+
+		template<typename T>
+		uint64 EscapeJuliaScalar	(FractalView const & view, math::vec2u pixel, math::vec2f const * constants, uint32 count, EscapeSample * samples)
+		{
+			math::vec2<T> const point	= PixelToPoint<T>(view, pixel.x, pixel.y);
+			FractalView			julia	= view;
+			uint64				saved	= 0u;
+
+			julia.fractal = FractalType::JULIA;
+
+			for (uint32 i = 0u; i < count; ++i)
+			{
+				uint32 pixelSaved;
+
+				julia.juliaConstant	= constants[i];
+				samples[i]			= Iterate(point, julia, pixelSaved);
+				saved			   += pixelSaved;
+			}
+
+			return saved;
+		}
+
+	#if RENDER_X86
+		uint64 EscapeSpanSse2F	(FractalView const & view, uint32 row, uint32 column, uint32 count, EscapeSample * samples);
+		uint64 EscapeSpanSse2D	(FractalView const & view, uint32 row, uint32 column, uint32 count, EscapeSample * samples);
+		uint64 EscapeSpanAvx2F	(FractalView const & view, uint32 row, uint32 column, uint32 count, EscapeSample * samples);
+		uint64 EscapeSpanAvx2D	(FractalView const & view, uint32 row, uint32 column, uint32 count, EscapeSample * samples);
+		uint64 EscapeSpanAvx512F	(FractalView const & view, uint32 row, uint32 column, uint32 count, EscapeSample * samples);
+		uint64 EscapeSpanAvx512D	(FractalView const & view, uint32 row, uint32 column, uint32 count, EscapeSample * samples);
+
+		uint64 EscapePixelsSse2F	(FractalView const & view, math::vec2u const * pixels, uint32 count, EscapeSample * samples);
+		uint64 EscapePixelsSse2D	(FractalView const & view, math::vec2u const * pixels, uint32 count, EscapeSample * samples);
+		uint64 EscapePixelsAvx2F	(FractalView const & view, math::vec2u const * pixels, uint32 count, EscapeSample * samples);
+		uint64 EscapePixelsAvx2D	(FractalView const & view, math::vec2u const * pixels, uint32 count, EscapeSample * samples);
+		uint64 EscapePixelsAvx512F	(FractalView const & view, math::vec2u const * pixels, uint32 count, EscapeSample * samples);
+		uint64 EscapePixelsAvx512D	(FractalView const & view, math::vec2u const * pixels, uint32 count, EscapeSample * samples);
+
+		uint64 EscapeJuliaSse2F		(FractalView const & view, math::vec2u pixel, math::vec2f const * constants, uint32 count, EscapeSample * samples);
+		uint64 EscapeJuliaSse2D		(FractalView const & view, math::vec2u pixel, math::vec2f const * constants, uint32 count, EscapeSample * samples);
+		uint64 EscapeJuliaAvx2F		(FractalView const & view, math::vec2u pixel, math::vec2f const * constants, uint32 count, EscapeSample * samples);
+		uint64 EscapeJuliaAvx2D		(FractalView const & view, math::vec2u pixel, math::vec2f const * constants, uint32 count, EscapeSample * samples);
+		uint64 EscapeJuliaAvx512F	(FractalView const & view, math::vec2u pixel, math::vec2f const * constants, uint32 count, EscapeSample * samples);
+		uint64 EscapeJuliaAvx512D	(FractalView const & view, math::vec2u pixel, math::vec2f const * constants, uint32 count, EscapeSample * samples);
+	#endif
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <Util.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define RENDER_X86 1
+#else
+	#define RENDER_X86 0
+#endif
+
+#define RENDER_PRAGMA(x) _Pragma(#x)
+
+// Functions defined between SIMD_TARGET_BEGIN and SIMD_TARGET_END may use the
+// given instruction set. GCC must not fuse mul/add into FMA there, otherwise
+// the vector kernels would no longer match the scalar path bit for bit.
+#if defined(__clang__)
+	#define SIMD_TARGET_BEGIN(isa)	RENDER_PRAGMA(clang attribute push(__attribute__((target(isa))), apply_to = function))
+	#define SIMD_TARGET_END()		RENDER_PRAGMA(clang attribute pop)
+#elif defined(__GNUC__)
+	#define SIMD_TARGET_BEGIN(isa)	RENDER_PRAGMA(GCC push_options) RENDER_PRAGMA(GCC target(isa)) RENDER_PRAGMA(GCC optimize("fp-contract=off"))
+	#define SIMD_TARGET_END()		RENDER_PRAGMA(GCC pop_options)
+#else
+	// MSVC emits any intrinsic regardless of /arch
+	#define SIMD_TARGET_BEGIN(isa)
+	#define SIMD_TARGET_END()
+#endif
+
+#ifdef _MSC_VER
+	#include <intrin.h>
+#endif
+
+namespace Render
+{
+	uint32 inline LowestSetBit(uint32 bits)
+	{
+	#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward(&index, bits);
+		return index;
+	#else
+		return __builtin_ctz(bits);
+	#endif
+	}
+}
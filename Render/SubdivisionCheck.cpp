@@ -0,0 +1,79 @@
+#include "SubdivisionCheck.hpp"
+
+namespace
+{
+	struct SuiteView
+	{
+		cstring			name;
+		float			zoom;
+		math::vec2f		center;
+		uint32			maxIterations;
+		FractalType		fractal;
+		math::vec2f		juliaConstant;
+	};
+
+	SuiteView const k_suite[] =
+	{
+		{ "Mandelbrot default",		2.3f,		{ -0.55f,	  0.f		},	600u,	FractalType::MANDELBROT,	{ 0.f,		0.f		} },
+		{ "Cardioid interior",		0.1f,		{ -0.2f,	  0.1f		},	2000u,	FractalType::MANDELBROT,	{ 0.f,		0.f		} },
+		{ "Seahorse valley",		0.05f,		{ -0.745f,	  0.11f		},	2000u,	FractalType::MANDELBROT,	{ 0.f,		0.f		} },
+		{ "Period 3 bulb edge",		0.02f,		{ -0.1226f,	  0.7449f	},	3000u,	FractalType::MANDELBROT,	{ 0.f,		0.f		} },
+		{ "Minibrot on the axis",	0.0005f,	{ -1.7497f,	  0.f		},	4000u,	FractalType::MANDELBROT,	{ 0.f,		0.f		} },
+		{ "Elephant valley",		0.02f,		{  0.2825f,	  0.01f		},	3000u,	FractalType::MANDELBROT,	{ 0.f,		0.f		} },
+		{ "Julia default",			2.3f,		{  0.f,		  0.f		},	600u,	FractalType::JULIA,			{ 0.285f,	0.01f	} },
+		{ "Julia Douady rabbit",	3.f,		{  0.f,		  0.f		},	1000u,	FractalType::JULIA,			{ -0.123f,	0.745f	} },
+		{ "Julia dendrite",			3.f,		{  0.f,		  0.f		},	1000u,	FractalType::JULIA,			{ 0.f,		1.f		} },
+	};
+}
+
+std::vector<Render::SubdivisionCheckResult> Render::CheckSubdivision(math::vec2u canvas, RenderOptions options)
+{
+	std::vector<SubdivisionCheckResult> results;
+
+	FractalEngine engine(0u, options);
+
+	IterationBuffer	bruteIterations,	subdividedIterations;
+	ColorBuffer		bruteColors,		subdividedColors;
+
+	for (auto const & entry : k_suite)
+	{
+		FractalView view;
+		view.zoom			= entry.zoom;
+		view.canvas			= canvas;
+		view.maxIterations	= entry.maxIterations;
+		view.fractal		= entry.fractal;
+		view.juliaConstant	= entry.juliaConstant;
+		view.colorModifier	= { 1.f, 1.f, 1.f };
+		view.offset			= { entry.center.x - entry.zoom * view.AspectRatio() / 2.f, entry.center.y - entry.zoom / 2.f };
+
+		options.subdivision = Subdivision::BRUTE_FORCE;
+		engine.SetOptions(options);
+
+		RenderStats const brute = engine.RenderFrame(view, bruteIterations, bruteColors);
+
+		options.subdivision = Subdivision::MARIANI_SILVER;
+		engine.SetOptions(options);
+
+		RenderStats const subdivided = engine.RenderFrame(view, subdividedIterations, subdividedColors);
+
+		SubdivisionCheckResult result;
+		result.name			= entry.name;
+		result.pixels		= view.PixelCount();
+		result.filled		= subdivided.filled;
+		result.bruteForce	= brute.elapsed;
+		result.subdivided	= subdivided.elapsed;
+
+		for (size_t i = 0u; i < bruteColors.pixels.size(); ++i)
+		{
+			if (bruteIterations.iterations[i] != subdividedIterations.iterations[i] ||
+				bruteColors.pixels[i] != subdividedColors.pixels[i])
+			{
+				++result.mismatches;
+			}
+		}
+
+		results.push_back(result);
+	}
+
+	return results;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "FractalEngine.hpp"
+
+namespace Render
+{
+	struct SubdivisionCheckResult
+	{
+		cstring					name;
+		uint64					pixels				{0u};
+		uint64					mismatches			{0u};	// iteration count or colour differs from brute force
+		uint64					filled				{0u};
+		Misc::clock::duration	bruteForce			{0};
+		Misc::clock::duration	subdivided			{0};
+
+		double inline Speedup() const {
+			return subdivided.count() ? double(bruteForce.count()) / double(subdivided.count()) : 0.;
+		}
+	};
+
+	// Renders a fixed suite of views both brute force and with Mariani-Silver subdivision
+	// and compares them pixel by pixel
+	std::vector<SubdivisionCheckResult> CheckSubdivision(math::vec2u canvas, RenderOptions options = RenderOptions());
+}
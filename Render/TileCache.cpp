@@ -0,0 +1,283 @@
+#include "TileCache.hpp"
+
+#ifndef _WIN32
+	#include <sys/stat.h>
+#endif
+
+namespace
+{
+	constexpr uint32 TILE_MAGIC		= 0x4C495446u;	// "FTIL"
+	constexpr uint32 TILE_VERSION	= 2u;	// 2: tile offsets are no longer rounded to float
+
+	struct TileHeader
+	{
+		uint32			magic;
+		uint32			version;
+		Render::TileKey	key;
+	};
+
+	constexpr size_t TILE_FILE_SIZE = sizeof(TileHeader) + Render::CACHE_TILE_SAMPLES * (sizeof(uint32) + sizeof(float));
+
+	static_assert(sizeof(TileHeader) % sizeof(uint32) == 0u, "tile samples have to stay aligned in the mapping");
+
+	cstring const INDEX_NAME = "index.txt";
+}
+
+Render::TileKey Render::TileKey::FromView(FractalView const & view, Precision precision, int32 level, int64 x, int64 y)
+{
+	TileKey key;
+	key.fractal			= view.fractal;
+	key.precision		= precision;
+	key.maxIterations	= view.maxIterations;
+	key.juliaConstant	= view.fractal == FractalType::JULIA ? view.juliaConstant : math::vec2f{ 0.f, 0.f };
+	key.level			= level;
+	key.x				= x;
+	key.y				= y;
+
+	return key;
+}
+
+uint64 Render::TileKey::Hash() const
+{
+	uint64 hash = 14695981039346656037ull;
+
+	auto Mix = [&hash](void const * data, size_t size)
+	{
+		for (size_t i = 0u; i < size; ++i)
+		{
+			hash ^= static_cast<byte const *>(data)[i];
+			hash *= 1099511628211ull;
+		}
+	};
+
+	// field by field, the padding between them is undefined
+	Mix(&fractal,			sizeof(fractal));
+	Mix(&precision,			sizeof(precision));
+	Mix(&maxIterations,		sizeof(maxIterations));
+	Mix(&juliaConstant.x,	sizeof(float));
+	Mix(&juliaConstant.y,	sizeof(float));
+	Mix(&level,				sizeof(level));
+	Mix(&x,					sizeof(x));
+	Mix(&y,					sizeof(y));
+
+	return hash;
+}
+
+bool Render::TileKey::operator==(TileKey const & other) const
+{
+	return fractal == other.fractal && precision == other.precision && maxIterations == other.maxIterations &&
+		   juliaConstant.x == other.juliaConstant.x && juliaConstant.y == other.juliaConstant.y &&
+		   level == other.level && x == other.x && y == other.y;
+}
+
+Render::FractalView Render::TileKey::ToView() const
+{
+	double const span = Span();
+
+	FractalView view;
+	view.zoom			= span;
+	view.offset			= { double(x) * span, double(y) * span };
+	view.canvas			= { CACHE_TILE_SIZE, CACHE_TILE_SIZE };
+	view.maxIterations	= maxIterations;
+	view.fractal		= fractal;
+	view.juliaConstant	= juliaConstant;
+	view.colorModifier	= { 1.f, 1.f, 1.f };
+
+	return view;
+}
+
+Render::TileCache::TileCache(std::string directory, uint64 capacity):
+	m_directory(std::move(directory)),
+	m_capacity(capacity)
+{
+#ifdef _WIN32
+	CreateDirectoryA(m_directory.c_str(), nullptr);
+#else
+	mkdir(m_directory.c_str(), 0755);
+#endif
+
+	LoadIndex();
+}
+
+Render::TileCache::~TileCache()
+{
+	SaveIndex();
+}
+
+std::string Render::TileCache::GetPath(uint64 hash) const
+{
+	char name[32];
+	std::snprintf(name, sizeof(name), "/%016llx.tile", static_cast<unsigned long long>(hash));
+
+	return m_directory + name;
+}
+
+void Render::TileCache::Touch(uint64 hash, uint64 bytes)
+{
+	auto const found = m_entries.find(hash);
+
+	if (found != m_entries.end())
+	{
+		m_size -= found->second->bytes;
+		m_recent.erase(found->second);
+	}
+
+	m_recent.push_front({ hash, bytes });
+	m_entries[hash]	 = m_recent.begin();
+	m_size			+= bytes;
+
+	// the tile just touched always stays
+	while (m_size > m_capacity && m_recent.size() > 1u)
+	{
+		Entry const oldest = m_recent.back();
+
+		std::remove(GetPath(oldest.hash).c_str());
+
+		m_size -= oldest.bytes;
+		m_entries.erase(oldest.hash);
+		m_recent.pop_back();
+
+		++m_evictions;
+	}
+}
+
+void Render::TileCache::LoadIndex()
+{
+	std::ifstream index(m_directory + "/" + INDEX_NAME);
+
+	unsigned long long hash, bytes;
+
+	// most recent first, so every entry goes to the back
+	while (index >> std::hex >> hash >> std::dec >> bytes)
+	{
+		if (m_entries.count(hash))
+			continue;
+
+		m_recent.push_back({ hash, bytes });
+		m_entries[hash]	 = std::prev(m_recent.end());
+		m_size			+= bytes;
+	}
+
+	while (m_size > m_capacity && !m_recent.empty())
+	{
+		std::remove(GetPath(m_recent.back().hash).c_str());
+
+		m_size -= m_recent.back().bytes;
+		m_entries.erase(m_recent.back().hash);
+		m_recent.pop_back();
+	}
+}
+
+void Render::TileCache::SaveIndex()
+{
+	std::lock_guard<std::mutex> guard(m_lock);
+
+	std::ofstream index(m_directory + "/" + INDEX_NAME, std::ios::trunc);
+
+	for (auto const & entry : m_recent)
+		index << std::hex << std::setw(16) << std::setfill('0') << entry.hash << ' ' << std::dec << entry.bytes << '\n';
+}
+
+bool Render::TileCache::Load(TileKey const & key, Misc::MappedFile & file, TileSamples & samples)
+{
+	uint64 const hash = key.Hash();
+
+	bool valid = file.Open(GetPath(hash)) && file.GetSize() == TILE_FILE_SIZE;
+
+	// a hash collision or a tile from an older version counts as a miss and gets overwritten
+	if (valid)
+	{
+		TileHeader header;
+		std::memcpy(&header, file.GetData(), sizeof(header));
+
+		valid = header.magic == TILE_MAGIC && header.version == TILE_VERSION && header.key == key;
+	}
+
+	if (!valid)
+	{
+		file.Close();
+		++m_misses;
+
+		return false;
+	}
+
+	byte const * data = file.GetData() + sizeof(TileHeader);
+
+	samples.iterations	= reinterpret_cast<uint32 const *>(data);
+	samples.smooth		= reinterpret_cast<float const *>(data + CACHE_TILE_SAMPLES * sizeof(uint32));
+
+	++m_hits;
+
+	std::lock_guard<std::mutex> guard(m_lock);
+	Touch(hash, TILE_FILE_SIZE);
+
+	return true;
+}
+
+void Render::TileCache::Store(TileKey const & key, uint32 const * iterations, float const * smooth)
+{
+	uint64 const		hash = key.Hash();
+	std::string const	path = GetPath(hash);
+
+	// written aside and renamed, a concurrent Load never maps half a tile
+	std::ostringstream temporary;
+	temporary << path << '.' << std::this_thread::get_id() << ".tmp";
+
+	{
+		TileHeader header;
+		header.magic	= TILE_MAGIC;
+		header.version	= TILE_VERSION;
+		header.key		= key;
+
+		std::ofstream file(temporary.str(), std::ios::binary | std::ios::trunc);
+
+		file.write(reinterpret_cast<char const *>(&header), sizeof(header));
+		file.write(reinterpret_cast<char const *>(iterations), CACHE_TILE_SAMPLES * sizeof(uint32));
+		file.write(reinterpret_cast<char const *>(smooth), CACHE_TILE_SAMPLES * sizeof(float));
+
+		if (!file)
+		{
+			file.close();
+			std::remove(temporary.str().c_str());
+
+			return;
+		}
+	}
+
+	std::remove(path.c_str());
+
+	if (std::rename(temporary.str().c_str(), path.c_str()))
+	{
+		std::remove(temporary.str().c_str());
+		return;
+	}
+
+	std::lock_guard<std::mutex> guard(m_lock);
+	Touch(hash, TILE_FILE_SIZE);
+}
+
+uint64 Render::TileCache::GetHits() const
+{
+	return m_hits;
+}
+
+uint64 Render::TileCache::GetMisses() const
+{
+	return m_misses;
+}
+
+uint64 Render::TileCache::GetEvictions() const
+{
+	return m_evictions;
+}
+
+uint64 Render::TileCache::GetSize()
+{
+	std::lock_guard<std::mutex> guard(m_lock);
+	return m_size;
+}
+
+uint64 Render::TileCache::GetCapacity() const
+{
+	return m_capacity;
+}
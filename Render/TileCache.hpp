@@ -0,0 +1,105 @@
+#pragma once
+
+#include "EscapeTime.hpp"
+#include "SimdKernels.hpp"
+
+#include <Utils/MappedFile.h>
+
+#include <list>
+
+// Escape-time tiles of the complex plane kept on disk between runs. Tiles form a
+// quadtree: at `level` the plane is cut into squares of CACHE_ROOT_SPAN / 2^level,
+// tile (x, y) covering [x, x + 1) * span horizontally and [y, y + 1) * span vertically,
+// each sampled CACHE_TILE_SIZE times per side at the sample centres. A file is named
+// after the hash of its key and holds the key itself, then the iterations and smooth
+// values with row 0 at the top, so a lookup is a single mapping.
+
+namespace Render
+{
+	constexpr uint32 CACHE_TILE_SIZE	= 64u;
+	constexpr uint32 CACHE_TILE_SAMPLES	= CACHE_TILE_SIZE * CACHE_TILE_SIZE;
+	constexpr double CACHE_ROOT_SPAN	= 8.;
+
+	struct TileKey
+	{
+		FractalType		fractal;
+		Precision		precision;
+		uint32			maxIterations;
+		math::vec2f		juliaConstant;	// zero for the Mandelbrot set
+		int32			level;
+		int64			x, y;
+
+		static TileKey FromView(FractalView const & view, Precision precision, int32 level, int64 x, int64 y);
+
+		// FNV-1a of the fields, names the file
+		uint64 Hash() const;
+
+		bool operator==(TileKey const & other) const;
+
+		double inline Span() const {
+			return std::ldexp(CACHE_ROOT_SPAN, -level);
+		}
+
+		// the tile as a CACHE_TILE_SIZE square view, kernels sample it like any other
+		FractalView ToView() const;
+	};
+
+	struct TileSamples
+	{
+		uint32 const *	iterations;
+		float const *	smooth;
+	};
+
+	// Least recently used tiles get deleted once the files outgrow the capacity.
+	// Safe to use from several threads at once.
+	class TileCache:
+		public Misc::Noncopyable
+	{
+		struct Entry
+		{
+			uint64 hash;
+			uint64 bytes;
+		};
+
+		std::string					m_directory;
+		uint64						m_capacity;
+
+		std::mutex					m_lock;
+		std::list<Entry>			m_recent;	// most recently used first
+		std::unordered_map<uint64, std::list<Entry>::iterator> m_entries;
+		uint64						m_size	{0u};
+
+		std::atomic<uint64>			m_hits		{0u};
+		std::atomic<uint64>			m_misses	{0u};
+		std::atomic<uint64>			m_evictions	{0u};
+
+		std::string GetPath(uint64 hash) const;
+
+		// m_lock held, moves the entry to the front and evicts past the capacity
+		void Touch(uint64 hash, uint64 bytes);
+
+		void LoadIndex();
+
+		public:
+
+			static constexpr uint64 DEFAULT_CAPACITY = 512ull << 20u;
+
+			// creates the directory if needed and picks up the tiles of the last run
+			explicit TileCache(std::string directory, uint64 capacity = DEFAULT_CAPACITY);
+			~TileCache();
+
+			// maps the tile into `file`, samples point into it as long as it stays open
+			bool Load(TileKey const & key, Misc::MappedFile & file, TileSamples & samples);
+
+			void Store(TileKey const & key, uint32 const * iterations, float const * smooth);
+
+			// writes the LRU order next to the tiles, done on destruction as well
+			void SaveIndex();
+
+			uint64 GetHits()		const;
+			uint64 GetMisses()		const;
+			uint64 GetEvictions()	const;
+			uint64 GetSize();
+			uint64 GetCapacity()	const;
+	};
+}
@@ -0,0 +1,151 @@
+#include "TileScheduler.hpp"
+
+std::vector<Render::Tile> Render::SplitIntoTiles(uint32 width, uint32 height, uint32 tileSize)
+{
+	tileSize = std::max(1u, tileSize);
+
+	std::vector<Tile> tiles;
+	tiles.reserve(size_t((width + tileSize - 1u) / tileSize) * ((height + tileSize - 1u) / tileSize));
+
+	for (uint32 y = 0u; y < height; y += tileSize)
+	{
+		for (uint32 x = 0u; x < width; x += tileSize)
+		{
+			tiles.push_back({ x, y, std::min(tileSize, width - x), std::min(tileSize, height - y) });
+		}
+	}
+
+	return tiles;
+}
+
+Render::WorkStealingPool::WorkStealingPool(uint32 workerCount)
+{
+	workerCount = workerCount ? workerCount : std::max(1u, std::thread::hardware_concurrency());
+
+	for (uint32 i = 0u; i < workerCount; ++i)
+		m_queues.emplace_back(new TaskQueue());
+
+	for (uint32 i = 0u; i < workerCount; ++i)
+		m_threads.emplace_back(&WorkStealingPool::WorkerLoop, this, i);
+}
+
+Render::WorkStealingPool::~WorkStealingPool()
+{
+	{
+		std::lock_guard<std::mutex> guard{ m_stateLock };
+		m_stop = true;
+	}
+
+	m_wakeWorkers.notify_all();
+
+	for (auto & thread : m_threads)
+		thread.join();
+}
+
+bool Render::WorkStealingPool::TryPop(uint32 worker, Task & task)
+{
+	TaskQueue & queue = *m_queues[worker];
+	std::lock_guard<std::mutex> guard{ queue.lock };
+
+	if (queue.tasks.empty())
+		return false;
+
+	task = std::move(queue.tasks.front());
+	queue.tasks.pop_front();
+
+	return true;
+}
+
+bool Render::WorkStealingPool::TrySteal(uint32 worker, Task & task)
+{
+	uint32 const workerCount = GetWorkerCount();
+
+	for (uint32 i = 1u; i < workerCount; ++i)
+	{
+		TaskQueue & victim = *m_queues[(worker + i) % workerCount];
+		std::lock_guard<std::mutex> guard{ victim.lock };
+
+		if (victim.tasks.empty())
+			continue;
+
+		task = std::move(victim.tasks.back());
+		victim.tasks.pop_back();
+
+		++m_steals;
+		return true;
+	}
+
+	return false;
+}
+
+void Render::WorkStealingPool::Drain(uint32 worker)
+{
+	Task task;
+
+	while (TryPop(worker, task) || TrySteal(worker, task))
+	{
+		task(worker);
+
+		if (--m_pending == 0u)
+		{
+			std::lock_guard<std::mutex> guard{ m_stateLock };
+			m_batchDone.notify_all();
+		}
+	}
+}
+
+void Render::WorkStealingPool::WorkerLoop(uint32 worker)
+{
+	uint64 seenGeneration = 0u;
+
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock{ m_stateLock };
+			m_wakeWorkers.wait(lock, [&]() { return m_stop || m_generation != seenGeneration; });
+
+			if (m_stop)
+				return;
+
+			seenGeneration = m_generation;
+		}
+
+		Drain(worker);
+	}
+}
+
+void Render::WorkStealingPool::Run(std::vector<Task> tasks)
+{
+	if (tasks.empty())
+		return;
+
+	uint32 const workerCount	= GetWorkerCount();
+	size_t const blockSize		= (tasks.size() + workerCount - 1u) / workerCount;
+
+	m_pending = tasks.size();
+
+	for (size_t i = 0u; i < tasks.size(); ++i)
+	{
+		TaskQueue & queue = *m_queues[i / blockSize];
+		std::lock_guard<std::mutex> guard{ queue.lock };
+
+		queue.tasks.push_back(std::move(tasks[i]));
+	}
+
+	std::unique_lock<std::mutex> lock{ m_stateLock };
+
+	++m_generation;
+	m_wakeWorkers.notify_all();
+
+	m_batchDone.wait(lock, [this]() { return m_pending == 0u; });
+}
+
+uint32 Render::WorkStealingPool::GetWorkerCount() const
+{
+	return uint32(m_queues.size());
+}
+
+uint64 Render::WorkStealingPool::GetStealCount() const
+{
+	return m_steals;
+}
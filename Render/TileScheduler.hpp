@@ -0,0 +1,74 @@
+#pragma once
+
+#include <Util.h>
+#include <Utils/Stopwatch.h>
+
+#include <deque>
+#include <functional>
+#include <condition_variable>
+
+namespace Render
+{
+	struct Tile
+	{
+		uint32 x, y;
+		uint32 width, height;
+	};
+
+	struct TileTiming
+	{
+		Tile					tile;
+		uint32					worker;
+		uint64					iterations;
+		Misc::clock::duration	elapsed;
+	};
+
+	std::vector<Tile> SplitIntoTiles(uint32 width, uint32 height, uint32 tileSize);
+
+	// Fixed set of threads, each owning a deque of tasks. A worker takes tasks from
+	// the front of its own deque and, once it runs dry, steals from the back of the others.
+	class WorkStealingPool:
+		public Misc::Noncopyable
+	{
+		public:
+
+			typedef std::function<void(uint32 worker)> Task;
+
+		private:
+
+			struct TaskQueue
+			{
+				std::mutex			lock;
+				std::deque<Task>	tasks;
+			};
+
+			std::vector<std::unique_ptr<TaskQueue>>	m_queues;
+			std::vector<std::thread>				m_threads;
+
+			std::mutex				m_stateLock;
+			std::condition_variable	m_wakeWorkers;
+			std::condition_variable	m_batchDone;
+
+			uint64					m_generation	{0u};
+			bool					m_stop			{false};
+			std::atomic<uint64>		m_pending		{0u};
+			std::atomic<uint64>		m_steals		{0u};
+
+			bool TryPop		(uint32 worker, Task & task);
+			bool TrySteal	(uint32 worker, Task & task);
+
+			void WorkerLoop	(uint32 worker);
+			void Drain		(uint32 worker);
+
+		public:
+
+			explicit WorkStealingPool(uint32 workerCount = 0u);
+			~WorkStealingPool();
+
+			// Deals the tasks out in contiguous blocks and blocks until all of them ran
+			void Run(std::vector<Task> tasks);
+
+			uint32 GetWorkerCount() const;
+			uint64 GetStealCount()	const;
+	};
+}
@@ -0,0 +1,464 @@
+#include "ZoomAnimation.hpp"
+
+#include <Utils/PngWriter.h>
+
+namespace
+{
+	// frame pixels over which the inner keyframe fades in at its border, shrinking to none as the frame reaches it
+	constexpr double FEATHER_PIXELS = 16.;
+
+	// below this doubles hold the zoom itself, let alone the offset
+	constexpr double DOUBLE_LOG2_LIMIT = -1000.;
+
+	struct Keyframe
+	{
+		uint32				index	{~0u};
+		Render::ColorBuffer	colors;
+	};
+
+	// box filter of every frame pixel's footprint along one axis, scale keyframe pixels per frame pixel
+	struct Taps
+	{
+		uint32				stride	{0u};
+		std::vector<uint32>	index;
+		std::vector<float>	weight;
+		std::vector<float>	feather;	// of the pixel centre, 1 a full FEATHER_PIXELS inside the keyframe, 0 outside
+	};
+
+	void BuildTaps(uint32 size, uint32 keySize, double scale, double featherPixels, Taps & taps)
+	{
+		taps.stride = uint32(std::ceil(scale)) + 1u;
+
+		taps.index.assign(size_t(size) * taps.stride, 0u);
+		taps.weight.assign(size_t(size) * taps.stride, 0.f);
+		taps.feather.resize(size);
+
+		for (uint32 i = 0u; i < size; ++i)
+		{
+			double const center	= double(keySize) / 2. + (double(i) + .5 - double(size) / 2.) * scale;
+			double const low	= center - scale / 2.;
+			double const high	= center + scale / 2.;
+			double const first	= std::floor(low);
+
+			for (uint32 tap = 0u; tap < taps.stride; ++tap)
+			{
+				double const cell		= first + double(tap);
+				double const overlap	= std::min(high, cell + 1.) - std::max(low, cell);
+
+				if (overlap <= 0.)
+					continue;
+
+				taps.index[size_t(i) * taps.stride + tap]	= uint32(std::min(std::max(cell, 0.), double(keySize - 1u)));
+				taps.weight[size_t(i) * taps.stride + tap]	= float(overlap / scale);
+			}
+
+			double const inside = std::min(center, double(keySize) - center) / scale;
+
+			taps.feather[i] = float(std::min(std::max(inside / featherPixels, 0.), 1.));
+		}
+	}
+
+	// the filtered colour of frame pixel (x, y), as floats
+	void inline Sample(Render::ColorBuffer const & key, Taps const & columns, Taps const & rows, uint32 x, uint32 y, float * rgb)
+	{
+		rgb[0] = rgb[1] = rgb[2] = 0.f;
+
+		for (uint32 row = 0u; row < rows.stride; ++row)
+		{
+			float const rowWeight = rows.weight[size_t(y) * rows.stride + row];
+
+			if (rowWeight == 0.f)
+				continue;
+
+			uint32 const * const line = &key.pixels[key.Index(0u, rows.index[size_t(y) * rows.stride + row])];
+
+			for (uint32 column = 0u; column < columns.stride; ++column)
+			{
+				float const weight = rowWeight * columns.weight[size_t(x) * columns.stride + column];
+
+				if (weight == 0.f)
+					continue;
+
+				uint32 const pixel = line[columns.index[size_t(x) * columns.stride + column]];
+
+				rgb[0] += weight * float(pixel & 0xFFu);
+				rgb[1] += weight * float((pixel >> 8u) & 0xFFu);
+				rgb[2] += weight * float((pixel >> 16u) & 0xFFu);
+			}
+		}
+	}
+
+	bool HasExtension(std::string const & path, cstring extension)
+	{
+		size_t const length = std::strlen(extension);
+
+		if (path.size() < length)
+			return false;
+
+		std::string tail = path.substr(path.size() - length);
+		std::transform(tail.begin(), tail.end(), tail.begin(), [](char c) { return char(std::tolower(c)); });
+
+		return tail == extension;
+	}
+
+	// numbered images or one I420 stream, chosen by the extension of the output
+	class FrameWriter
+	{
+		enum class Format
+		{
+			PPM,
+			PNG,
+			YUV
+		};
+
+		Format				m_format	{Format::PPM};
+		std::ofstream		m_stream;
+		Misc::PngWriter		m_png;
+		std::vector<byte>	m_bytes;
+
+		// the output split around its %[0-9]*[ud], the name is never used as a printf format
+		std::string			m_prefix;
+		std::string			m_suffix;
+		size_t				m_width		{0u};
+		char				m_padding	{' '};
+
+		std::string FramePath(uint32 frame) const
+		{
+			std::string const number = std::to_string(frame);
+
+			std::string path = m_prefix;
+			path.append(m_width > number.size() ? m_width - number.size() : 0u, m_padding);
+			path += number;
+			path += m_suffix;
+
+			return path;
+		}
+
+		// one number in the name, written as %u or %d with an optional width, a leading 0 pads
+		// it with zeros; any other conversion or a second % is refused
+		bool SplitOutput(std::string const & output)
+		{
+			size_t const conversion = output.find('%');
+
+			if (conversion == std::string::npos)
+				return false;
+
+			size_t const digits	= conversion + 1u;
+			size_t const type	= output.find_first_not_of("0123456789", digits);
+
+			if (type == std::string::npos || (output[type] != 'u' && output[type] != 'd') || type - digits > 2u ||
+				output.find('%', type + 1u) != std::string::npos)
+			{
+				return false;
+			}
+
+			m_prefix	= output.substr(0u, conversion);
+			m_suffix	= output.substr(type + 1u);
+			m_width		= type > digits ? size_t(std::stoul(output.substr(digits, type - digits))) : 0u;
+			m_padding	= type > digits && output[digits] == '0' ? '0' : ' ';
+
+			return true;
+		}
+
+		public:
+
+			bool Open(std::string const & output, math::vec2u size)
+			{
+				if (HasExtension(output, ".yuv"))
+				{
+					// 4:2:0 halves both sides of the chroma planes
+					if (size.x % 2u || size.y % 2u)
+						return false;
+
+					m_format = Format::YUV;
+					m_stream.open(output, std::ios::binary | std::ios::trunc);
+
+					return bool(m_stream);
+				}
+
+				m_format = HasExtension(output, ".png") ? Format::PNG : Format::PPM;
+
+				return SplitOutput(output);
+			}
+
+			bool Write(Render::ColorBuffer const & frame, uint32 index)
+			{
+				size_t const pixels = size_t(frame.width) * frame.height;
+
+				if (m_format == Format::PNG)
+				{
+					return m_png.Open(FramePath(index), frame.width, frame.height) &&
+						   m_png.WriteRows(frame.pixels.data(), frame.height) && m_png.Close();
+				}
+
+				if (m_format == Format::PPM)
+				{
+					std::ofstream file(FramePath(index), std::ios::binary | std::ios::trunc);
+					file << "P6\n" << frame.width << ' ' << frame.height << "\n255\n";
+
+					m_bytes.resize(3u * pixels);
+
+					for (size_t i = 0u; i < pixels; ++i)
+					{
+						m_bytes[3u * i]			= byte(frame.pixels[i]);
+						m_bytes[3u * i + 1u]	= byte(frame.pixels[i] >> 8u);
+						m_bytes[3u * i + 2u]	= byte(frame.pixels[i] >> 16u);
+					}
+
+					file.write(reinterpret_cast<char const *>(m_bytes.data()), std::streamsize(m_bytes.size()));
+
+					return bool(file);
+				}
+
+				// BT.709, limited range, each chroma sample the average of a 2x2 square
+				m_bytes.resize(pixels + pixels / 2u);
+
+				byte * const luma	= m_bytes.data();
+				byte * const blue	= luma + pixels;
+				byte * const red	= blue + pixels / 4u;
+
+				for (uint32 y = 0u; y < frame.height; y += 2u)
+				{
+					for (uint32 x = 0u; x < frame.width; x += 2u)
+					{
+						float sumBlue	= 0.f;
+						float sumRed	= 0.f;
+
+						for (uint32 i = 0u; i < 4u; ++i)
+						{
+							size_t const index	= frame.Index(x + (i & 1u), y + (i >> 1u));
+							uint32 const pixel	= frame.pixels[index];
+
+							float const r = float(pixel & 0xFFu) / 255.f;
+							float const g = float((pixel >> 8u) & 0xFFu) / 255.f;
+							float const b = float((pixel >> 16u) & 0xFFu) / 255.f;
+
+							float const l = .2126f * r + .7152f * g + .0722f * b;
+
+							luma[index]	 = byte(16.f + 219.f * l + .5f);
+							sumBlue		+= (b - l) / 1.8556f;
+							sumRed		+= (r - l) / 1.5748f;
+						}
+
+						size_t const chroma = size_t(y / 2u) * (frame.width / 2u) + x / 2u;
+
+						blue[chroma]	= byte(128.f + 224.f * sumBlue / 4.f + .5f);
+						red[chroma]		= byte(128.f + 224.f * sumRed / 4.f + .5f);
+					}
+				}
+
+				m_stream.write(reinterpret_cast<char const *>(m_bytes.data()), std::streamsize(m_bytes.size()));
+
+				return bool(m_stream);
+			}
+
+			bool Close()
+			{
+				if (m_format != Format::YUV)
+					return true;
+
+				m_stream.close();
+
+				return !m_stream.fail();
+			}
+	};
+
+	Render::DeepZoom ZoomFromLog2(double log2)
+	{
+		Render::DeepZoom zoom;
+		zoom.exponent = int32(std::floor(log2));
+		zoom.mantissa = std::exp2(log2 - double(zoom.exponent));
+
+		return zoom;
+	}
+
+	// doubles where they resolve the keyframe, perturbation past that
+	Render::RenderStats RenderKeyframe(Render::FractalEngine & engine, Render::AnimationSettings const & settings, double log2Zoom,
+									   math::vec2u size, Render::IterationBuffer & iterations, Render::ColorBuffer & colors)
+	{
+		Render::FractalView view = settings.view;
+		view.canvas = size;
+
+		Render::DeepView const deep = Render::DeepView::FromCenter(view, settings.center, ZoomFromLog2(log2Zoom));
+
+		if (log2Zoom > DOUBLE_LOG2_LIMIT)
+		{
+			view.zoom	= std::exp2(log2Zoom);
+			view.offset	= { deep.offset.x.ToDouble(), deep.offset.y.ToDouble() };
+
+			if (Render::FitPrecision(view) <= Render::Precision::DOUBLE)
+				return engine.RenderFrame(view, iterations, colors);
+		}
+
+		return engine.RenderDeepFrame(deep, iterations, colors);
+	}
+}
+
+Render::DeepZoom Render::AnimationZoom(AnimationSettings const & settings, uint32 frame)
+{
+	double const start	= settings.startZoom.Log2();
+	double const end	= settings.endZoom.Log2();
+
+	if (settings.frames < 2u)
+		return settings.startZoom;
+
+	return ZoomFromLog2(start + (end - start) * double(frame) / double(settings.frames - 1u));
+}
+
+Render::AnimationStats Render::RenderZoomAnimation(FractalEngine & engine, AnimationSettings const & settings,
+												   CancellationToken const & token, AnimationCallback const & onFrame)
+{
+	Misc::Stopwatch stopwatch;
+	stopwatch.Start();
+
+	AnimationStats stats;
+
+	math::vec2u const	frameSize	= settings.frameSize;
+	double const		scale		= settings.keyframeScale;
+	double const		startLog	= settings.startZoom.Log2();
+	double const		endLog		= settings.endZoom.Log2();
+
+	FrameWriter writer;
+
+	if (!frameSize.x || !frameSize.y || !settings.frames || !(scale > 1.) || endLog > startLog || !writer.Open(settings.output, frameSize))
+	{
+		stats.failed = true;
+		return stats;
+	}
+
+	math::vec2u const	keySize		= { uint32(std::ceil(frameSize.x * scale)), uint32(std::ceil(frameSize.y * scale)) };
+	double const		step		= std::log2(scale);
+	uint32 const		segments	= std::max(1u, uint32(std::ceil((startLog - endLog) / step - 1e-9)));
+
+	Keyframe			outer;
+	Keyframe			inner;
+	IterationBuffer		iterations;
+	ColorBuffer			frame;
+	Taps				outerColumns, outerRows, innerColumns, innerRows;
+
+	frame.Resize(frameSize.x, frameSize.y);
+
+	auto RenderInto = [&](Keyframe & keyframe, uint32 index)
+	{
+		Misc::Stopwatch renderTime;
+		renderTime.Start();
+
+		RenderKeyframe(engine, settings, startLog - double(index) * step, keySize, iterations, keyframe.colors);
+
+		renderTime.Stop();
+
+		keyframe.index			 = index;
+		stats.render			+= renderTime.GetTime();
+		stats.keyframePixels	+= uint64(keySize.x) * keySize.y;
+
+		++stats.keyframes;
+	};
+
+	for (uint32 index = 0u; index < settings.frames; ++index)
+	{
+		if (token.IsCancelled())
+		{
+			stats.cancelled = true;
+			break;
+		}
+
+		double const	zoomLog		= AnimationZoom(settings, index).Log2();
+		double const	position	= (startLog - zoomLog) / step;
+		uint32 const	segment		= std::min(uint32(std::max(position, 0.)), segments - 1u);
+		double const	fade		= std::min(std::max(position - double(segment), 0.), 1.);
+
+		// the animation only zooms in, the inner keyframe becomes the next outer one
+		if (outer.index != segment)
+		{
+			if (inner.index == segment)
+				std::swap(outer, inner);
+			else
+				RenderInto(outer, segment);
+
+			RenderInto(inner, segment + 1u);
+		}
+
+		Misc::Stopwatch resampleTime;
+		resampleTime.Start();
+
+		// keyframe pixels per frame pixel, from 1 up to the scale for the outer keyframe
+		double const outerScale		= std::exp2(zoomLog - (startLog - double(segment) * step)) * double(keySize.y) / double(frameSize.y);
+		double const innerScale		= outerScale * scale;
+		double const featherPixels	= std::max(FEATHER_PIXELS * (1. - fade), 1e-3);
+
+		BuildTaps(frameSize.x, keySize.x, outerScale, featherPixels, outerColumns);
+		BuildTaps(frameSize.y, keySize.y, outerScale, featherPixels, outerRows);
+		BuildTaps(frameSize.x, keySize.x, innerScale, featherPixels, innerColumns);
+		BuildTaps(frameSize.y, keySize.y, innerScale, featherPixels, innerRows);
+
+		// rows are independent, one task per core takes every n-th
+		uint32 const taskCount = std::max(1u, std::min(frameSize.y, std::thread::hardware_concurrency()));
+
+		std::vector<std::future<void>> tasks;
+
+		for (uint32 task = 0u; task < taskCount; ++task)
+		{
+			tasks.push_back(std::async(std::launch::async, [&, task]()
+			{
+				float outerColor[3], innerColor[3];
+
+				for (uint32 y = task; y < frameSize.y; y += taskCount)
+				{
+					for (uint32 x = 0u; x < frameSize.x; ++x)
+					{
+						Sample(outer.colors, outerColumns, outerRows, x, y, outerColor);
+
+						float const weight = float(fade) * std::min(innerColumns.feather[x], innerRows.feather[y]);
+
+						if (weight > 0.f)
+						{
+							Sample(inner.colors, innerColumns, innerRows, x, y, innerColor);
+
+							for (uint32 channel = 0u; channel < 3u; ++channel)
+								outerColor[channel] += weight * (innerColor[channel] - outerColor[channel]);
+						}
+
+						frame.pixels[frame.Index(x, y)] =
+							uint32(outerColor[0] + .5f) | uint32(outerColor[1] + .5f) << 8u | uint32(outerColor[2] + .5f) << 16u | 0xFF000000u;
+					}
+				}
+			}));
+		}
+
+		for (auto & task : tasks)
+			task.get();
+
+		resampleTime.Stop();
+		stats.resample += resampleTime.GetTime();
+
+		Misc::Stopwatch writeTime;
+		writeTime.Start();
+
+		if (!writer.Write(frame, index))
+		{
+			stats.failed = true;
+			break;
+		}
+
+		writeTime.Stop();
+
+		stats.write			+= writeTime.GetTime();
+		stats.framePixels	+= uint64(frameSize.x) * frameSize.y;
+
+		++stats.frames;
+
+		stopwatch.Stop();
+		stats.elapsed = stopwatch.GetTime();
+
+		if (onFrame)
+			onFrame(stats);
+	}
+
+	if (!writer.Close())
+		stats.failed = true;
+
+	stopwatch.Stop();
+	stats.elapsed = stopwatch.GetTime();
+
+	return stats;
+}
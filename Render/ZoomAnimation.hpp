@@ -0,0 +1,66 @@
+#pragma once
+
+#include "FractalEngine.hpp"
+
+// Zoom videos without a full render per frame. Keyframes are rendered keyframeScale
+// times larger than a frame on each side, each one zooming keyframeScale further in
+// than the last, so every frame lies between two of them: it is a centred crop of
+// the outer keyframe, with at least one keyframe sample per frame pixel, box filtered
+// down to the frame. The inner keyframe is faded in over its area as the frame
+// approaches it, so switching to the next pair of keyframes never shows a jump.
+//
+// Only the two keyframes in use and one frame are in memory at a time, frames go to
+// the disk as they are made: numbered PPM or PNG images, or one raw I420 stream
+// (ffmpeg -f rawvideo -pix_fmt yuv420p -s WxH) for a path ending in .yuv.
+
+namespace Render
+{
+	struct AnimationSettings
+	{
+		FractalView				view;					// fractal, iterations and colours, its offset and zoom are unused
+		math::vec2<DeepReal>	center;
+		DeepZoom				startZoom;
+		DeepZoom				endZoom;				// deeper than startZoom, the animation zooms in
+		math::vec2u				frameSize		{1920u, 1080u};
+		uint32					frames			{600u};
+		double					keyframeScale	{2.};	// above 1, larger costs more per keyframe but needs fewer
+		std::string				output;					// "zoom%05u.png", "zoom%05u.ppm" or "zoom.yuv"
+	};
+
+	struct AnimationStats
+	{
+		uint32					frames			{0u};	// written
+		uint32					keyframes		{0u};	// rendered
+		uint64					keyframePixels	{0u};
+		uint64					framePixels		{0u};	// what rendering every frame would have cost
+		Misc::clock::duration	render			{0};	// keyframes
+		Misc::clock::duration	resample		{0};
+		Misc::clock::duration	write			{0};
+		bool					cancelled		{false};
+		bool					failed			{false};
+		Misc::clock::duration	elapsed			{0};
+
+		double inline Seconds() const {
+			return std::chrono::duration<double>(elapsed).count();
+		}
+
+		// fewer full renders than one per frame
+		double inline RenderReduction() const {
+			return keyframes ? double(frames) / double(keyframes) : 0.;
+		}
+
+		double inline FramesPerSecond() const {
+			return Seconds() > 0. ? double(frames) / Seconds() : 0.;
+		}
+	};
+
+	typedef std::function<void(AnimationStats const & progress)> AnimationCallback;
+
+	// the zoom of frame `frame`, exponentially spaced between the start and the end
+	DeepZoom AnimationZoom(AnimationSettings const & settings, uint32 frame);
+
+	// Keyframes past what doubles resolve go through RenderDeepFrame. onFrame runs after
+	// every frame written; the token is checked between frames.
+	AnimationStats RenderZoomAnimation(FractalEngine & engine, AnimationSettings const & settings,
+									   CancellationToken const & token = CancellationToken(), AnimationCallback const & onFrame = AnimationCallback());
+}
@@ -0,0 +1,61 @@
+#version 400 core
+
+// Colouring pass over the escape samples written by MandelbrotFragment.glsl,
+// changing the palette or u_colorModifier only reruns this.
+
+uniform sampler2D		u_escape;
+
+// view parameters, one std140 block written at once, Render::ViewUniforms on the CPU side;
+// keep the members in the same order in MandelbrotFragment.glsl and ColoringFragment.glsl
+layout(std140) uniform ViewBlock
+{
+	vec2			u_offset;
+	vec2			u_juliaConstant;
+	vec3			u_colorModifier;
+	float			u_zoom;
+	uvec2			u_canvas;
+	unsigned int	u_maxIter;
+	bool			u_fractalType;
+};
+
+out vec4 PixelColor;
+
+vec3 HSBtoRGB(vec3 hsb)
+{
+	
+
+	return vec3(0.f);
+
+}
+
+vec3 Coloring(float iteration)
+{
+	return vec3(0.f, iteration * 1.f / u_maxIter * 1.2, iteration * 1.6f/u_maxIter * 2.1);
+}
+
+vec3 LinearizeColor(unsigned int iteration, float iter2)
+{
+	vec3 color1 = Coloring(iteration - 1u);
+	vec3 color2 = Coloring(iter2);
+
+	vec3 newColor = mix(color1, color2, iter2 - int(iter2));
+	 
+	return newColor;
+}
+
+void main(void)
+{
+	const vec4 k_setColor = vec4(0.f, 0.f, 0.f, 1.f);
+
+	// the escape target has the size of the screen
+	vec2 escape = texelFetch(u_escape, ivec2(gl_FragCoord.xy), 0).xy;
+
+	unsigned int iteration = uint(escape.x);
+
+	// keep in sync with Render::ShadeSample, bounded points use the set colour
+	vec3 linearized = iteration == 0u || iteration >= u_maxIter ?
+		k_setColor.xyz : LinearizeColor(iteration, escape.y);
+
+	PixelColor.xyz	= linearized * u_colorModifier;
+	PixelColor.a	= 1.f;
+}
@@ -9,15 +9,21 @@ in VS_OUT
 
 } fsInput;
 
-uniform bool			u_fractalType;
-uniform unsigned int	u_maxIter;
-uniform float			u_zoom;
-uniform vec2			u_offset;
-uniform uvec2			u_canvas;
-uniform vec3			u_colorModifier;
-uniform vec2			u_juliaConstant;
-
-out vec4 PixelColor;
+// view parameters, one std140 block written at once, Render::ViewUniforms on the CPU side;
+// keep the members in the same order in MandelbrotFragment.glsl and ColoringFragment.glsl
+layout(std140) uniform ViewBlock
+{
+	vec2			u_offset;
+	vec2			u_juliaConstant;
+	vec3			u_colorModifier;
+	float			u_zoom;
+	uvec2			u_canvas;
+	unsigned int	u_maxIter;
+	bool			u_fractalType;
+};
+
+// iteration count and smooth iteration, the colouring pass only needs these
+out vec2 Escape;
 
 float sq(float x)
 {
@@ -42,38 +48,27 @@ float NextComplexAbsolute(vec2 z)
 	return sq(z.x) + sq(z.y);
 }
 
-vec3 HSBtoRGB(vec3 hsb)
+// main cardioid and period-2 bulb, both inside the set
+bool IsInMainComponents(vec2 c)
 {
-	
-
-	return vec3(0.f);
-
-}
+	float x		= c.x - 0.25f;
+	float y2	= sq(c.y);
+	float q		= sq(x) + y2;
 
-vec3 Coloring(float iteration)
-{
-	return vec3(0.f, iteration * 1.f / u_maxIter * 1.2, iteration * 1.6f/u_maxIter * 2.1);
+	return q * (q + x) <= 0.25f * y2 || sq(c.x + 1.f) + y2 <= 0.0625f;
 }
 
-vec3 LinearizeColor(vec2 complex, 
-					unsigned int iteration)
+// fractional escape count, coloured later on by ColoringFragment.glsl
+float SmoothIteration(vec2 complex, unsigned int iteration)
 {
 	float logZn  = log(NextComplexAbsolute(complex)) / 2.;
 	float offset = log(logZn/log(2.)) / log(2.);
 
-	float iter2 = float(iteration) + 1. - offset;
-
-	vec3 color1 = Coloring(iteration);
-	vec3 color2 = Coloring(iter2);
-
-	vec3 newColor = mix(color1, color2, iter2 - int(iter2));
-	 
-	return newColor;
+	return float(iteration) + 1. - offset;
 }
 
 void main(void)
 {
-	const vec4	k_setColor			= vec4(0.f, 0.f, 0.f, 1.f);
 	const float k_limitThreshold	= 6.f;
 	const float k_colorThreshold	= 2.f;
 	const vec2	k_julia				= vec2(0.285f, 0.01f);
@@ -89,8 +84,14 @@ void main(void)
 
 	unsigned int iteration = 0u;
 
-	float smoothColor;
-	vec3  linearized;
+	float smoothIteration = 0.f;
+
+	// orbit value saved at the last power of two iterations (Brent)
+	vec2		 cycle		= z;
+	unsigned int checkpoint	= 1u;
+
+	if(u_fractalType == MANDELBROT && IsInMainComponents(point))
+		iteration = u_maxIter;
 
 	for(; iteration < u_maxIter; ++iteration)
 	{
@@ -103,8 +104,7 @@ void main(void)
 		
 			if(NextComplexAbsolute(z) > k_colorThreshold)
 			{
-				//smoothColor += (iteration + 1 - log(log(ComplexAbsolute(z))) / log(2.f));
-				linearized  = LinearizeColor(z, iteration);
+				smoothIteration = SmoothIteration(z, iteration);
 			}
 		}
 		else if(u_fractalType == JULIA)
@@ -113,13 +113,24 @@ void main(void)
 
 			if(NextComplexAbsolute(z) > k_colorThreshold)
 			{
-				//smoothColor += exp(-ComplexAbsolute(z));
-				linearized  = LinearizeColor(z, iteration);
+				smoothIteration = SmoothIteration(z, iteration);
 			}
 		}
 
+		// an exact repeat is periodic and can never escape
+		if(z == cycle)
+		{
+			iteration = u_maxIter;
+			break;
+		}
+
+		if(iteration + 1u == checkpoint)
+		{
+			cycle		 = z;
+			checkpoint <<= 1u;
+		}
 	}
 
-	PixelColor.xyz	= linearized;
-	PixelColor.a	= 1.f;
+	// same as Render::EscapeSample
+	Escape = vec2(float(iteration), iteration < u_maxIter ? smoothIteration : 0.f);
 }
\ No newline at end of file
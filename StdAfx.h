@@ -11,8 +11,10 @@
 
 /************<C headers>*************/
 #include <cstdio>
+#include <cstdint>
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <cwchar>
 #include <ciso646>
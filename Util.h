@@ -5,15 +5,31 @@
 typedef unsigned char		byte;
 typedef	char				sbyte;
 
-typedef __int8				int8;
-typedef __int16				int16;
-typedef __int32				int32;
-typedef __int64				int64;
-
-typedef unsigned __int8		uint8;
-typedef unsigned __int16	uint16;
-typedef unsigned __int32	uint32;
-typedef unsigned __int64	uint64;
+#ifdef _MSC_VER
+	typedef __int8				int8;
+	typedef __int16				int16;
+	typedef __int32				int32;
+	typedef __int64				int64;
+
+	typedef unsigned __int8		uint8;
+	typedef unsigned __int16	uint16;
+	typedef unsigned __int32	uint32;
+	typedef unsigned __int64	uint64;
+#else
+	typedef std::int8_t			int8;
+	typedef std::int16_t		int16;
+	typedef std::int32_t		int32;
+	typedef std::int64_t		int64;
+
+	typedef std::uint8_t		uint8;
+	typedef std::uint16_t		uint16;
+	typedef std::uint32_t		uint32;
+	typedef std::uint64_t		uint64;
+#endif
+
+#ifndef FORCEINLINE
+	#define FORCEINLINE inline __attribute__((always_inline))
+#endif
 
 typedef const char*			cstring;
 
@@ -71,6 +87,7 @@ namespace Misc
 
 	struct Unique : virtual public Noncopyable, Immovable {};
 
+#ifdef _WIN32
 	template<typename ...args>
 	UINT inline ShowMessageBox(HWND hwnd, UINT type, const char* title, const char * fmt, args... vargs)
 	{
@@ -89,5 +106,6 @@ namespace Misc
 		bIsConsoleVisible ? FreeConsole() : AllocConsole();
 		bIsConsoleVisible = !bIsConsoleVisible;
 	}
+#endif
 
 }
\ No newline at end of file
@@ -0,0 +1,1020 @@
+#include "Deflate.h"
+
+namespace
+{
+	constexpr uint32 MIN_MATCH		= 3u;
+	constexpr uint32 MAX_MATCH		= 258u;
+	constexpr uint32 MAX_DISTANCE	= 32768u;
+
+	// the search gives up after MAX_CHAIN candidates or once a match reaches NICE_MATCH,
+	// and a match of LAZY_MATCH or more is taken without checking the next position
+	constexpr uint32 HASH_BITS		= 15u;
+	constexpr uint32 MAX_CHAIN		= 48u;
+	constexpr uint32 NICE_MATCH		= 128u;
+	constexpr uint32 LAZY_MATCH		= 32u;
+
+	constexpr uint32 NIL			= ~0u;
+	constexpr size_t BLOCK_SYMBOLS	= 1u << 15u;	// symbols per block, each block gets its own codes
+
+	constexpr uint32 END_OF_BLOCK		= 256u;
+	constexpr uint32 LITERAL_CODES		= 286u;
+	constexpr uint32 DISTANCE_CODES		= 30u;
+	constexpr uint32 CODE_LENGTH_CODES	= 19u;
+	constexpr uint32 MAX_CODE_BITS		= 15u;
+	constexpr uint32 MAX_LENGTH_BITS	= 7u;	// of the code length alphabet
+
+	constexpr uint16 LENGTH_BASE[29]	= { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+											35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+	constexpr byte	 LENGTH_EXTRA[29]	= { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+											3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+
+	constexpr uint16 DISTANCE_BASE[30]	= { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385,
+											513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+	constexpr byte	 DISTANCE_EXTRA[30]	= { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7,
+											8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+	constexpr byte CODE_LENGTH_ORDER[CODE_LENGTH_CODES]	= { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+	constexpr byte CODE_LENGTH_EXTRA[3]					= { 2, 3, 7 };	// of the repeat codes 16, 17 and 18
+
+	// code of every match length and distance, so the block writer never searches the bases
+	struct CodeTables
+	{
+		byte length[MAX_MATCH + 1u];
+		byte distance[512];	// the first 256 distances, then one entry per 128
+
+		uint32 crc[256];
+
+		CodeTables()
+		{
+			for (uint32 code = 0u; code < 29u; ++code)
+			{
+				for (uint32 value = LENGTH_BASE[code]; value < LENGTH_BASE[code] + (1u << LENGTH_EXTRA[code]) && value <= MAX_MATCH; ++value)
+					length[value] = byte(code);
+			}
+
+			// 258 has a code of its own although 284 could express it
+			length[MAX_MATCH] = 28u;
+
+			for (uint32 code = 0u; code < DISTANCE_CODES; ++code)
+			{
+				for (uint32 value = DISTANCE_BASE[code]; value < DISTANCE_BASE[code] + (1u << DISTANCE_EXTRA[code]); ++value)
+				{
+					if (value - 1u < 256u)
+						distance[value - 1u] = byte(code);
+					else
+						distance[256u + ((value - 1u) >> 7u)] = byte(code);
+				}
+			}
+
+			for (uint32 i = 0u; i < 256u; ++i)
+			{
+				uint32 value = i;
+
+				for (uint32 bit = 0u; bit < 8u; ++bit)
+					value = value & 1u ? 0xEDB88320u ^ (value >> 1u) : value >> 1u;
+
+				crc[i] = value;
+			}
+		}
+
+		uint32 inline DistanceCode(uint32 value) const {
+			return value - 1u < 256u ? distance[value - 1u] : distance[256u + ((value - 1u) >> 7u)];
+		}
+	};
+
+	CodeTables const & GetTables()
+	{
+		static CodeTables const tables;
+		return tables;
+	}
+
+	// a literal when distance is 0, otherwise a match of `value` bytes
+	struct Symbol
+	{
+		uint16 value;
+		uint16 distance;
+	};
+
+	// deflate fills bytes from the least significant bit up
+	class BitWriter
+	{
+		std::vector<byte> &	m_out;
+		uint64				m_bits	{0u};
+		uint32				m_count	{0u};
+
+		public:
+
+			explicit BitWriter(std::vector<byte> & out):
+				m_out(out)
+			{}
+
+			void inline Write(uint32 value, uint32 bits)
+			{
+				m_bits	|= uint64(value) << m_count;
+				m_count	+= bits;
+
+				for (; m_count >= 8u; m_count -= 8u, m_bits >>= 8u)
+					m_out.push_back(byte(m_bits));
+			}
+
+			void inline Align()
+			{
+				if (m_count)
+					m_out.push_back(byte(m_bits));
+
+				m_bits	= 0u;
+				m_count	= 0u;
+			}
+
+			// only once aligned
+			void inline Append(byte const * data, size_t size) {
+				m_out.insert(m_out.end(), data, data + size);
+			}
+	};
+
+	// Huffman code lengths of the symbols with a non zero frequency, none past maxBits.
+	// There are always two codes at least, decoders refuse a code that is not complete.
+	void BuildLengths(uint32 const * frequencies, uint32 count, uint32 maxBits, byte * lengths)
+	{
+		std::fill(lengths, lengths + count, byte(0u));
+
+		std::vector<uint32> order;
+
+		for (uint32 symbol = 0u; symbol < count; ++symbol)
+		{
+			if (frequencies[symbol])
+				order.push_back(symbol);
+		}
+
+		if (order.size() < 2u)
+		{
+			uint32 const used = order.empty() ? 1u : order[0];
+
+			lengths[used]			= 1u;
+			lengths[used ? 0u : 1u]	= 1u;
+
+			return;
+		}
+
+		// least frequent first, the symbol breaks ties so the code does not depend on the sort
+		std::sort(order.begin(), order.end(), [frequencies](uint32 a, uint32 b)
+		{
+			return frequencies[a] != frequencies[b] ? frequencies[a] < frequencies[b] : a < b;
+		});
+
+		// two queue construction: leaves [0, leaves) in order, internal nodes are made in order as well
+		size_t const leaves = order.size();
+		size_t const nodes	= 2u * leaves - 1u;
+
+		std::vector<uint64> weight(nodes);
+		std::vector<uint32> parent(nodes);
+
+		for (size_t i = 0u; i < leaves; ++i)
+			weight[i] = frequencies[order[i]];
+
+		size_t nextLeaf		= 0u;
+		size_t nextInternal	= leaves;
+
+		auto TakeLightest = [&](size_t made) -> size_t
+		{
+			if (nextLeaf < leaves && (nextInternal >= made || weight[nextLeaf] <= weight[nextInternal]))
+				return nextLeaf++;
+
+			return nextInternal++;
+		};
+
+		for (size_t made = leaves; made < nodes; ++made)
+		{
+			size_t const a = TakeLightest(made);
+			size_t const b = TakeLightest(made);
+
+			weight[made]	= weight[a] + weight[b];
+			parent[a]		= uint32(made);
+			parent[b]		= uint32(made);
+		}
+
+		// parents come after their children, the root is the last node
+		std::vector<uint32> depth(nodes, 0u);
+		std::vector<uint32> counts(leaves + 1u, 0u);
+
+		for (size_t i = nodes - 1u; i-- > 0u;)
+			depth[i] = depth[parent[i]] + 1u;
+
+		for (size_t i = 0u; i < leaves; ++i)
+			++counts[std::min<uint32>(depth[i], maxBits)];
+
+		// the clamped lengths oversubscribe the code, every round splits one shorter
+		// code into two one bit longer and removes one at maxBits, one unit at a time
+		uint64 total = 0u;
+
+		for (uint32 bits = 1u; bits <= maxBits && bits <= leaves; ++bits)
+			total += uint64(counts[bits]) << (maxBits - bits);
+
+		for (; total > (1ull << maxBits); --total)
+		{
+			--counts[maxBits];
+
+			for (uint32 bits = maxBits - 1u; bits > 0u; --bits)
+			{
+				if (counts[bits])
+				{
+					--counts[bits];
+					counts[bits + 1u] += 2u;
+					break;
+				}
+			}
+		}
+
+		// the most frequent symbols get the shortest codes
+		size_t next = leaves;
+
+		for (uint32 bits = 1u; bits <= maxBits && bits <= leaves; ++bits)
+		{
+			for (uint32 i = 0u; i < counts[bits]; ++i)
+				lengths[order[--next]] = byte(bits);
+		}
+	}
+
+	// canonical codes, bit reversed since deflate sends Huffman codes most significant bit first
+	void BuildCodes(byte const * lengths, uint32 count, uint16 * codes)
+	{
+		uint32 lengthCounts[MAX_CODE_BITS + 1u] = {};
+		uint32 nextCode[MAX_CODE_BITS + 1u]		= {};
+
+		for (uint32 symbol = 0u; symbol < count; ++symbol)
+			++lengthCounts[lengths[symbol]];
+
+		lengthCounts[0] = 0u;
+
+		for (uint32 bits = 1u, code = 0u; bits <= MAX_CODE_BITS; ++bits)
+		{
+			code			= (code + lengthCounts[bits - 1u]) << 1u;
+			nextCode[bits]	= code;
+		}
+
+		for (uint32 symbol = 0u; symbol < count; ++symbol)
+		{
+			uint32 const length = lengths[symbol];
+			uint32 const code	= length ? nextCode[length]++ : 0u;
+
+			uint32 reversed = 0u;
+
+			for (uint32 bit = 0u; bit < length; ++bit)
+				reversed = (reversed << 1u) | ((code >> bit) & 1u);
+
+			codes[symbol] = uint16(reversed);
+		}
+	}
+
+	void WriteStored(byte const * raw, size_t size, bool final, BitWriter & writer)
+	{
+		do
+		{
+			uint32 const part = uint32(std::min<size_t>(size, 0xFFFFu));
+
+			writer.Write(final && part == size, 1u);
+			writer.Write(0u, 2u);
+			writer.Align();
+
+			byte const header[4] = { byte(part), byte(part >> 8u), byte(~part), byte(~part >> 8u) };
+
+			writer.Append(header, 4u);
+			writer.Append(raw, part);
+
+			raw	 += part;
+			size -= part;
+		}
+		while (size);
+	}
+
+	// one block with codes of its own, stored instead when that comes out smaller
+	void WriteBlock(std::vector<Symbol> const & symbols, byte const * raw, size_t rawSize, bool final, BitWriter & writer)
+	{
+		CodeTables const & tables = GetTables();
+
+		uint32 literalFrequencies[LITERAL_CODES]	= {};
+		uint32 distanceFrequencies[DISTANCE_CODES]	= {};
+
+		for (auto const & symbol : symbols)
+		{
+			if (symbol.distance)
+			{
+				++literalFrequencies[257u + tables.length[symbol.value]];
+				++distanceFrequencies[tables.DistanceCode(symbol.distance)];
+			}
+			else
+			{
+				++literalFrequencies[symbol.value];
+			}
+		}
+
+		++literalFrequencies[END_OF_BLOCK];
+
+		byte lengths[LITERAL_CODES + DISTANCE_CODES];
+
+		byte * const literalLengths		= lengths;
+		byte * const distanceLengths	= lengths + LITERAL_CODES;
+
+		BuildLengths(literalFrequencies,	LITERAL_CODES,	MAX_CODE_BITS, literalLengths);
+		BuildLengths(distanceFrequencies,	DISTANCE_CODES,	MAX_CODE_BITS, distanceLengths);
+
+		uint32 literalCount		= LITERAL_CODES;
+		uint32 distanceCount	= DISTANCE_CODES;
+
+		for (; literalCount > 257u && !literalLengths[literalCount - 1u]; --literalCount);
+		for (; distanceCount > 1u && !distanceLengths[distanceCount - 1u]; --distanceCount);
+
+		// both length lists run length encoded as one sequence, extra bits in the high byte
+		byte sequence[LITERAL_CODES + DISTANCE_CODES];
+
+		std::copy(literalLengths, literalLengths + literalCount, sequence);
+		std::copy(distanceLengths, distanceLengths + distanceCount, sequence + literalCount);
+
+		std::vector<uint16>	runs;
+		uint32				codeLengthFrequencies[CODE_LENGTH_CODES] = {};
+
+		auto PushRun = [&](uint32 code, uint32 extra)
+		{
+			runs.push_back(uint16(code | (extra << 8u)));
+			++codeLengthFrequencies[code];
+		};
+
+		for (uint32 i = 0u, total = literalCount + distanceCount; i < total;)
+		{
+			byte const	length	= sequence[i];
+			uint32		run		= 1u;
+
+			for (; i + run < total && sequence[i + run] == length; ++run);
+
+			if (length == 0u && run >= 3u)
+			{
+				uint32 zeros = run;
+
+				for (; zeros >= 3u; )
+				{
+					uint32 const part = std::min(zeros, 138u);
+
+					if (part >= 11u)
+						PushRun(18u, part - 11u);
+					else
+						PushRun(17u, part - 3u);
+
+					zeros -= part;
+				}
+
+				i += run - zeros;
+			}
+			else if (length != 0u && run >= 4u)
+			{
+				PushRun(length, 0u);
+
+				uint32 repeats = run - 1u;
+
+				for (; repeats >= 3u; )
+				{
+					uint32 const part = std::min(repeats, 6u);
+
+					PushRun(16u, part - 3u);
+					repeats -= part;
+				}
+
+				i += run - repeats;
+			}
+			else
+			{
+				PushRun(length, 0u);
+				++i;
+			}
+		}
+
+		byte codeLengthLengths[CODE_LENGTH_CODES];
+		BuildLengths(codeLengthFrequencies, CODE_LENGTH_CODES, MAX_LENGTH_BITS, codeLengthLengths);
+
+		uint32 codeLengthCount = CODE_LENGTH_CODES;
+
+		for (; codeLengthCount > 4u && !codeLengthLengths[CODE_LENGTH_ORDER[codeLengthCount - 1u]]; --codeLengthCount);
+
+		// compare with a stored block before writing anything
+		uint64 bits = 3u + 5u + 5u + 4u + 3u * codeLengthCount;
+
+		for (uint16 run : runs)
+		{
+			uint32 const code = run & 0xFFu;
+			bits += codeLengthLengths[code] + (code >= 16u ? CODE_LENGTH_EXTRA[code - 16u] : 0u);
+		}
+
+		for (uint32 code = 0u; code < LITERAL_CODES; ++code)
+			bits += uint64(literalFrequencies[code]) * (literalLengths[code] + (code > 256u ? LENGTH_EXTRA[code - 257u] : 0u));
+
+		for (uint32 code = 0u; code < DISTANCE_CODES; ++code)
+			bits += uint64(distanceFrequencies[code]) * (distanceLengths[code] + DISTANCE_EXTRA[code]);
+
+		uint64 const storedBits = (uint64(rawSize) + 5u * (rawSize / 0xFFFFu + 1u)) * 8u;
+
+		if (storedBits <= bits)
+		{
+			WriteStored(raw, rawSize, final, writer);
+			return;
+		}
+
+		uint16 literalCodes[LITERAL_CODES];
+		uint16 distanceCodes[DISTANCE_CODES];
+		uint16 codeLengthCodes[CODE_LENGTH_CODES];
+
+		BuildCodes(literalLengths,		LITERAL_CODES,		literalCodes);
+		BuildCodes(distanceLengths,		DISTANCE_CODES,		distanceCodes);
+		BuildCodes(codeLengthLengths,	CODE_LENGTH_CODES,	codeLengthCodes);
+
+		writer.Write(final, 1u);
+		writer.Write(2u, 2u);
+		writer.Write(literalCount - 257u, 5u);
+		writer.Write(distanceCount - 1u, 5u);
+		writer.Write(codeLengthCount - 4u, 4u);
+
+		for (uint32 i = 0u; i < codeLengthCount; ++i)
+			writer.Write(codeLengthLengths[CODE_LENGTH_ORDER[i]], 3u);
+
+		for (uint16 run : runs)
+		{
+			uint32 const code = run & 0xFFu;
+
+			writer.Write(codeLengthCodes[code], codeLengthLengths[code]);
+
+			if (code >= 16u)
+				writer.Write(run >> 8u, CODE_LENGTH_EXTRA[code - 16u]);
+		}
+
+		for (auto const & symbol : symbols)
+		{
+			if (!symbol.distance)
+			{
+				writer.Write(literalCodes[symbol.value], literalLengths[symbol.value]);
+				continue;
+			}
+
+			uint32 const lengthCode		= tables.length[symbol.value];
+			uint32 const distanceCode	= tables.DistanceCode(symbol.distance);
+
+			writer.Write(literalCodes[257u + lengthCode], literalLengths[257u + lengthCode]);
+			writer.Write(symbol.value - LENGTH_BASE[lengthCode], LENGTH_EXTRA[lengthCode]);
+
+			writer.Write(distanceCodes[distanceCode], distanceLengths[distanceCode]);
+			writer.Write(symbol.distance - DISTANCE_BASE[distanceCode], DISTANCE_EXTRA[distanceCode]);
+		}
+
+		writer.Write(literalCodes[END_OF_BLOCK], literalLengths[END_OF_BLOCK]);
+	}
+
+	// hash chains over the last MAX_DISTANCE positions
+	class MatchFinder
+	{
+		byte const *		m_data;
+		size_t				m_size;
+
+		std::vector<uint32>	m_head;
+		std::vector<uint32>	m_previous;
+
+		uint32 inline Hash(size_t position) const
+		{
+			uint32 const bytes = uint32(m_data[position]) | uint32(m_data[position + 1u]) << 8u | uint32(m_data[position + 2u]) << 16u;
+			return (bytes * 2654435761u) >> (32u - HASH_BITS);
+		}
+
+		public:
+
+			struct Match
+			{
+				uint32 length;
+				uint32 distance;
+			};
+
+			MatchFinder(byte const * data, size_t size):
+				m_data(data),
+				m_size(size),
+				m_head(1u << HASH_BITS, NIL),
+				m_previous(MAX_DISTANCE, NIL)
+			{}
+
+			void inline Insert(size_t position)
+			{
+				if (position + MIN_MATCH > m_size)
+					return;
+
+				uint32 & head = m_head[Hash(position)];
+
+				m_previous[position % MAX_DISTANCE] = head;
+				head = uint32(position);
+			}
+
+			// longest earlier match of the data at position, the position itself is not inserted yet
+			Match Find(size_t position) const
+			{
+				Match best { 0u, 0u };
+
+				size_t const available = std::min<size_t>(MAX_MATCH, m_size - position);
+
+				if (available < MIN_MATCH)
+					return best;
+
+				byte const * const	current		= m_data + position;
+				uint32				candidate	= m_head[Hash(position)];
+
+				for (uint32 chain = 0u; chain < MAX_CHAIN && candidate != NIL && position - candidate <= MAX_DISTANCE; ++chain)
+				{
+					byte const * const earlier = m_data + candidate;
+
+					// a longer match has to differ from the best one at its last byte
+					if (earlier[best.length] == current[best.length] || !best.length)
+					{
+						uint32 length = 0u;
+
+						for (uint64 a, b; length + 8u <= available; length += 8u)
+						{
+							std::memcpy(&a, earlier + length, 8u);
+							std::memcpy(&b, current + length, 8u);
+
+							if (a != b)
+								break;
+						}
+
+						for (; length < available && earlier[length] == current[length]; ++length);
+
+						if (length > best.length)
+						{
+							best = { length, uint32(position - candidate) };
+
+							if (length >= NICE_MATCH || length == available)
+								break;
+						}
+					}
+
+					uint32 const next = m_previous[candidate % MAX_DISTANCE];
+
+					// a slot overwritten by a later position ends the chain
+					if (next == NIL || next >= candidate)
+						break;
+
+					candidate = next;
+				}
+
+				if (best.length < MIN_MATCH)
+					best = { 0u, 0u };
+
+				return best;
+			}
+	};
+
+	// deflate reads bytes from the least significant bit up, past the end it reads zeros
+	class BitReader
+	{
+		byte const *	m_data;
+		size_t			m_size;
+		size_t			m_position	{0u};
+		uint64			m_bits		{0u};
+		uint32			m_count		{0u};
+		uint32			m_padding	{0u};	// zero bits made up past the end, the top of m_bits
+
+		public:
+
+			BitReader(byte const * data, size_t size):
+				m_data(data),
+				m_size(size)
+			{}
+
+			void inline Refill()
+			{
+				for (; m_count <= 56u; m_count += 8u)
+				{
+					if (m_position < m_size)
+						m_bits |= uint64(m_data[m_position++]) << m_count;
+					else
+						m_padding += 8u;
+				}
+			}
+
+			// at most 32 bits
+			uint32 inline Peek(uint32 bits)
+			{
+				if (m_count < bits)
+					Refill();
+
+				return uint32(m_bits & ((1ull << bits) - 1u));
+			}
+
+			void inline Drop(uint32 bits)
+			{
+				m_bits	>>= bits;
+				m_count	-= bits;
+			}
+
+			uint32 inline Take(uint32 bits)
+			{
+				uint32 const value = Peek(bits);
+				Drop(bits);
+
+				return value;
+			}
+
+			void inline Align() {
+				Drop(m_count % 8u);
+			}
+
+			bool inline Overrun() const {
+				return m_padding > m_count;
+			}
+	};
+
+	// canonical Huffman decoding, a table for the short codes and a bit by bit walk for the rest
+	class HuffmanDecoder
+	{
+		static constexpr uint32 FAST_BITS = 10u;
+
+		uint16 m_fast[1u << FAST_BITS];		// symbol << 4 | length, 0 for codes longer than FAST_BITS
+		uint16 m_counts[MAX_CODE_BITS + 1u];
+		uint16 m_symbols[LITERAL_CODES + 2u];
+
+		public:
+
+			// false for an oversubscribed code, an incomplete one is fine until a missing code shows up
+			bool Build(byte const * lengths, uint32 count)
+			{
+				std::fill(m_fast, m_fast + (1u << FAST_BITS), uint16(0u));
+				std::fill(m_counts, m_counts + MAX_CODE_BITS + 1u, uint16(0u));
+
+				for (uint32 symbol = 0u; symbol < count; ++symbol)
+					++m_counts[lengths[symbol]];
+
+				m_counts[0] = 0u;
+
+				uint16	offsets[MAX_CODE_BITS + 2u]		= {};
+				uint32	nextCode[MAX_CODE_BITS + 1u]	= {};
+				int32	left							= 1;
+
+				for (uint32 bits = 1u, code = 0u; bits <= MAX_CODE_BITS; ++bits)
+				{
+					left = left * 2 - m_counts[bits];
+
+					if (left < 0)
+						return false;
+
+					offsets[bits + 1u]	= uint16(offsets[bits] + m_counts[bits]);
+					code				= (code + m_counts[bits - 1u]) << 1u;
+					nextCode[bits]		= code;
+				}
+
+				for (uint32 symbol = 0u; symbol < count; ++symbol)
+				{
+					uint32 const length = lengths[symbol];
+
+					if (!length)
+						continue;
+
+					m_symbols[offsets[length]++] = uint16(symbol);
+
+					uint32 const code = nextCode[length]++;
+
+					if (length > FAST_BITS)
+						continue;
+
+					uint32 reversed = 0u;
+
+					for (uint32 bit = 0u; bit < length; ++bit)
+						reversed = (reversed << 1u) | ((code >> bit) & 1u);
+
+					for (uint32 entry = reversed; entry < (1u << FAST_BITS); entry += 1u << length)
+						m_fast[entry] = uint16(symbol << 4u | length);
+				}
+
+				return true;
+			}
+
+			// the symbol, or ~0u for bits that are no code
+			uint32 inline Decode(BitReader & reader) const
+			{
+				uint32 const bits	= reader.Peek(MAX_CODE_BITS);
+				uint32 const entry	= m_fast[bits & ((1u << FAST_BITS) - 1u)];
+
+				if (entry)
+				{
+					reader.Drop(entry & 15u);
+					return entry >> 4u;
+				}
+
+				// codes of one length are consecutive, most significant bit first
+				for (uint32 length = 1u, code = 0u, first = 0u, index = 0u; length <= MAX_CODE_BITS; ++length)
+				{
+					code |= (bits >> (length - 1u)) & 1u;
+
+					if (code - first < m_counts[length])
+					{
+						reader.Drop(length);
+						return m_symbols[index + code - first];
+					}
+
+					index	+= m_counts[length];
+					first	 = (first + m_counts[length]) << 1u;
+					code   <<= 1u;
+				}
+
+				return ~0u;
+			}
+	};
+
+	struct FixedDecoders
+	{
+		HuffmanDecoder literals;
+		HuffmanDecoder distances;
+
+		FixedDecoders()
+		{
+			byte lengths[288];
+
+			std::fill(lengths,			lengths + 144u, byte(8u));
+			std::fill(lengths + 144u,	lengths + 256u, byte(9u));
+			std::fill(lengths + 256u,	lengths + 280u, byte(7u));
+			std::fill(lengths + 280u,	lengths + 288u, byte(8u));
+
+			literals.Build(lengths, 288u);
+
+			std::fill(lengths, lengths + 30u, byte(5u));
+			distances.Build(lengths, 30u);
+		}
+	};
+
+	bool ReadDynamicCodes(BitReader & reader, HuffmanDecoder & literals, HuffmanDecoder & distances)
+	{
+		uint32 const literalCount		= reader.Take(5u) + 257u;
+		uint32 const distanceCount		= reader.Take(5u) + 1u;
+		uint32 const codeLengthCount	= reader.Take(4u) + 4u;
+
+		if (literalCount > LITERAL_CODES || distanceCount > DISTANCE_CODES)
+			return false;
+
+		byte codeLengthLengths[CODE_LENGTH_CODES] = {};
+
+		for (uint32 i = 0u; i < codeLengthCount; ++i)
+			codeLengthLengths[CODE_LENGTH_ORDER[i]] = byte(reader.Take(3u));
+
+		HuffmanDecoder codeLengths;
+
+		if (!codeLengths.Build(codeLengthLengths, CODE_LENGTH_CODES))
+			return false;
+
+		byte lengths[LITERAL_CODES + DISTANCE_CODES];
+
+		for (uint32 i = 0u, total = literalCount + distanceCount; i < total;)
+		{
+			uint32 const code = codeLengths.Decode(reader);
+
+			if (code < 16u)
+			{
+				lengths[i++] = byte(code);
+				continue;
+			}
+
+			if (code > 18u || (code == 16u && !i))
+				return false;
+
+			byte const		value	= code == 16u ? lengths[i - 1u] : byte(0u);
+			uint32 const	repeats	= reader.Take(CODE_LENGTH_EXTRA[code - 16u]) + (code == 18u ? 11u : 3u);
+
+			if (i + repeats > total)
+				return false;
+
+			std::fill(lengths + i, lengths + i + repeats, value);
+			i += repeats;
+		}
+
+		return lengths[END_OF_BLOCK] && literals.Build(lengths, literalCount) && distances.Build(lengths + literalCount, distanceCount);
+	}
+}
+
+void Misc::Deflate::Compress(byte const * data, size_t dictionary, size_t size, bool last, std::vector<byte> & out)
+{
+	BitWriter	writer(out);
+	MatchFinder	finder(data, size);
+
+	for (size_t position = dictionary > WINDOW_SIZE ? dictionary - WINDOW_SIZE : 0u; position < dictionary; ++position)
+		finder.Insert(position);
+
+	std::vector<Symbol> symbols;
+	symbols.reserve(BLOCK_SYMBOLS);
+
+	size_t blockStart	= dictionary;
+	size_t covered		= dictionary;	// end of the data the symbols so far stand for
+
+	auto Emit = [&](Symbol symbol)
+	{
+		symbols.push_back(symbol);
+		covered += symbol.distance ? symbol.value : 1u;
+
+		if (symbols.size() == BLOCK_SYMBOLS)
+		{
+			WriteBlock(symbols, data + blockStart, covered - blockStart, false, writer);
+
+			symbols.clear();
+			blockStart = covered;
+		}
+	};
+
+	// lazy matching: a match is only taken once the next position did not find a longer one
+	MatchFinder::Match pending { 0u, 0u };
+
+	for (size_t position = dictionary; position < size;)
+	{
+		MatchFinder::Match const match = pending.length < LAZY_MATCH ? finder.Find(position) : MatchFinder::Match{ 0u, 0u };
+
+		finder.Insert(position);
+
+		if (pending.length)
+		{
+			if (match.length > pending.length)
+			{
+				Emit({ data[position - 1u], 0u });
+
+				pending = match;
+				++position;
+
+				continue;
+			}
+
+			Emit({ uint16(pending.length), uint16(pending.distance) });
+
+			// position - 1 and position are in already
+			size_t const end = position - 1u + pending.length;
+
+			for (++position; position < end; ++position)
+				finder.Insert(position);
+
+			pending = { 0u, 0u };
+			continue;
+		}
+
+		if (match.length)
+			pending = match;
+		else
+			Emit({ data[position], 0u });
+
+		++position;
+	}
+
+	if (pending.length)
+		Emit({ uint16(pending.length), uint16(pending.distance) });
+
+	if (!symbols.empty() || last)
+		WriteBlock(symbols, data + blockStart, covered - blockStart, last, writer);
+
+	if (!last)
+	{
+		// sync flush, an empty stored block leaves the stream on a byte boundary
+		writer.Write(0u, 3u);
+		writer.Align();
+
+		byte const empty[4] = { 0x00, 0x00, 0xFF, 0xFF };
+		writer.Append(empty, 4u);
+	}
+
+	writer.Align();
+}
+
+bool Misc::Deflate::Decompress(byte const * data, size_t size, byte * out, size_t outSize)
+{
+	static FixedDecoders const fixed;
+
+	BitReader		reader(data, size);
+	HuffmanDecoder	dynamicLiterals;
+	HuffmanDecoder	dynamicDistances;
+
+	size_t	written	= 0u;
+	bool	final	= false;
+
+	while (!final && !reader.Overrun())
+	{
+		final = reader.Take(1u) != 0u;
+
+		uint32 const type = reader.Take(2u);
+
+		if (type == 0u)
+		{
+			reader.Align();
+
+			uint32 const length		= reader.Take(16u);
+			uint32 const inverted	= reader.Take(16u);
+
+			if ((length ^ 0xFFFFu) != inverted || written + length > outSize)
+				return false;
+
+			for (uint32 i = 0u; i < length; ++i)
+				out[written++] = byte(reader.Take(8u));
+
+			continue;
+		}
+
+		if (type == 3u || (type == 2u && !ReadDynamicCodes(reader, dynamicLiterals, dynamicDistances)))
+			return false;
+
+		HuffmanDecoder const & literals		= type == 1u ? fixed.literals : dynamicLiterals;
+		HuffmanDecoder const & distances	= type == 1u ? fixed.distances : dynamicDistances;
+
+		for (;;)
+		{
+			uint32 const symbol = literals.Decode(reader);
+
+			if (symbol < 256u)
+			{
+				if (written == outSize)
+					return false;
+
+				out[written++] = byte(symbol);
+				continue;
+			}
+
+			if (symbol == END_OF_BLOCK)
+				break;
+
+			if (symbol > 285u || reader.Overrun())
+				return false;
+
+			uint32 const length			= LENGTH_BASE[symbol - 257u] + reader.Take(LENGTH_EXTRA[symbol - 257u]);
+			uint32 const distanceCode	= distances.Decode(reader);
+
+			if (distanceCode >= DISTANCE_CODES)
+				return false;
+
+			uint32 const distance = DISTANCE_BASE[distanceCode] + reader.Take(DISTANCE_EXTRA[distanceCode]);
+
+			if (distance > written || length > outSize - written)
+				return false;
+
+			// byte by byte, the match may overlap what it copies
+			byte const * source = out + written - distance;
+
+			for (uint32 i = 0u; i < length; ++i)
+				out[written + i] = source[i];
+
+			written += length;
+		}
+	}
+
+	return final && !reader.Overrun() && written == outSize;
+}
+
+uint32 Misc::Deflate::Adler32(byte const * data, size_t size, uint32 adler)
+{
+	constexpr uint32 BASE		= 65521u;
+	constexpr size_t MAX_RUN	= 5552u;	// the largest run the sums survive without a modulo
+
+	uint32 a = adler & 0xFFFFu;
+	uint32 b = adler >> 16u;
+
+	while (size)
+	{
+		size_t const run = std::min(size, MAX_RUN);
+
+		for (size_t i = 0u; i < run; ++i)
+		{
+			a += data[i];
+			b += a;
+		}
+
+		a %= BASE;
+		b %= BASE;
+
+		data += run;
+		size -= run;
+	}
+
+	return a | (b << 16u);
+}
+
+uint32 Misc::Deflate::CombineAdler32(uint32 first, uint32 second, uint64 secondSize)
+{
+	constexpr uint32 BASE = 65521u;
+
+	uint32 const remainder = uint32(secondSize % BASE);
+
+	uint32 a = first & 0xFFFFu;
+	uint32 b = uint32((uint64(remainder) * a) % BASE);
+
+	a += (second & 0xFFFFu) + BASE - 1u;
+	b += (first >> 16u) + (second >> 16u) + BASE - remainder;
+
+	if (a >= BASE)			a -= BASE;
+	if (a >= BASE)			a -= BASE;
+	if (b >= 2u * BASE)		b -= 2u * BASE;
+	if (b >= BASE)			b -= BASE;
+
+	return a | (b << 16u);
+}
+
+uint32 Misc::Deflate::Crc32(byte const * data, size_t size, uint32 crc)
+{
+	CodeTables const & tables = GetTables();
+
+	crc = ~crc;
+
+	for (size_t i = 0u; i < size; ++i)
+		crc = tables.crc[(crc ^ data[i]) & 0xFFu] ^ (crc >> 8u);
+
+	return ~crc;
+}
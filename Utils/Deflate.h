@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Util.h"
+
+namespace Misc
+{
+	// Raw deflate (RFC 1951) and the checksums zlib and PNG wrap it in.
+	// Every Compress call makes one independent piece of a larger stream, pigz style:
+	// matches may reach back into a dictionary, the data just before the piece, and
+	// a piece that is not the last ends byte aligned with an empty stored block (a sync
+	// flush), so pieces compressed on any thread concatenate into one valid stream.
+	namespace Deflate
+	{
+		constexpr size_t WINDOW_SIZE = 32768u;
+
+		// Appends data[dictionary, size) to out, data[0, dictionary) having been
+		// compressed before it in the same stream. Only its last WINDOW_SIZE bytes are used.
+		void Compress(byte const * data, size_t dictionary, size_t size, bool last, std::vector<byte> & out);
+
+		// Inflates a whole stream, false unless it is valid and comes out at exactly outSize bytes
+		bool Decompress(byte const * data, size_t size, byte * out, size_t outSize);
+
+		uint32 Adler32(byte const * data, size_t size, uint32 adler = 1u);
+
+		// Adler-32 of two pieces one after the other, from their own checksums
+		uint32 CombineAdler32(uint32 first, uint32 second, uint64 secondSize);
+
+		uint32 Crc32(byte const * data, size_t size, uint32 crc = 0u);
+	}
+}
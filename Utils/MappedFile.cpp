@@ -0,0 +1,248 @@
+#include "MappedFile.h"
+
+#ifndef _WIN32
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#endif
+
+Misc::MappedFile::~MappedFile()
+{
+	Close();
+}
+
+bool Misc::MappedFile::Open(std::string const & path)
+{
+	Close();
+
+#ifdef _WIN32
+	m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+						 OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (m_file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+
+	if (!GetFileSizeEx(m_file, &size) || !size.QuadPart)
+	{
+		Close();
+		return false;
+	}
+
+	m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+	if (m_mapping)
+		m_data = static_cast<byte const *>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+
+	if (!m_data)
+	{
+		Close();
+		return false;
+	}
+
+	m_size = size_t(size.QuadPart);
+#else
+	int const file = open(path.c_str(), O_RDONLY);
+
+	if (file < 0)
+		return false;
+
+	struct stat info;
+
+	if (fstat(file, &info) == 0 && info.st_size > 0)
+	{
+		void * data = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_SHARED, file, 0);
+
+		if (data != MAP_FAILED)
+		{
+			m_data = static_cast<byte const *>(data);
+			m_size = size_t(info.st_size);
+		}
+	}
+
+	// the mapping keeps its own reference to the file
+	close(file);
+#endif
+
+	return m_data != nullptr;
+}
+
+void Misc::MappedFile::Close()
+{
+#ifdef _WIN32
+	if (m_data)
+		UnmapViewOfFile(m_data);
+
+	if (m_mapping)
+		CloseHandle(m_mapping);
+
+	if (m_file != INVALID_HANDLE_VALUE)
+		CloseHandle(m_file);
+
+	m_mapping	= nullptr;
+	m_file		= INVALID_HANDLE_VALUE;
+#else
+	if (m_data)
+		munmap(const_cast<byte *>(m_data), m_size);
+#endif
+
+	m_data = nullptr;
+	m_size = 0u;
+}
+
+byte const * Misc::MappedFile::GetData() const
+{
+	return m_data;
+}
+
+size_t Misc::MappedFile::GetSize() const
+{
+	return m_size;
+}
+
+Misc::WritableMappedFile::~WritableMappedFile()
+{
+	Close();
+}
+
+bool Misc::WritableMappedFile::Create(std::string const & path, size_t capacity)
+{
+	Close();
+
+#ifdef _WIN32
+	m_file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+						 CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (m_file == INVALID_HANDLE_VALUE)
+		return false;
+#else
+	m_file = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+	if (m_file < 0)
+		return false;
+#endif
+
+	if (!Map(std::max(capacity, size_t(1u))))
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+bool Misc::WritableMappedFile::Map(size_t capacity)
+{
+#ifdef _WIN32
+	// a mapping larger than the file extends it with zeros
+	m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READWRITE,
+								   DWORD(uint64(capacity) >> 32u), DWORD(uint64(capacity) & 0xFFFFFFFFu), nullptr);
+
+	if (m_mapping)
+		m_data = static_cast<byte *>(MapViewOfFile(m_mapping, FILE_MAP_WRITE, 0, 0, capacity));
+
+	if (!m_data)
+	{
+		Unmap();
+		return false;
+	}
+#else
+	if (ftruncate(m_file, off_t(capacity)) != 0)
+		return false;
+
+	void * data = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, m_file, 0);
+
+	if (data == MAP_FAILED)
+		return false;
+
+	m_data = static_cast<byte *>(data);
+#endif
+
+	m_capacity = capacity;
+
+	return true;
+}
+
+void Misc::WritableMappedFile::Unmap()
+{
+#ifdef _WIN32
+	if (m_data)
+		UnmapViewOfFile(m_data);
+
+	if (m_mapping)
+		CloseHandle(m_mapping);
+
+	m_mapping = nullptr;
+#else
+	if (m_data)
+		munmap(m_data, m_capacity);
+#endif
+
+	m_data		= nullptr;
+	m_capacity	= 0u;
+}
+
+void Misc::WritableMappedFile::Close()
+{
+	Unmap();
+
+	// the file is cut back to what was appended
+#ifdef _WIN32
+	if (m_file != INVALID_HANDLE_VALUE)
+	{
+		LARGE_INTEGER size;
+		size.QuadPart = LONGLONG(m_size);
+
+		if (SetFilePointerEx(m_file, size, nullptr, FILE_BEGIN))
+			SetEndOfFile(m_file);
+
+		CloseHandle(m_file);
+	}
+
+	m_file = INVALID_HANDLE_VALUE;
+#else
+	if (m_file >= 0)
+	{
+		// failing leaves zeros after the end, which read as the end anyway
+		int const truncated = ftruncate(m_file, off_t(m_size));
+		(void)truncated;
+
+		close(m_file);
+	}
+
+	m_file = -1;
+#endif
+
+	m_size = 0u;
+}
+
+bool Misc::WritableMappedFile::Append(void const * data, size_t size)
+{
+	if (!m_data)
+		return false;
+
+	if (m_size + size > m_capacity)
+	{
+		size_t const capacity = m_capacity;
+
+		Unmap();
+
+		if (!Map(std::max(capacity * 2u, m_size + size)) && !Map(capacity))
+			return false;
+
+		if (m_size + size > m_capacity)
+			return false;
+	}
+
+	std::memcpy(m_data + m_size, data, size);
+	m_size += size;
+
+	return true;
+}
+
+size_t Misc::WritableMappedFile::GetSize() const
+{
+	return m_size;
+}
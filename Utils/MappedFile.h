@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Util.h"
+
+namespace Misc
+{
+	// Read-only view of a whole file, mapped into memory. On Windows the file is opened
+	// with FILE_SHARE_DELETE so it can still be removed while mapped, like on POSIX.
+	class MappedFile:
+		public Noncopyable
+	{
+		byte const *	m_data	{nullptr};
+		size_t			m_size	{0u};
+
+	#ifdef _WIN32
+		HANDLE			m_file		{INVALID_HANDLE_VALUE};
+		HANDLE			m_mapping	{nullptr};
+	#endif
+
+		public:
+
+			MappedFile() = default;
+			~MappedFile();
+
+			// false when the file does not exist, is empty or can not be mapped
+			bool Open(std::string const & path);
+			void Close();
+
+			bool IsOpen() const {
+				return m_data != nullptr;
+			}
+
+			byte const *	GetData() const;
+			size_t			GetSize() const;
+	};
+
+	// A file written through a shared read-write mapping, grown by remapping when an
+	// append does not fit. What is appended is in the file even if the process dies
+	// without closing it; the unwritten tail reads as zeros until Close trims it.
+	class WritableMappedFile:
+		public Noncopyable
+	{
+		byte *			m_data		{nullptr};
+		size_t			m_capacity	{0u};	// mapped, the file is this long while open
+		size_t			m_size		{0u};	// appended
+
+	#ifdef _WIN32
+		HANDLE			m_file		{INVALID_HANDLE_VALUE};
+		HANDLE			m_mapping	{nullptr};
+	#else
+		int				m_file		{-1};
+	#endif
+
+		bool Map(size_t capacity);
+		void Unmap();
+
+		public:
+
+			WritableMappedFile() = default;
+			~WritableMappedFile();
+
+			// replaces whatever is at path with capacity zeroed bytes
+			bool Create(std::string const & path, size_t capacity);
+			void Close();
+
+			// false when the file can not grow to take it
+			bool Append(void const * data, size_t size);
+
+			bool IsOpen() const {
+				return m_data != nullptr;
+			}
+
+			size_t			GetSize() const;
+	};
+}
\ No newline at end of file
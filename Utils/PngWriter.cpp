@@ -0,0 +1,513 @@
+#include "PngWriter.h"
+#include "Deflate.h"
+
+#ifndef _WIN32
+	#include <unistd.h>
+#endif
+
+namespace
+{
+	constexpr size_t CHANNELS = 3u;
+
+	byte const SIGNATURE[8]		= { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	byte const ZLIB_HEADER[2]	= { 0x78, 0x9C };	// deflate, 32 KB window, default level
+
+	void inline StoreBigEndian(byte * out, uint32 value)
+	{
+		out[0] = byte(value >> 24u);
+		out[1] = byte(value >> 16u);
+		out[2] = byte(value >> 8u);
+		out[3] = byte(value);
+	}
+
+	byte inline Paeth(byte left, byte above, byte aboveLeft)
+	{
+		int32 const estimate	= int32(left) + above - aboveLeft;
+		int32 const toLeft		= std::abs(estimate - left);
+		int32 const toAbove		= std::abs(estimate - above);
+		int32 const toCorner	= std::abs(estimate - aboveLeft);
+
+		if (toLeft <= toAbove && toLeft <= toCorner)
+			return left;
+
+		return toAbove <= toCorner ? above : aboveLeft;
+	}
+
+	// The usual heuristic, the filter whose output has the smallest sum as signed bytes.
+	// Without a row above, the first of a segment, only None and Sub are possible.
+	void FilterRow(byte const * row, byte const * above, size_t size, byte * out, std::vector<byte> & scratch)
+	{
+		uint32 const filters = above ? 5u : 2u;
+
+		scratch.resize(filters * size);
+
+		byte * const sub		= scratch.data() + size;
+		byte * const up			= sub + size;
+		byte * const average	= up + size;
+		byte * const paeth		= average + size;
+
+		std::copy(row, row + size, scratch.data());
+
+		for (size_t i = 0u; i < std::min(CHANNELS, size); ++i)
+			sub[i] = row[i];
+
+		for (size_t i = CHANNELS; i < size; ++i)
+			sub[i] = byte(row[i] - row[i - CHANNELS]);
+
+		if (above)
+		{
+			for (size_t i = 0u; i < size; ++i)
+				up[i] = byte(row[i] - above[i]);
+
+			for (size_t i = 0u; i < std::min(CHANNELS, size); ++i)
+			{
+				average[i]	= byte(row[i] - above[i] / 2u);
+				paeth[i]	= byte(row[i] - above[i]);
+			}
+
+			for (size_t i = CHANNELS; i < size; ++i)
+			{
+				average[i]	= byte(row[i] - (row[i - CHANNELS] + above[i]) / 2u);
+				paeth[i]	= byte(row[i] - Paeth(row[i - CHANNELS], above[i], above[i - CHANNELS]));
+			}
+		}
+
+		uint32 best		= 0u;
+		uint64 bestSum	= ~0ull;
+
+		for (uint32 filter = 0u; filter < filters; ++filter)
+		{
+			byte const * const candidate = scratch.data() + filter * size;
+
+			uint64 sum = 0u;
+
+			for (size_t i = 0u; i < size; ++i)
+				sum += uint32(std::abs(int32(int8(candidate[i]))));
+
+			if (sum < bestSum)
+			{
+				best	= filter;
+				bestSum	= sum;
+			}
+		}
+
+		out[0] = byte(best);
+		std::copy(scratch.data() + best * size, scratch.data() + (best + 1u) * size, out + 1);
+	}
+
+	bool TruncateFile(std::string const & path, uint64 size)
+	{
+	#ifdef _WIN32
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER position;
+		position.QuadPart = LONGLONG(size);
+
+		bool const truncated = SetFilePointerEx(file, position, nullptr, FILE_BEGIN) && SetEndOfFile(file);
+
+		CloseHandle(file);
+
+		return truncated;
+	#else
+		return truncate(path.c_str(), off_t(size)) == 0;
+	#endif
+	}
+}
+
+Misc::PngWriter::PngWriter(uint32 threadCount)
+{
+	if (!threadCount)
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+	m_stats.threads = threadCount;
+
+	for (uint32 i = 0u; i < threadCount; ++i)
+		m_threads.emplace_back(&PngWriter::WorkerLoop, this);
+}
+
+Misc::PngWriter::~PngWriter()
+{
+	Abandon();
+
+	{
+		std::lock_guard<std::mutex> guard(m_lock);
+		m_stop = true;
+	}
+
+	m_wakeWorkers.notify_all();
+
+	for (auto & thread : m_threads)
+		thread.join();
+}
+
+void Misc::PngWriter::WorkerLoop()
+{
+	for (;;)
+	{
+		Piece * piece;
+
+		{
+			std::unique_lock<std::mutex> guard(m_lock);
+			m_wakeWorkers.wait(guard, [this]() { return m_stop || !m_waiting.empty(); });
+
+			if (m_waiting.empty())
+				return;
+
+			piece = m_waiting.front();
+			m_waiting.pop_front();
+		}
+
+		Encode(*piece);
+
+		{
+			std::lock_guard<std::mutex> guard(m_lock);
+			piece->done = true;
+		}
+
+		m_pieceDone.notify_all();
+	}
+}
+
+void Misc::PngWriter::Encode(Piece & piece)
+{
+	Stopwatch stopwatch;
+	stopwatch.Start();
+
+	// the first context row only serves as the row above the second one
+	size_t const stride		= m_rowBytes + 1u;
+	uint32 const first		= piece.context ? 1u : 0u;
+	uint32 const total		= piece.context + piece.count;
+	size_t const dictionary	= size_t(piece.context - first) * stride;
+
+	std::vector<byte> filtered(size_t(total - first) * stride);
+	std::vector<byte> scratch;
+
+	for (uint32 row = first; row < total; ++row)
+	{
+		byte const * const current	= piece.rows.data() + size_t(row) * m_rowBytes;
+		byte const * const above	= row ? current - m_rowBytes : nullptr;
+
+		FilterRow(current, above, m_rowBytes, filtered.data() + size_t(row - first) * stride, scratch);
+	}
+
+	Deflate::Compress(filtered.data(), dictionary, filtered.size(), piece.last, piece.compressed);
+
+	piece.adler = Deflate::Adler32(filtered.data() + dictionary, filtered.size() - dictionary);
+
+	stopwatch.Stop();
+	m_busy += stopwatch.GetTime().count();
+}
+
+void Misc::PngWriter::Submit(bool last, bool checkpoint)
+{
+	std::unique_ptr<Piece> piece(new Piece());
+
+	piece->context		= uint32(m_context.size() / m_rowBytes);
+	piece->count		= uint32(m_rows.size() / m_rowBytes);
+	piece->last			= last;
+	piece->checkpoint	= checkpoint;
+
+	piece->rows.reserve(m_context.size() + m_rows.size());
+	piece->rows.insert(piece->rows.end(), m_context.begin(), m_context.end());
+	piece->rows.insert(piece->rows.end(), m_rows.begin(), m_rows.end());
+
+	// the next piece needs the row above it and the rows making up its dictionary
+	size_t const contextRows	= 2u + Deflate::WINDOW_SIZE / (m_rowBytes + 1u);
+	size_t const kept			= checkpoint || last ? 0u : std::min(piece->rows.size(), contextRows * m_rowBytes);
+
+	m_context.assign(piece->rows.end() - kept, piece->rows.end());
+	m_rows.clear();
+
+	m_rowsQueued += piece->count;
+
+	{
+		std::lock_guard<std::mutex> guard(m_lock);
+
+		m_waiting.push_back(piece.get());
+		m_inFlight.push_back(std::move(piece));
+	}
+
+	m_wakeWorkers.notify_one();
+}
+
+void Misc::PngWriter::Retire(size_t keep)
+{
+	for (;;)
+	{
+		std::unique_ptr<Piece> piece;
+
+		{
+			std::unique_lock<std::mutex> guard(m_lock);
+
+			if (m_inFlight.empty())
+				return;
+
+			if (!m_inFlight.front()->done)
+			{
+				if (m_inFlight.size() <= keep)
+					return;
+
+				Stopwatch stopwatch;
+				stopwatch.Start();
+
+				m_pieceDone.wait(guard, [this]() { return m_inFlight.front()->done; });
+
+				stopwatch.Stop();
+				m_stats.stalled += stopwatch.GetTime();
+			}
+
+			piece = std::move(m_inFlight.front());
+			m_inFlight.pop_front();
+		}
+
+		uint64 const rawBytes = uint64(piece->count) * (m_rowBytes + 1u);
+
+		m_adler				 = Deflate::CombineAdler32(m_adler, piece->adler, rawBytes);
+		m_rowsWritten		+= piece->count;
+		m_stats.rawBytes	+= rawBytes;
+
+		std::vector<byte> & data = piece->compressed;
+
+		if (m_zlibHeader)
+		{
+			data.insert(data.begin(), ZLIB_HEADER, ZLIB_HEADER + 2u);
+			m_zlibHeader = false;
+		}
+
+		if (piece->last)
+		{
+			byte trailer[4];
+			StoreBigEndian(trailer, m_adler);
+
+			data.insert(data.end(), trailer, trailer + 4u);
+		}
+
+		WriteChunk("IDAT", data.data(), data.size());
+
+		if (piece->last)
+			WriteChunk("IEND", nullptr, 0u);
+
+		if (piece->checkpoint && m_onCheckpoint && !m_failed)
+		{
+			m_file.flush();
+
+			Checkpoint checkpoint;
+			checkpoint.bytes	= m_fileBytes;
+			checkpoint.rows		= m_rowsWritten;
+			checkpoint.adler	= m_adler;
+
+			if (m_file)
+				m_onCheckpoint(checkpoint);
+		}
+	}
+}
+
+void Misc::PngWriter::WriteChunk(cstring type, byte const * data, size_t size)
+{
+	byte header[8];
+	StoreBigEndian(header, uint32(size));
+	std::memcpy(header + 4, type, 4u);
+
+	byte trailer[4];
+	StoreBigEndian(trailer, Deflate::Crc32(data, size, Deflate::Crc32(header + 4, 4u)));
+
+	m_file.write(reinterpret_cast<char const *>(header), 8);
+	m_file.write(reinterpret_cast<char const *>(data), std::streamsize(size));
+	m_file.write(reinterpret_cast<char const *>(trailer), 4);
+
+	m_fileBytes			+= 12u + size;
+	m_stats.fileBytes	+= 12u + size;
+
+	if (!m_file)
+		m_failed = true;
+}
+
+void Misc::PngWriter::StartFile()
+{
+	m_rowBytes		= CHANNELS * m_width;
+	m_failed		= false;
+	m_stats.busy	= clock::duration(0);
+	m_busy			= 0;
+
+	m_rows.clear();
+	m_context.clear();
+
+	m_rows.reserve(std::max(PIECE_BYTES, m_rowBytes));
+}
+
+bool Misc::PngWriter::Open(std::string const & path, uint32 width, uint32 height)
+{
+	Abandon();
+
+	m_width			= width;
+	m_height		= height;
+	m_rowsQueued	= 0u;
+	m_rowsWritten	= 0u;
+	m_fileBytes		= 0u;
+	m_adler			= 1u;
+	m_zlibHeader	= true;
+
+	StartFile();
+
+	m_file.open(path, std::ios::binary | std::ios::trunc);
+	m_file.write(reinterpret_cast<char const *>(SIGNATURE), sizeof(SIGNATURE));
+
+	m_fileBytes = sizeof(SIGNATURE);
+
+	// 8 bits per channel, RGB, deflate, adaptive filtering, not interlaced
+	byte header[13] = {};
+	StoreBigEndian(header, width);
+	StoreBigEndian(header + 4, height);
+
+	header[8] = 8u;
+	header[9] = 2u;
+
+	WriteChunk("IHDR", header, sizeof(header));
+
+	return !m_failed;
+}
+
+bool Misc::PngWriter::Resume(std::string const & path, uint32 width, uint32 height, Checkpoint const & checkpoint)
+{
+	if (!checkpoint.rows)
+		return Open(path, width, height);
+
+	Abandon();
+
+	m_width			= width;
+	m_height		= height;
+	m_rowsQueued	= checkpoint.rows;
+	m_rowsWritten	= checkpoint.rows;
+	m_fileBytes		= checkpoint.bytes;
+	m_adler			= checkpoint.adler;
+	m_zlibHeader	= false;
+
+	StartFile();
+
+	// the file has to hold the whole checkpoint, a shorter one is not the file it was taken of
+	std::ifstream existing(path, std::ios::binary | std::ios::ate);
+
+	if (!existing || uint64(existing.tellg()) < checkpoint.bytes)
+		return false;
+
+	existing.close();
+
+	if (!TruncateFile(path, checkpoint.bytes))
+		return false;
+
+	m_file.open(path, std::ios::binary | std::ios::app);
+
+	return bool(m_file);
+}
+
+bool Misc::PngWriter::WriteRows(uint32 const * pixels, uint32 rows)
+{
+	if (!m_file.is_open() || m_rowsQueued + m_rows.size() / m_rowBytes + rows > m_height)
+		return false;
+
+	size_t const pieceRows = std::max<size_t>(1u, PIECE_BYTES / m_rowBytes);
+
+	for (uint32 row = 0u; row < rows; ++row)
+	{
+		uint32 const * const source = pixels + size_t(row) * m_width;
+
+		for (uint32 x = 0u; x < m_width; ++x)
+		{
+			m_rows.push_back(byte(source[x]));
+			m_rows.push_back(byte(source[x] >> 8u));
+			m_rows.push_back(byte(source[x] >> 16u));
+		}
+
+		if (m_rows.size() / m_rowBytes >= pieceRows)
+		{
+			Submit(false, false);
+			Retire(2u * m_threads.size());
+		}
+	}
+
+	return !m_failed;
+}
+
+void Misc::PngWriter::MarkCheckpoint()
+{
+	if (!m_file.is_open())
+		return;
+
+	if (!m_rows.empty())
+	{
+		Submit(false, true);
+		Retire(2u * m_threads.size());
+
+		return;
+	}
+
+	m_context.clear();
+
+	// the rows so far are in pieces already, the last of them ends the segment
+	{
+		std::lock_guard<std::mutex> guard(m_lock);
+
+		if (!m_inFlight.empty())
+		{
+			m_inFlight.back()->checkpoint = true;
+			return;
+		}
+	}
+
+	if (m_rowsWritten && m_onCheckpoint && !m_failed)
+	{
+		m_file.flush();
+
+		Checkpoint checkpoint;
+		checkpoint.bytes	= m_fileBytes;
+		checkpoint.rows		= m_rowsWritten;
+		checkpoint.adler	= m_adler;
+
+		m_onCheckpoint(checkpoint);
+	}
+}
+
+void Misc::PngWriter::SetCheckpointCallback(CheckpointCallback callback)
+{
+	m_onCheckpoint = std::move(callback);
+}
+
+bool Misc::PngWriter::Close()
+{
+	if (!m_file.is_open())
+		return false;
+
+	bool const complete = m_rowsQueued + m_rows.size() / m_rowBytes == m_height;
+
+	if (complete)
+		Submit(true, false);
+
+	Retire(0u);
+
+	m_file.close();
+
+	return complete && !m_failed;
+}
+
+void Misc::PngWriter::Abandon()
+{
+	if (!m_file.is_open())
+		return;
+
+	m_rows.clear();
+
+	Retire(0u);
+
+	m_file.close();
+}
+
+Misc::PngWriter::Stats Misc::PngWriter::GetStats() const
+{
+	Stats stats = m_stats;
+	stats.busy	= clock::duration(m_busy.load());
+
+	return stats;
+}
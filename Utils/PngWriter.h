@@ -0,0 +1,130 @@
+#pragma once
+
+#include "Util.h"
+#include "Stopwatch.h"
+
+#include <deque>
+#include <functional>
+#include <condition_variable>
+
+namespace Misc
+{
+	// Streams an 8 bit RGB PNG to disk while the rows are still being produced. Rows are
+	// cut into pieces of about PIECE_BYTES, each filtered and deflated on a worker thread
+	// with the 32 KB before it as dictionary (pigz style) and written out as its own IDAT
+	// chunk in order as soon as it and the ones before it are done. The caller only blocks
+	// once too many pieces are in flight, so encoding overlaps whatever produces the rows.
+	//
+	// MarkCheckpoint ends a segment: the rows after it are compressed without looking
+	// back, so the file cut right after it is a prefix a later Resume can continue.
+	class PngWriter:
+		public Noncopyable
+	{
+		public:
+
+			static constexpr size_t PIECE_BYTES = 256u << 10u;
+
+			struct Checkpoint
+			{
+				uint64 bytes	{0u};	// file size up to the end of the segment
+				uint32 rows		{0u};
+				uint32 adler	{1u};	// of the image data so far
+			};
+
+			struct Stats
+			{
+				uint64			rawBytes		{0u};	// filtered image data, what deflate saw
+				uint64			fileBytes		{0u};
+				clock::duration	busy			{0};	// filtering and deflating, summed over the workers
+				clock::duration	stalled			{0};	// the caller waiting on full queues
+				uint32			threads			{0u};
+
+				// throughput of one worker
+				double inline MegabytesPerSecond() const
+				{
+					double const seconds = std::chrono::duration<double>(busy).count();
+					return seconds > 0. ? double(rawBytes) / seconds / 1e6 : 0.;
+				}
+			};
+
+			typedef std::function<void(Checkpoint const & checkpoint)> CheckpointCallback;
+
+		private:
+
+			struct Piece
+			{
+				std::vector<byte>	rows;		// RGB, the first `context` rows come before the piece
+				uint32				context		{0u};
+				uint32				count		{0u};	// rows of the piece itself
+				bool				last		{false};
+				bool				checkpoint	{false};
+
+				std::vector<byte>	compressed;
+				uint32				adler		{1u};
+				bool				done		{false};
+			};
+
+			std::ofstream						m_file;
+			uint32								m_width		{0u};
+			uint32								m_height	{0u};
+			size_t								m_rowBytes	{0u};	// RGB, without the filter byte
+
+			std::vector<byte>					m_rows;				// RGB rows not handed out yet
+			std::vector<byte>					m_context;			// rows of the segment right before them
+			uint32								m_rowsQueued	{0u};
+			uint32								m_rowsWritten	{0u};
+			uint64								m_fileBytes		{0u};
+			uint32								m_adler			{1u};
+			bool								m_zlibHeader	{false};	// still to be written
+			bool								m_failed		{false};
+
+			CheckpointCallback					m_onCheckpoint;
+			Stats								m_stats;
+
+			std::vector<std::thread>			m_threads;
+			std::deque<std::unique_ptr<Piece>>	m_inFlight;		// in file order
+			std::deque<Piece *>					m_waiting;		// not picked up by a worker yet
+			std::mutex							m_lock;
+			std::condition_variable				m_wakeWorkers;
+			std::condition_variable				m_pieceDone;
+			std::atomic<clock::rep>				m_busy			{0};
+			bool								m_stop			{false};
+
+			void WorkerLoop();
+			void Encode(Piece & piece);
+
+			// hands the buffered rows to the workers as one piece
+			void Submit(bool last, bool checkpoint);
+
+			// writes the finished pieces at the front, waiting for them while more than `keep` are in flight
+			void Retire(size_t keep);
+
+			void WriteChunk(cstring type, byte const * data, size_t size);
+			void StartFile();
+
+		public:
+
+			explicit PngWriter(uint32 threadCount = 0u);
+			~PngWriter();
+
+			bool Open(std::string const & path, uint32 width, uint32 height);
+
+			// continues a file cut at a checkpoint, whatever follows it in the file is dropped
+			bool Resume(std::string const & path, uint32 width, uint32 height, Checkpoint const & checkpoint);
+
+			// packed RGBA8 rows, R in the lowest byte, alpha is dropped
+			bool WriteRows(uint32 const * pixels, uint32 rows);
+
+			// onCheckpoint runs on the calling thread once everything before it is in the file
+			void MarkCheckpoint();
+			void SetCheckpointCallback(CheckpointCallback callback);
+
+			// writes the remaining rows and completes the file, every row has to be there
+			bool Close();
+
+			// writes what is queued without completing the file, it can be resumed from the last checkpoint
+			void Abandon();
+
+			Stats GetStats() const;
+	};
+}
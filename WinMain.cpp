@@ -33,16 +33,16 @@ LRESULT _stdcall MainWindowProc(HWND winHandle, UINT msg, WPARAM wParam, LPARAM
 						std::exit(EXIT_SUCCESS);
 
 					case VK_LEFT:
-						FractalGenerator::GetInstance()->SetOffsetX(-offsetUnit.x * std::abs(zoomUnit), true);
+						FractalGenerator::GetInstance()->Pan({ -offsetUnit.x * std::abs(zoomUnit), 0.f });
 						break;
 					case VK_RIGHT:
-						FractalGenerator::GetInstance()->SetOffsetX(offsetUnit.x * std::abs(zoomUnit), true);
+						FractalGenerator::GetInstance()->Pan({ offsetUnit.x * std::abs(zoomUnit), 0.f });
 						break;
 					case VK_DOWN:
-						FractalGenerator::GetInstance()->SetOffsetY(-offsetUnit.y * std::abs(zoomUnit), true);
+						FractalGenerator::GetInstance()->Pan({ 0.f, -offsetUnit.y * std::abs(zoomUnit) });
 						break;
 					case VK_UP:
-						FractalGenerator::GetInstance()->SetOffsetY(offsetUnit.y * std::abs(zoomUnit), true);
+						FractalGenerator::GetInstance()->Pan({ 0.f, offsetUnit.y * std::abs(zoomUnit) });
 						break;
 
 					case VK_SHIFT:
@@ -70,6 +70,14 @@ LRESULT _stdcall MainWindowProc(HWND winHandle, UINT msg, WPARAM wParam, LPARAM
 					case VK_F1:
 						Misc::ToggleConsole();
 						break;
+
+					case VK_F2:
+						FractalGenerator::GetInstance()->RenderCpuFrame();
+						break;
+
+					case VK_F3:
+						FractalGenerator::GetInstance()->LogFrameCounters();
+						break;
 				}
 			}
 		}
@@ -103,6 +111,13 @@ LRESULT _stdcall MainWindowProc(HWND winHandle, UINT msg, WPARAM wParam, LPARAM
 		}
 		break;
 
+		case WM_PAINT:
+		{
+			if (FractalGenerator::IsInitialized())
+				FractalGenerator::GetInstance()->MarkDirty();
+		}
+		return DefWindowProc(winHandle, msg, wParam, lParam);
+
 		case WM_CLOSE:
 			DestroyWindow(winHandle);
 			break;
@@ -125,6 +140,90 @@ int WINAPI WinMain(HINSTANCE instance, HINSTANCE not_used,
 
 	FractalGenerator::GetInstance()->SetMaxIterations(300u);
 	FractalGenerator::GetInstance()->SetZoom(0.01f, true);
+
+	if (cmdLine)
+	{
+		Render::RenderOptions options;
+
+		if (std::strstr(cmdLine, "-static-rows"))
+			options.scheduling = Render::Scheduling::STATIC_ROWS;
+
+		if (std::strstr(cmdLine, "-subdivide"))
+			options.subdivision = Render::Subdivision::MARIANI_SILVER;
+
+		FractalGenerator::GetInstance()->SetRenderOptions(options);
+	}
+
+	if (cstring deep = cmdLine ? std::strstr(cmdLine, "-deep ") : nullptr)
+	{
+		char re[1024], im[1024], zoom[64];
+
+		if (std::sscanf(deep, "-deep %1023s %1023s %63s", re, im, zoom) == 3)
+		{
+			FractalGenerator::GetInstance()->RenderDeepFrame({ Render::DeepReal::FromString(re), Render::DeepReal::FromString(im) },
+				Render::DeepZoom::FromString(zoom));
+		}
+	}
+
+	if (cstring cache = cmdLine ? std::strstr(cmdLine, "-tile-cache ") : nullptr)
+	{
+		char directory[MAX_PATH];
+
+		if (std::sscanf(cache, "-tile-cache %259s", directory) == 1)
+			FractalGenerator::GetInstance()->SetTileCache(directory);
+	}
+
+	if (cstring output = cmdLine ? std::strstr(cmdLine, "-export ") : nullptr)
+	{
+		uint32	width, height;
+		char	path[MAX_PATH];
+
+		if (std::sscanf(output, "-export %u %u %259s", &width, &height, path) == 3)
+			FractalGenerator::GetInstance()->ExportImage({ width, height }, path);
+	}
+
+	if (cstring output = cmdLine ? std::strstr(cmdLine, "-export-iterations ") : nullptr)
+	{
+		uint32	width, height;
+		char	path[MAX_PATH];
+
+		if (std::sscanf(output, "-export-iterations %u %u %259s", &width, &height, path) == 3)
+			FractalGenerator::GetInstance()->ExportIterations({ width, height }, path);
+	}
+
+	if (cstring animate = cmdLine ? std::strstr(cmdLine, "-animate ") : nullptr)
+	{
+		uint32	frames, width, height;
+		char	re[1024], im[1024], zoom[64], output[MAX_PATH];
+
+		if (std::sscanf(animate, "-animate %u %u %u %1023s %1023s %63s %259s", &frames, &width, &height, re, im, zoom, output) == 7)
+		{
+			FractalGenerator::GetInstance()->RenderAnimation({ Render::DeepReal::FromString(re), Render::DeepReal::FromString(im) },
+				Render::DeepZoom::FromString(zoom), { width, height }, frames, output);
+		}
+	}
+
+	if (cstring atlas = cmdLine ? std::strstr(cmdLine, "-julia-atlas ") : nullptr)
+	{
+		uint32	columns, rows, size;
+		char	path[MAX_PATH];
+
+		if (std::sscanf(atlas, "-julia-atlas %u %u %u %259s", &columns, &rows, &size, path) == 4)
+			FractalGenerator::GetInstance()->RenderJuliaAtlas({ columns, rows }, size, path);
+	}
+
+	if (cmdLine && std::strstr(cmdLine, "-benchmark"))
+		FractalGenerator::GetInstance()->RunBenchmark();
+
+	if (cmdLine && std::strstr(cmdLine, "-check-subdivision"))
+		FractalGenerator::GetInstance()->RunSubdivisionCheck();
+
+	if (cmdLine && std::strstr(cmdLine, "-check-pan"))
+		FractalGenerator::GetInstance()->RunPanCheck();
+
+	if (cmdLine && std::strstr(cmdLine, "-check-perturbation"))
+		FractalGenerator::GetInstance()->RunDeepCheck();
+
 	FractalGenerator::GetInstance()->Run();
 
 	return 0;